@@ -39,10 +39,9 @@ interface RobotReply {
 }
 
 interface DiagnosticsState {
-  owner: string;   // I=Idle, D=Direct, X=Stopped
+  owner: string;   // I=Idle, D=Direct, M=Motion, X=Stopped
   leftPWM: number;
   rightPWM: number;
-  stby: number;
   motionState: number;
   resets: number;
 }
@@ -155,18 +154,17 @@ async function sendCommand(
   });
 }
 
-// Parse diagnostics response like {X0,0,0,0,1}
+// Parse the first diagnostics line, like {X0,0,0,1,hw:ELGV11TB,imu:1,ram:812,min:790}
 function parseDiagnostics(lines: string[]): DiagnosticsState | null {
   for (const line of lines) {
-    const match = line.match(/^\{([IDX])(-?\d+),(-?\d+),(\d+),(\d+),(\d+)\}$/);
+    const match = line.match(/^\{([IDMX])(-?\d+),(-?\d+),(\d+),(\d+),hw:/);
     if (match) {
       return {
         owner: match[1],
         leftPWM: parseInt(match[2]),
         rightPWM: parseInt(match[3]),
-        stby: parseInt(match[4]),
-        motionState: parseInt(match[5]),
-        resets: parseInt(match[6]),
+        motionState: parseInt(match[4]),
+        resets: parseInt(match[5]),
       };
     }
   }
@@ -281,9 +279,9 @@ async function phase1_checkDiagnostics(): Promise<boolean> {
     return false;
   }
   
-  log(`  Owner: ${diag.owner} (I=Idle, D=Direct, X=Stopped)`);
+  log(`  Owner: ${diag.owner} (I=Idle, D=Direct, M=Motion, X=Stopped)`);
   log(`  PWM: L=${diag.leftPWM}, R=${diag.rightPWM}`);
-  log(`  STBY: ${diag.stby}, State: ${diag.motionState}, Resets: ${diag.resets}`);
+  log(`  State: ${diag.motionState}, Resets: ${diag.resets}`);
   log('✓ Diagnostics OK');
   return true;
 }
@@ -551,7 +549,7 @@ async function phase9_finalDiagnostics(): Promise<boolean> {
   
   log(`  Final Owner: ${diag.owner}`);
   log(`  Final PWM: L=${diag.leftPWM}, R=${diag.rightPWM}`);
-  log(`  STBY: ${diag.stby}, State: ${diag.motionState}`);
+  log(`  State: ${diag.motionState}`);
   log(`  Total Resets: ${diag.resets}`);
   
   // Verify robot is stopped
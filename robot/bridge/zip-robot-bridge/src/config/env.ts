@@ -27,6 +27,9 @@ const envSchema = z.object({
   STREAM_MIN_TTL_MS: z.coerce.number().int().min(100).max(300).default(150),
   STREAM_MAX_TTL_MS: z.coerce.number().int().min(200).max(500).default(300),
   
+  // Clock sync (N=123 probes, 0 = off)
+  CLOCK_SYNC_INTERVAL_MS: z.coerce.number().int().min(0).max(60000).default(1000),
+  
   // Rate limiting
   MAX_COMMANDS_PER_SEC: z.coerce.number().int().min(1).max(100).default(50),
   
@@ -72,6 +75,7 @@ export const {
   STREAM_DEFAULT_TTL_MS,
   STREAM_MIN_TTL_MS,
   STREAM_MAX_TTL_MS,
+  CLOCK_SYNC_INTERVAL_MS,
   MAX_COMMANDS_PER_SEC,
   HANDSHAKE_TIMEOUT_MS,
   COMMAND_TIMEOUT_MS,
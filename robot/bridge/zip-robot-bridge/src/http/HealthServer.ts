@@ -9,6 +9,7 @@ import { HTTP_PORT } from '../config/env.js';
 import type { SerialTransport } from '../serial/SerialTransport.js';
 import type { ReplyMatcher } from '../protocol/ReplyMatcher.js';
 import type { SetpointStreamer } from '../streaming/SetpointStreamer.js';
+import type { ClockSync, ClockSyncStats } from '../protocol/ClockSync.js';
 import { buildStopCommand, PRIORITY } from '../protocol/FirmwareJson.js';
 
 export interface HealthStatus {
@@ -25,6 +26,8 @@ export interface HealthStatus {
   resetsSeen: number;
   rxBytes: number;
   txBytes: number;
+  clockSync: ClockSyncStats | null;
+  stream: ReturnType<SetpointStreamer['getStats']> | null;
   uptime: number;
   timestamp: number;
 }
@@ -34,6 +37,7 @@ export class HealthServer {
   private transport: SerialTransport | null = null;
   private replyMatcher: ReplyMatcher | null = null;
   private streamer: SetpointStreamer | null = null;
+  private clockSync: ClockSync | null = null;
   private startTime: number = Date.now();
   
   constructor(port: number = HTTP_PORT) {
@@ -61,6 +65,10 @@ export class HealthServer {
     this.streamer = streamer;
   }
   
+  setClockSync(clockSync: ClockSync): void {
+    this.clockSync = clockSync;
+  }
+  
   /**
    * Handle an HTTP request
    */
@@ -161,6 +169,8 @@ export class HealthServer {
       resetsSeen: transportStats?.resetsSeen ?? 0,
       rxBytes: transportStats?.rxBytes ?? 0,
       txBytes: transportStats?.txBytes ?? 0,
+      clockSync: this.clockSync?.getStats() ?? null,
+      stream: this.streamer?.getStats() ?? null,
       uptime: Date.now() - this.startTime,
       timestamp: Date.now(),
     };
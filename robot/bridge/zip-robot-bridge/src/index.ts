@@ -15,11 +15,13 @@ import {
   WS_PORT, 
   HTTP_PORT, 
   LOOPBACK_MODE,
+  CLOCK_SYNC_INTERVAL_MS,
 } from './config/env.js';
 import { SerialTransport, type TransportState } from './serial/SerialTransport.js';
 import { LoopbackEmulator } from './serial/LoopbackEmulator.js';
 import { ReplyMatcher } from './protocol/ReplyMatcher.js';
 import { SetpointStreamer } from './streaming/SetpointStreamer.js';
+import { ClockSync } from './protocol/ClockSync.js';
 import { RobotWsServer } from './ws/RobotWsServer.js';
 import { HealthServer } from './http/HealthServer.js';
 import { isBootMarker } from './protocol/FirmwareJson.js';
@@ -80,6 +82,7 @@ async function main(): Promise<void> {
   // Create components
   const replyMatcher = new ReplyMatcher();
   const streamer = new SetpointStreamer();
+  const clockSync = new ClockSync(LOOPBACK_MODE ? 115200 : SERIAL_BAUD, CLOCK_SYNC_INTERVAL_MS);
   const wsServer = new RobotWsServer(WS_PORT);
   const healthServer = new HealthServer(HTTP_PORT);
   
@@ -88,6 +91,8 @@ async function main(): Promise<void> {
   wsServer.setStreamer(streamer);
   healthServer.setReplyMatcher(replyMatcher);
   healthServer.setStreamer(streamer);
+  healthServer.setClockSync(clockSync);
+  streamer.setClockSync(clockSync);
   
   // Transport event handlers
   const transportEvents = {
@@ -95,9 +100,17 @@ async function main(): Promise<void> {
       // Check for boot marker (indicates reset)
       if (isBootMarker(line)) {
         logger.info('Boot marker received (firmware reset)');
+        clockSync.reset();
+        streamer.resetAck();
         wsServer.broadcastStatus();
       }
       
+      // N=123 probe replies, {sq:...} setpoint acks and {sl:...} drive
+      // telemetry are bridge-internal
+      if (clockSync.handleLine(line) || streamer.handleAck(line)) {
+        return;
+      }
+      
       // Forward to reply matcher
       replyMatcher.processLine(line);
       
@@ -109,6 +122,9 @@ async function main(): Promise<void> {
       
       if (state === 'ready') {
         wsServer.markReady();
+        clockSync.start();
+      } else {
+        clockSync.stop();
       }
       
       wsServer.broadcastStatus();
@@ -116,6 +132,9 @@ async function main(): Promise<void> {
     onError: (error: Error) => {
       logger.error('Transport error', { error: error.message });
     },
+    onWrite: (line: string) => {
+      clockSync.handleWrite(line);
+    },
   };
   
   // Create transport (real or loopback)
@@ -138,6 +157,9 @@ async function main(): Promise<void> {
   streamer.setSendFunction((cmd) => {
     return transport.writeCommand(cmd);
   });
+  clockSync.setSendFunction((cmd) => {
+    return transport.writeCommand(cmd);
+  });
   
   // Open transport
   try {
@@ -164,6 +186,7 @@ async function main(): Promise<void> {
     // Cleanup
     replyMatcher.cleanup();
     streamer.cleanup();
+    clockSync.cleanup();
     wsServer.close();
     healthServer.close();
     await transport.close();
@@ -0,0 +1,323 @@
+/**
+ * Clock Sync
+ * Estimates the UNO micros() clock against the host clock with N=123 probes
+ *
+ * Each probe yields the four NTP timestamps:
+ *   t1  host: probe written to the port      (onWrite hook, after queueing)
+ *   t2  UNO:  probe frame complete           (micros() when '}' was parsed)
+ *   t3  UNO:  reply about to be printed
+ *   t4  host: reply line received
+ * The serial wire time is known from the baud rate, so it is removed before
+ * the NTP math: the probe's own bytes from t1, and the bytes already queued
+ * in the UNO TX ring plus the reply's bytes from t4. What is left in the
+ * round trip is USB/driver latency, which is the part that is assumed
+ * symmetric.
+ *
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2      (uno = host + offset)
+ *   delay  = (t4 - t1) - (t3 - t2)
+ *
+ * Probes with the lowest delay carry the least asymmetry, so only the
+ * faster half of a sliding window is used for a least-squares fit of
+ * offset and drift (crystal vs. host clock, typically tens of ppm).
+ */
+
+import { logger } from '../logging/logger.js';
+import { type FirmwareCommand, CMD } from './FirmwareJson.js';
+
+// Reply format: {ts_<T>,<rx_us>,<tx_us>,<txq>}
+const PROBE_REPLY_PATTERN = /^\{ts_(\d+),(\d+),(\d+),(\d+)\}$/;
+const PROBE_TAG = 'ts';
+const PROBE_T_MODULO = 1e9;     // Firmware echoes T as a 32-bit unsigned
+const WINDOW_SIZE = 64;
+const MAX_PENDING = 8;
+const UNO_WRAP_US = 4294967296; // micros() wraps every ~71.6 min
+
+interface ClockSample {
+  hostUs: number;    // Midpoint of t1'/t4' on the host clock
+  offsetUs: number;
+  delayUs: number;
+}
+
+interface PendingProbe {
+  enqueuedUs: number;
+  writtenUs: number | null;
+}
+
+export interface ClockSyncStats {
+  synced: boolean;
+  samples: number;
+  offsetUs: number | null;      // UNO micros() minus host time, now
+  driftPpm: number | null;
+  rttMinUs: number | null;      // Lowest residual delay in the window
+  rttLastUs: number | null;
+  uncertaintyUs: number | null; // rttMin / 2 (worst-case asymmetry)
+  fwHandlingUs: number | null;  // t3 - t2 of the last probe
+  uplinkUs: number | null;      // Last probe, host write -> UNO frame complete
+  downlinkUs: number | null;    // Last probe, UNO print -> host line
+  bridgeQueueUs: number | null; // Last probe, enqueue -> port write
+  lastSampleAt: number | null;
+}
+
+/**
+ * Host clock in microseconds (epoch based, monotonic within the process)
+ */
+export function hostNowUs(): number {
+  return (performance.timeOrigin + performance.now()) * 1000;
+}
+
+export class ClockSync {
+  private byteUs: number;
+  private intervalMs: number;
+  private timer: NodeJS.Timeout | null = null;
+  private sendFn: ((cmd: FirmwareCommand) => boolean) | null = null;
+
+  private pending = new Map<number, PendingProbe>();
+  private window: ClockSample[] = [];
+
+  // Fit: offset(hostUs) = fitOffset + fitSlope * (hostUs - fitRefUs)
+  private fitRefUs = 0;
+  private fitOffset = 0;
+  private fitSlope = 0;
+  private rttMinUs: number | null = null;
+
+  // UNO micros() unwrap
+  private lastUnoRaw: number | null = null;
+  private unoWraps = 0;
+
+  // Last probe breakdown
+  private last: {
+    delayUs: number;
+    fwHandlingUs: number;
+    uplinkUs: number;
+    downlinkUs: number;
+    bridgeQueueUs: number;
+    at: number;
+  } | null = null;
+
+  constructor(baudRate: number, intervalMs: number) {
+    this.byteUs = 10e6 / baudRate; // 8N1: 10 bits per byte
+    this.intervalMs = intervalMs;
+  }
+
+  /**
+   * Set the function used to send probes
+   */
+  setSendFunction(fn: (cmd: FirmwareCommand) => boolean): void {
+    this.sendFn = fn;
+  }
+
+  /**
+   * Start periodic probing (no-op when the interval is 0)
+   */
+  start(): void {
+    if (this.timer || this.intervalMs <= 0) {
+      return;
+    }
+    this.timer = setInterval(() => this.probe(), this.intervalMs);
+    this.probe();
+  }
+
+  stop(): void {
+    if (this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+  }
+
+  /**
+   * Drop all samples - the UNO clock restarts at 0 on reset
+   */
+  reset(): void {
+    this.pending.clear();
+    this.window = [];
+    this.fitOffset = 0;
+    this.fitSlope = 0;
+    this.rttMinUs = null;
+    this.lastUnoRaw = null;
+    this.unoWraps = 0;
+    this.last = null;
+  }
+
+  /**
+   * Send one probe
+   */
+  probe(): boolean {
+    if (!this.sendFn) {
+      return false;
+    }
+    const now = hostNowUs();
+    const t = Math.floor(now) % PROBE_T_MODULO;
+
+    // Unanswered probes (lost line, reset) must not pile up
+    if (this.pending.size >= MAX_PENDING) {
+      const oldest = this.pending.keys().next().value as number;
+      this.pending.delete(oldest);
+    }
+    this.pending.set(t, { enqueuedUs: now, writtenUs: null });
+
+    return this.sendFn({ N: CMD.TIME_PROBE, H: PROBE_TAG, T: t });
+  }
+
+  /**
+   * Transport write hook: stamps t1 when the probe actually hits the port
+   */
+  handleWrite(line: string): void {
+    if (!line.startsWith(`{"N":${CMD.TIME_PROBE},`)) {
+      return;
+    }
+    const now = hostNowUs();
+    try {
+      const parsed = JSON.parse(line);
+      const probe = this.pending.get(parsed.T);
+      if (probe) {
+        probe.writtenUs = now;
+      }
+    } catch {
+      // Not ours
+    }
+  }
+
+  /**
+   * Handle a line from the UNO. Returns true if it was a probe reply
+   * (consumed - not a reply any client is waiting for).
+   */
+  handleLine(line: string): boolean {
+    const t4 = hostNowUs();
+    const match = line.match(PROBE_REPLY_PATTERN);
+    if (!match) {
+      return false;
+    }
+
+    const probe = this.pending.get(Number(match[1]));
+    if (!probe || probe.writtenUs === null) {
+      return true;
+    }
+    this.pending.delete(Number(match[1]));
+
+    const t2 = this.unwrapUno(Number(match[2]));
+    const t3 = t2 + ((Number(match[3]) - Number(match[2]) + UNO_WRAP_US) % UNO_WRAP_US);
+    const txQueued = Number(match[4]);
+
+    // Probe line (with '\n') is on the wire from t1; '}' completes the frame
+    const probeBytes = `{"N":${CMD.TIME_PROBE},"H":"${PROBE_TAG}","T":${match[1]}}`.length;
+    const t1 = probe.writtenUs + probeBytes * this.byteUs;
+    // Queued bytes go first, then the reply and its '\n'
+    const t4c = t4 - (txQueued + line.length + 1) * this.byteUs;
+
+    const offsetUs = ((t2 - t1) + (t3 - t4c)) / 2;
+    const delayUs = (t4c - t1) - (t3 - t2);
+
+    this.window.push({ hostUs: (t1 + t4c) / 2, offsetUs, delayUs });
+    if (this.window.length > WINDOW_SIZE) {
+      this.window.shift();
+    }
+    this.fit();
+
+    const fitted = this.offsetAt(t4);
+    this.last = {
+      delayUs,
+      fwHandlingUs: t3 - t2,
+      uplinkUs: (t2 - fitted) - probe.writtenUs,
+      downlinkUs: t4 - (t3 - fitted),
+      bridgeQueueUs: probe.writtenUs - probe.enqueuedUs,
+      at: Date.now(),
+    };
+
+    logger.debug('clock_sync', { offsetUs: Math.round(offsetUs), delayUs: Math.round(delayUs) });
+    return true;
+  }
+
+  /**
+   * UNO micros() timestamp -> host epoch milliseconds. Raw 32-bit values
+   * are taken to be in the current wrap period.
+   */
+  toHostMs(unoUs: number): number | null {
+    if (this.window.length === 0) {
+      return null;
+    }
+    if (unoUs < UNO_WRAP_US) {
+      unoUs += this.unoWraps * UNO_WRAP_US;
+    }
+    // Offset changes by ppm - one fixed-point step is plenty
+    const approxHostUs = unoUs - this.offsetAt(unoUs - this.fitOffset);
+    return (unoUs - this.offsetAt(approxHostUs)) / 1000;
+  }
+
+  /**
+   * Host epoch milliseconds -> UNO micros() (unwrapped)
+   */
+  toUnoUs(hostMs: number): number | null {
+    if (this.window.length === 0) {
+      return null;
+    }
+    const hostUs = hostMs * 1000;
+    return hostUs + this.offsetAt(hostUs);
+  }
+
+  getStats(): ClockSyncStats {
+    const synced = this.window.length > 0;
+    return {
+      synced,
+      samples: this.window.length,
+      offsetUs: synced ? Math.round(this.offsetAt(hostNowUs())) : null,
+      driftPpm: this.window.length >= 2 ? Number((this.fitSlope * 1e6).toFixed(2)) : null,
+      rttMinUs: this.rttMinUs !== null ? Math.round(this.rttMinUs) : null,
+      rttLastUs: this.last ? Math.round(this.last.delayUs) : null,
+      uncertaintyUs: this.rttMinUs !== null ? Math.round(Math.max(0, this.rttMinUs) / 2) : null,
+      fwHandlingUs: this.last ? Math.round(this.last.fwHandlingUs) : null,
+      uplinkUs: this.last ? Math.round(this.last.uplinkUs) : null,
+      downlinkUs: this.last ? Math.round(this.last.downlinkUs) : null,
+      bridgeQueueUs: this.last ? Math.round(this.last.bridgeQueueUs) : null,
+      lastSampleAt: this.last?.at ?? null,
+    };
+  }
+
+  cleanup(): void {
+    this.stop();
+    this.reset();
+  }
+
+  private offsetAt(hostUs: number): number {
+    return this.fitOffset + this.fitSlope * (hostUs - this.fitRefUs);
+  }
+
+  private unwrapUno(raw: number): number {
+    if (this.lastUnoRaw !== null && raw < this.lastUnoRaw &&
+        this.lastUnoRaw - raw > UNO_WRAP_US / 2) {
+      this.unoWraps++;
+    }
+    this.lastUnoRaw = raw;
+    return raw + this.unoWraps * UNO_WRAP_US;
+  }
+
+  /**
+   * Least-squares offset/drift over the lower-delay half of the window
+   */
+  private fit(): void {
+    const delays = this.window.map(s => s.delayUs).sort((a, b) => a - b);
+    this.rttMinUs = delays[0];
+    const cutoff = delays[Math.floor((delays.length - 1) / 2)];
+    const used = this.window.filter(s => s.delayUs <= cutoff);
+
+    this.fitRefUs = used[used.length - 1].hostUs;
+    if (used.length < 2) {
+      this.fitOffset = used[0].offsetUs;
+      this.fitSlope = 0;
+      return;
+    }
+
+    let sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const s of used) {
+      const x = s.hostUs - this.fitRefUs;
+      sx += x;
+      sy += s.offsetUs;
+      sxx += x * x;
+      sxy += x * s.offsetUs;
+    }
+    const n = used.length;
+    const denom = n * sxx - sx * sx;
+    // Samples too close together in time give no usable slope
+    this.fitSlope = denom > 1e-6 ? (n * sxy - sx * sy) / denom : 0;
+    this.fitOffset = (sy - this.fitSlope * sx) / n;
+  }
+}
@@ -17,6 +17,7 @@ import { STREAM_MIN_TTL_MS, STREAM_MAX_TTL_MS } from '../config/env.js';
 export const CMD = {
   HELLO: 0,
   DIAGNOSTICS: 120,
+  TIME_PROBE: 123,
   SETPOINT: 200,
   STOP: 201,
   MACRO_START: 210,
@@ -61,6 +62,8 @@ export const FirmwareCommandSchema = z.object({
   H: z.string().optional(),
   D1: z.number().optional(),
   D2: z.number().optional(),
+  D3: z.number().int().optional(),
+  D4: z.number().int().optional(),
   T: z.number().int().optional(),
 });
 
@@ -77,7 +80,9 @@ const TOKEN_PATTERN = /^\{(\w+)_(\w+)\}$/;
 // Diagnostics response patterns
 // Format from firmware: {<owner><L>,<R>,<stby>,<state>,<resets>[,ram:<ram>,min:<min>]}
 // Note: ram and min are optional (newer firmware)
-const DIAG_OWNER_PATTERN = /^\{([IDX])(-?\d+),(-?\d+),(\d+),(\d+),(\d+)(?:,ram:\d+,min:\d+)?\}$/;
+// Current firmware: {<owner><L>,<R>,<state>,<resets>,hw:<hash>,imu:<0/1>,ram:<free>,min:<min>}
+// first, then short {<field>:...} lines, collected as likely diagnostics lines
+const DIAG_OWNER_PATTERN = /^\{([IDMX])(-?\d+),(-?\d+),(\d+),(\d+)(?:,(\d+)(?:,ram:\d+,min:\d+)?|,hw:\w+,imu:[01],ram:\d+,min:\d+)\}$/;
 // Stats line: {stats:rx=<rx>,jd=<jd>,pe=<pe>[,bc=<bc>],tx=<tx>,ms=<ms>}
 // Note: bc field is optional (missing in some firmware versions)
 const DIAG_STATS_PATTERN = /^\{stats:rx=(\d+),jd=(\d+),pe=(\d+)(?:,bc=\d+)?,tx=(\d+),ms=(\d+)\}$/;
@@ -165,13 +170,27 @@ export function buildStopCommand(tag?: string): FirmwareCommand {
   return { N: CMD.STOP, H: tag };
 }
 
-export function buildSetpointCommand(v: number, w: number, ttlMs: number): FirmwareCommand {
-  return {
+/**
+ * Build an N=200 setpoint. With seq (1..32767) the firmware drops duplicate
+ * and out-of-order frames; with sentMs (UNO millis() at send, low 15 bits,
+ * from ClockSync) it also drops frames older than their TTL.
+ */
+export function buildSetpointCommand(
+  v: number,
+  w: number,
+  ttlMs: number,
+  seq?: number,
+  sentMs?: number
+): FirmwareCommand {
+  const cmd: FirmwareCommand = {
     N: CMD.SETPOINT,
     D1: clampPWM(v),
     D2: clampPWM(w),
     T: clampTTL(ttlMs),
   };
+  if (seq !== undefined) cmd.D3 = seq;
+  if (sentMs !== undefined) cmd.D4 = sentMs;
+  return cmd;
 }
 
 export function buildDirectMotorCommand(left: number, right: number, tag?: string): FirmwareCommand {
@@ -222,6 +241,8 @@ export function serializeCommand(cmd: FirmwareCommand): string {
   if (cmd.D1 !== undefined) obj.D1 = cmd.D1;
   if (cmd.D2 !== undefined) obj.D2 = cmd.D2;
   if (cmd.T !== undefined) obj.T = cmd.T;
+  if (cmd.D3 !== undefined) obj.D3 = cmd.D3;
+  if (cmd.D4 !== undefined) obj.D4 = cmd.D4;
   
   return JSON.stringify(obj);
 }
@@ -7,6 +7,7 @@
  * - On open, goes through same handshake as real transport
  * - Virtual firmware responds {H_ok} to N=0, N=201, N=999, N=210, N=211
  * - For N=120 emits two diagnostics lines
+ * - For N=123 answers with a virtual micros() clock (fixed offset, +20ppm)
  * - Ignores N=200 (no response)
  */
 
@@ -39,6 +40,7 @@ export interface TransportEvents {
   onLine: (line: string) => void;
   onStateChange: (state: TransportState) => void;
   onError: (error: Error) => void;
+  onWrite?: (line: string) => void;
 }
 
 export class LoopbackEmulator {
@@ -58,6 +60,9 @@ export class LoopbackEmulator {
   private lastBootMarkerAt: number | null = null;
   private resetsSeen = 0;
   
+  // Virtual UNO clock for N=123
+  private readonly clockStartMs = performance.now() - 3000;
+  
   constructor(events: TransportEvents) {
     this.events = events;
   }
@@ -112,6 +117,7 @@ export class LoopbackEmulator {
   writeLine(line: string, priority: number = PRIORITY.COMMAND): boolean {
     this.txBytes += line.length + 1;
     this.lastTxAt = Date.now();
+    this.events.onWrite?.(line);
     
     // Parse and handle as firmware would
     try {
@@ -171,12 +177,20 @@ export class LoopbackEmulator {
           // Emit two diagnostic lines
           const leftPWM = Math.floor(Math.random() * 200) - 100;
           const rightPWM = Math.floor(Math.random() * 200) - 100;
-          this.firmwareEmitLine(`{I${leftPWM},${rightPWM},0,0,${this.resetsSeen}}`);
+          this.firmwareEmitLine(`{I${leftPWM},${rightPWM},0,${this.resetsSeen},hw:LOOPBACK,imu:0,ram:1024,min:1024}`);
           setTimeout(() => {
             this.firmwareEmitLine(`{stats:rx=${this.txBytes},jd=0,pe=0,bc=0,tx=${this.rxBytes},ms=${Date.now() % 100000}}`);
           }, 10);
           break;
           
+        case CMD.TIME_PROBE: {
+          // Frame parsed on arrival, reply ~100us later, nothing queued
+          const unoUs = () => Math.floor((performance.now() - this.clockStartMs) * 1000 * 1.00002) >>> 0;
+          const rxUs = unoUs() - 100;
+          this.firmwareEmitLine(`{${tag}_${cmd.T ?? 0},${rxUs >>> 0},${unoUs()},0}`);
+          break;
+        }
+          
         case CMD.SETPOINT:
           // N=200 - no response (fire-and-forget)
           break;
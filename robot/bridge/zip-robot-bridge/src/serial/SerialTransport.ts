@@ -43,6 +43,7 @@ export interface TransportEvents {
   onLine: (line: string) => void;
   onStateChange: (state: TransportState) => void;
   onError: (error: Error) => void;
+  onWrite?: (line: string) => void;  // Line handed to the port (after queueing)
 }
 
 interface QueuedWrite {
@@ -298,6 +299,7 @@ export class SerialTransport {
       this.port.write(data);
       this.txBytes += data.length;
       this.lastTxAt = Date.now();
+      this.events.onWrite?.(item.line);
     }
     
     // If still items, schedule another flush
@@ -7,6 +7,8 @@
  * - Coalesces setpoint updates (keeps latest)
  * - Enforces rate limits and TTL clamping
  * - Clean stop with N=201
+ * - Sequence-numbered frames (D3) with a send stamp (D4) once ClockSync is
+ *   synced; the firmware's {sq:...} cumulative ack drives AIMD on the rate
  */
 
 import { logger } from '../logging/logger.js';
@@ -25,6 +27,50 @@ import {
   clampRateHz,
   type FirmwareCommand,
 } from '../protocol/FirmwareJson.js';
+import { type ClockSync, hostNowUs } from '../protocol/ClockSync.js';
+
+// Firmware cumulative ack: {sq:<lastSeq>,<applied>,<stale>,<reordered>,<rxOverflow>,<jsonLong>}
+const SEQ_ACK_PATTERN = /^\{sq:(\d+),(\d+),(\d+),(\d+),(\d+),(\d+)\}$/;
+// Firmware drive safety telemetry (1Hz while streaming, in place of an ack):
+// {sl:<calls>,<ff>,<cap>,<slew>,<kick>,<deadband>,<lagLast>,<lagPeak>}
+const LIMIT_STATS_PATTERN = /^\{sl:(\d+),(\d+),(\d+),(\d+),(\d+),(\d+),(\d+),(\d+)\}$/;
+const SEQ_MAX = 32767;          // D3 is a 16-bit int on the UNO; 0 = unsequenced
+const MIN_DELIVERY_RATIO = 0.8; // Below this per ack interval, back off
+
+interface SeqAck {
+  lastSeq: number;
+  applied: number;
+  stale: number;
+  reordered: number;
+  rxOverflow: number;
+  jsonLong: number;
+}
+
+interface LimitCounters {
+  calls: number;
+  feedforward: number;
+  cap: number;
+  slew: number;
+  kick: number;
+  deadband: number;
+}
+
+/**
+ * Drive safety layer activity over the last {sl:...} interval: share of
+ * applyLimits() calls in which each stage changed the output, and how long
+ * the slew limiter trailed its target
+ */
+export interface DriveLimitStats {
+  calls: number;         // applyLimits() calls (20ms tick + applied setpoints)
+  feedforwardPct: number;
+  capPct: number;
+  slewPct: number;
+  kickPct: number;
+  deadbandPct: number;
+  lagLastCalls: number;  // Last slew catch-up, in applyLimits() calls
+  lagPeakCalls: number;  // Longest since boot or N=140 D1=8
+  at: number;
+}
 
 export interface SetpointState {
   v: number;     // Forward velocity (-255 to 255)
@@ -45,6 +91,20 @@ export class SetpointStreamer {
   private config: StreamerConfig;
   private timer: NodeJS.Timeout | null = null;
   private sendFn: ((cmd: FirmwareCommand) => boolean) | null = null;
+  private clockSync: ClockSync | null = null;
+  
+  // Sequencing and congestion control
+  private seq = 0;
+  private effectiveRateHz: number;
+  private lastAck: SeqAck | null = null;
+  private framesLost = 0;
+  private framesStale = 0;
+  private framesReordered = 0;
+  private backoffs = 0;
+  
+  // Drive safety telemetry
+  private lastLimitCounters: LimitCounters | null = null;
+  private driveLimits: DriveLimitStats | null = null;
   
   // Stats
   private framesSent = 0;
@@ -55,6 +115,7 @@ export class SetpointStreamer {
       rateHz: STREAM_DEFAULT_RATE_HZ,
       ttlMs: STREAM_DEFAULT_TTL_MS,
     };
+    this.effectiveRateHz = this.config.rateHz;
   }
   
   /**
@@ -64,6 +125,13 @@ export class SetpointStreamer {
     this.sendFn = fn;
   }
   
+  /**
+   * Set the clock estimate used to stamp frames (D4)
+   */
+  setClockSync(clockSync: ClockSync): void {
+    this.clockSync = clockSync;
+  }
+  
   /**
    * Start streaming with initial setpoint
    */
@@ -77,6 +145,7 @@ export class SetpointStreamer {
       rateHz: clampedRate,
       ttlMs: clampedTtl,
     };
+    this.effectiveRateHz = clampedRate;
     
     // Set initial setpoint
     this.currentSetpoint = {
@@ -163,7 +232,7 @@ export class SetpointStreamer {
       clearInterval(this.timer);
     }
     
-    const intervalMs = 1000 / this.config.rateHz;
+    const intervalMs = 1000 / this.effectiveRateHz;
     this.timer = setInterval(() => {
       this.sendFrame();
     }, intervalMs);
@@ -187,10 +256,21 @@ export class SetpointStreamer {
       return;
     }
     
+    this.seq = this.seq >= SEQ_MAX ? 1 : this.seq + 1;
+    
+    // Send stamp in UNO millis() (low 15 bits; 0 means "none")
+    let sentMs: number | undefined;
+    const unoUs = this.clockSync?.toUnoUs(hostNowUs() / 1000) ?? null;
+    if (unoUs !== null) {
+      sentMs = (Math.floor(unoUs / 1000) & 0x7FFF) || 1;
+    }
+    
     const cmd = buildSetpointCommand(
       this.currentSetpoint.v,
       this.currentSetpoint.w,
-      this.currentSetpoint.ttlMs
+      this.currentSetpoint.ttlMs,
+      this.seq,
+      sentMs
     );
     
     if (this.sendFn(cmd)) {
@@ -198,6 +278,144 @@ export class SetpointStreamer {
     }
   }
   
+  /**
+   * Handle a line from the UNO. Returns true if it was a {sq:...} ack or
+   * {sl:...} drive telemetry (consumed - bridge-internal).
+   *
+   * Per ack interval: the seqs the firmware moved past (previous to current
+   * lastSeq) vs. applied gives the delivery ratio (bridge coalescing, UART
+   * loss and firmware rejects alike). Frames newer than lastSeq are still in
+   * flight and count in a later interval. Any stale frame or RX overflow
+   * also counts as congestion. Congestion halves the
+   * stream rate (not below two frames per TTL), a clean interval adds 1Hz
+   * back up to the configured rate.
+   */
+  handleAck(line: string): boolean {
+    if (this.handleLimitStats(line)) {
+      return true;
+    }
+    const match = line.match(SEQ_ACK_PATTERN);
+    if (!match) {
+      return false;
+    }
+    
+    const ack: SeqAck = {
+      lastSeq: Number(match[1]),
+      applied: Number(match[2]),
+      stale: Number(match[3]),
+      reordered: Number(match[4]),
+      rxOverflow: Number(match[5]),
+      jsonLong: Number(match[6]),
+    };
+    const prev = this.lastAck;
+    this.lastAck = ack;
+    
+    // First ack (or after a firmware reset) only sets the reference
+    if (!prev || this.status !== 'streaming') {
+      return true;
+    }
+    
+    // Seqs run 1..SEQ_MAX. A lastSeq of 0 (nothing sequenced yet) or one
+    // ahead of what was sent (firmware resync to another host) only sets
+    // the reference.
+    const seqSpan = (from: number, to: number) => (to - from + SEQ_MAX) % SEQ_MAX;
+    const numbered = seqSpan(prev.lastSeq, ack.lastSeq);
+    if (prev.lastSeq === 0 || numbered > seqSpan(prev.lastSeq, this.seq)) {
+      return true;
+    }
+    
+    // Firmware counters are free-running uint16
+    const delta = (a: number, b: number) => (a - b + 65536) % 65536;
+    const applied = delta(ack.applied, prev.applied);
+    const stale = delta(ack.stale, prev.stale);
+    const reordered = delta(ack.reordered, prev.reordered);
+    const overflow = delta(ack.rxOverflow, prev.rxOverflow) + delta(ack.jsonLong, prev.jsonLong);
+    
+    // Stale and reordered frames never advance lastSeq, so the ones counted
+    // here may lie past it; the clamp keeps them from going negative
+    this.framesLost += Math.max(0, numbered - applied - stale - reordered);
+    this.framesStale += stale;
+    this.framesReordered += reordered;
+    
+    const congested = stale > 0 || overflow > 0 ||
+      (numbered > 0 && applied / numbered < MIN_DELIVERY_RATIO);
+    const floorHz = Math.min(this.config.rateHz, Math.ceil(2000 / this.config.ttlMs));
+    let rateHz = this.effectiveRateHz;
+    
+    if (congested) {
+      rateHz = Math.max(floorHz, Math.floor(rateHz / 2));
+    } else if (rateHz < this.config.rateHz) {
+      rateHz++;
+    }
+    
+    if (rateHz !== this.effectiveRateHz) {
+      if (rateHz < this.effectiveRateHz) {
+        this.backoffs++;
+      }
+      logger.log('stream_rate', {
+        rateHz,
+        numbered,
+        applied,
+        stale,
+        reordered,
+        overflow,
+      });
+      this.effectiveRateHz = rateHz;
+      this.startTimer();
+    }
+    
+    return true;
+  }
+  
+  /**
+   * Handle a {sl:...} drive safety line. Counters are free-running uint16,
+   * so percentages come from the difference to the previous line.
+   */
+  private handleLimitStats(line: string): boolean {
+    const match = line.match(LIMIT_STATS_PATTERN);
+    if (!match) {
+      return false;
+    }
+    
+    const counters: LimitCounters = {
+      calls: Number(match[1]),
+      feedforward: Number(match[2]),
+      cap: Number(match[3]),
+      slew: Number(match[4]),
+      kick: Number(match[5]),
+      deadband: Number(match[6]),
+    };
+    const prev = this.lastLimitCounters;
+    this.lastLimitCounters = counters;
+    if (!prev) {
+      return true;
+    }
+    
+    const delta = (a: number, b: number) => (a - b + 65536) % 65536;
+    const calls = delta(counters.calls, prev.calls);
+    const pct = (n: number) => calls > 0 ? Math.round((n * 100) / calls) : 0;
+    this.driveLimits = {
+      calls,
+      feedforwardPct: pct(delta(counters.feedforward, prev.feedforward)),
+      capPct: pct(delta(counters.cap, prev.cap)),
+      slewPct: pct(delta(counters.slew, prev.slew)),
+      kickPct: pct(delta(counters.kick, prev.kick)),
+      deadbandPct: pct(delta(counters.deadband, prev.deadband)),
+      lagLastCalls: Number(match[7]),
+      lagPeakCalls: Number(match[8]),
+      at: Date.now(),
+    };
+    return true;
+  }
+  
+  /**
+   * Forget the firmware ack state (firmware reset: counters restart at 0)
+   */
+  resetAck(): void {
+    this.lastLimitCounters = null;
+    this.lastAck = null;
+  }
+  
   /**
    * Get current status
    */
@@ -226,8 +444,16 @@ export class SetpointStreamer {
     return {
       status: this.status,
       rateHz: this.config.rateHz,
+      effectiveRateHz: this.effectiveRateHz,
       ttlMs: this.config.ttlMs,
       framesSent: this.framesSent,
+      seq: this.seq,
+      ackedSeq: this.lastAck?.lastSeq ?? null,
+      framesLost: this.framesLost,
+      framesStale: this.framesStale,
+      framesReordered: this.framesReordered,
+      backoffs: this.backoffs,
+      driveLimits: this.driveLimits,
       durationMs: this.streamStartedAt ? Date.now() - this.streamStartedAt : 0,
       currentSetpoint: this.currentSetpoint,
     };
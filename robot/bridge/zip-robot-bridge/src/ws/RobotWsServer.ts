@@ -454,7 +454,7 @@ export class RobotWsServer {
       port: transportStats?.port ?? null,
       baud: transportStats?.baud ?? 115200,
       streaming: streamerStats?.status === 'streaming',
-      streamRateHz: streamerStats?.rateHz ?? 0,
+      streamRateHz: streamerStats?.effectiveRateHz ?? 0,
       rxBytes: transportStats?.rxBytes ?? 0,
       txBytes: transportStats?.txBytes ?? 0,
       pending: this.replyMatcher?.getPendingCount() ?? 0,
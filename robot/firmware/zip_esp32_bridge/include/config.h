@@ -83,6 +83,45 @@
 #define UART_BAUD               115200
 #endif
 
+// Negotiated fast UART rate (N=124 handshake after boot), 0 = stay at
+// UART_BAUD. The UNO supports 250000/500000/1000000 (exact at 16MHz).
+#ifndef UART_BAUD_FAST
+#define UART_BAUD_FAST          1000000
+#endif
+
+// N=124 link baud command
+#ifndef UART_BAUD_CMD
+#define UART_BAUD_CMD           124
+#endif
+
+// Handshake timing: reply wait, probe interval/count, retry after a failure
+// and settle time after boot guard or a UNO reset before negotiating
+#ifndef UART_BAUD_REPLY_MS
+#define UART_BAUD_REPLY_MS      300
+#endif
+
+#ifndef UART_BAUD_PROBE_MS
+#define UART_BAUD_PROBE_MS      100
+#endif
+
+#ifndef UART_BAUD_PROBES
+#define UART_BAUD_PROBES        3
+#endif
+
+#ifndef UART_BAUD_RETRY_MS
+#define UART_BAUD_RETRY_MS      30000
+#endif
+
+#ifndef UART_BAUD_SETTLE_MS
+#define UART_BAUD_SETTLE_MS     1500
+#endif
+
+// Non-text bytes at the fast rate (since the last good line) that mean the
+// UNO is back at UART_BAUD (reset, or it timed out the switch)
+#ifndef UART_BAUD_GARBAGE_LIMIT
+#define UART_BAUD_GARBAGE_LIMIT 16
+#endif
+
 // UART RX pin (ESP32 receives from UNO TX)
 // Fixed by ELEGOO SmartCar-Shield - DO NOT CHANGE
 // Must use HardwareSerial(1) with explicit pin binding, NOT Serial2
@@ -0,0 +1,76 @@
+/**
+ * ZIP ESP32 Bridge - JSON Line Filters
+ * 
+ * Lightweight checks run on every WebSocket message and UART line.
+ * Header-only with no Arduino dependency so the host benchmark suite
+ * (zip_robot_uno env:native_bench) runs the same code as the bridge.
+ */
+
+#ifndef JSON_LINE_H
+#define JSON_LINE_H
+
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+
+/**
+ * Value of the first "N" field, or -1 if there is none.
+ * Uses lightweight pattern matching without full JSON parsing.
+ * 
+ * Looks for patterns like:
+ *   "N":200  or  "N": 200
+ */
+static inline int commandNumber(const char* msg, size_t len) {
+    // Scan for "N": pattern
+    for (size_t i = 0; i + 6 < len; i++) {
+        if (msg[i] == '"' && msg[i+1] == 'N' && msg[i+2] == '"' && msg[i+3] == ':') {
+            // Found "N": - now check the value
+            size_t valStart = i + 4;
+            
+            // Skip optional whitespace
+            while (valStart < len && (msg[valStart] == ' ' || msg[valStart] == '\t')) {
+                valStart++;
+            }
+            
+            // Parse the number
+            int nValue = 0;
+            while (valStart < len && msg[valStart] >= '0' && msg[valStart] <= '9') {
+                nValue = nValue * 10 + (msg[valStart] - '0');
+                valStart++;
+            }
+            
+            // Only check first "N" field
+            return nValue;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Check if a message is a motion command (N=200 or N=999).
+ */
+static inline bool isMotionCommand(const char* msg, size_t len) {
+    int n = commandNumber(msg, len);
+    return n == MOTION_CMD_SETPOINT || n == MOTION_CMD_DIRECT;
+}
+
+/**
+ * Check if the accumulated line looks like valid JSON.
+ * Simple check: starts with { and ends with }
+ */
+static inline bool isValidJsonLine(const char* line) {
+    if (!line || line[0] == '\0') return false;
+    
+    // Find first non-whitespace
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line != '{') return false;
+    
+    // Find last non-whitespace
+    size_t len = strlen(line);
+    while (len > 0 && (line[len-1] == ' ' || line[len-1] == '\t')) len--;
+    if (len == 0 || line[len-1] != '}') return false;
+    
+    return true;
+}
+
+#endif // JSON_LINE_H
@@ -7,7 +7,7 @@
  * Features:
  * - WiFi AP mode (configurable SSID/password)
  * - WebSocket server at /robot (single controller mode)
- * - UART bridge at 115200 baud
+ * - UART bridge at 115200 baud, negotiated up to UART_BAUD_FAST (N=124)
  * - Dead-man safety watchdog
  * - Motion command rate limiting (50Hz max)
  * - Health endpoint at /health
@@ -20,6 +20,7 @@
 #include <WebSocketsServer.h>
 #include <ESPmDNS.h>
 #include "config.h"
+#include "json_line.h"
 
 // ============================================================================
 // UART Configuration for ESP32-S3
@@ -56,6 +57,21 @@ static uint32_t droppedLines = 0;
 static uint32_t wsRxMessages = 0;
 static uint32_t wsTxMessages = 0;
 
+// Link baud negotiation (N=124)
+enum LinkState : uint8_t {
+    LINK_IDLE,      // At UART_BAUD, next attempt after linkWaitMs
+    LINK_REQUEST,   // N=124 sent at UART_BAUD, waiting for {bd_ok}
+    LINK_PROBE,     // Switched, waiting for a {bp_<kbaud>} probe reply
+    LINK_FAST       // Confirmed at UART_BAUD_FAST
+};
+static LinkState linkState = LINK_IDLE;
+static uint32_t linkBaud = UART_BAUD;
+static unsigned long linkStateTime = 0;
+static unsigned long linkWaitMs = UART_BAUD_SETTLE_MS;
+static uint8_t linkProbes = 0;
+static uint8_t linkGarbage = 0;
+static uint32_t linkFailures = 0;
+
 // Safety state
 static unsigned long lastMotionTime = 0;
 static bool motionWatchdogTriggered = false;
@@ -98,44 +114,7 @@ static inline int ringBufferPop() {
 // Motion Command Detection
 // ============================================================================
 
-/**
- * Check if a message is a motion command (N=200 or N=999).
- * Uses lightweight pattern matching without full JSON parsing.
- * 
- * Looks for patterns like:
- *   "N":200  or  "N": 200
- *   "N":999  or  "N": 999
- */
-static bool isMotionCommand(const char* msg, size_t len) {
-    // Scan for "N": pattern
-    for (size_t i = 0; i + 6 < len; i++) {
-        if (msg[i] == '"' && msg[i+1] == 'N' && msg[i+2] == '"' && msg[i+3] == ':') {
-            // Found "N": - now check the value
-            size_t valStart = i + 4;
-            
-            // Skip optional whitespace
-            while (valStart < len && (msg[valStart] == ' ' || msg[valStart] == '\t')) {
-                valStart++;
-            }
-            
-            // Parse the number
-            int nValue = 0;
-            while (valStart < len && msg[valStart] >= '0' && msg[valStart] <= '9') {
-                nValue = nValue * 10 + (msg[valStart] - '0');
-                valStart++;
-            }
-            
-            // Check if it's a motion command
-            if (nValue == MOTION_CMD_SETPOINT || nValue == MOTION_CMD_DIRECT) {
-                return true;
-            }
-            
-            // Only check first "N" field
-            break;
-        }
-    }
-    return false;
-}
+// isMotionCommand() lives in json_line.h (shared with the host benchmarks)
 
 // ============================================================================
 // UART Functions
@@ -146,6 +125,8 @@ static bool uartBootGuardExpired = false;
 static unsigned long uartBootStartTime = 0;
 #define BOOT_GUARD_MS 1000  // Wait 1 second before enabling UART RX
 
+static void linkFallback(const char* reason, unsigned long retryMs);
+
 /**
  * Initialize UART for communication with Arduino UNO.
  * 
@@ -241,6 +222,12 @@ static bool uartTick() {
     while (RobotSerial.available() && !ringBufferFull()) {
         int byte = RobotSerial.read();
         if (byte >= 0) {
+            // UNO talking at UART_BAUD while we listen fast: framing garbage
+            if (linkBaud != UART_BAUD && (byte < 0x09 || byte > 0x7E) &&
+                ++linkGarbage >= UART_BAUD_GARBAGE_LIMIT) {
+                linkFallback("rate mismatch", UART_BAUD_SETTLE_MS);
+                return false;
+            }
             ringBufferPush((uint8_t)byte);
         }
     }
@@ -271,23 +258,139 @@ static bool uartTick() {
     return false;
 }
 
+// isValidJsonLine() lives in json_line.h
+
+// ============================================================================
+// Link Baud Negotiation (N=124)
+// ============================================================================
+//
+// After the boot guard (and after every UNO reset) the bridge asks the UNO
+// to move the link to UART_BAUD_FAST:
+//   1. @UART_BAUD: {"N":124,"H":"bd","D1":<kbaud>}  ->  {bd_ok}
+//   2. both ends switch; the bridge probes with {"N":124,"H":"bp","D1":0}
+//      (rate query) until {bp_<kbaud>} comes back, which also confirms the
+//      UNO side (its first valid frame at the new rate)
+// Any failure drops back to UART_BAUD: no reply, no probe reply, or framing
+// garbage once fast. The UNO reverts on its own if no valid frame follows
+// the switch within 500ms, so both ends always meet again at UART_BAUD.
+
+static void linkSetBaud(uint32_t baud) {
+    RobotSerial.flush();
+    RobotSerial.updateBaudRate(baud);
+    while (RobotSerial.available()) {
+        RobotSerial.read();  // Bytes that straddled the switch
+    }
+    linkBaud = baud;
+    linkGarbage = 0;
+    linePos = 0;
+}
+
+static void linkSchedule(unsigned long waitMs) {
+    linkState = LINK_IDLE;
+    linkStateTime = millis();
+    linkWaitMs = waitMs;
+}
+
+static void linkFallback(const char* reason, unsigned long retryMs) {
+    if (linkBaud != UART_BAUD) {
+        linkSetBaud(UART_BAUD);
+    }
+    linkFailures++;
+    LOG_W("UART link at %d baud (%s), retry in %lu ms", UART_BAUD, reason, retryMs);
+    linkSchedule(retryMs);
+}
+
 /**
- * Check if the accumulated line looks like valid JSON.
- * Simple check: starts with { and ends with }
+ * Advance the handshake. Called every loop after the boot guard.
  */
-static bool isValidJsonLine(const char* line) {
-    if (!line || line[0] == '\0') return false;
-    
-    // Find first non-whitespace
-    while (*line == ' ' || *line == '\t') line++;
-    if (*line != '{') return false;
-    
-    // Find last non-whitespace
-    size_t len = strlen(line);
-    while (len > 0 && (line[len-1] == ' ' || line[len-1] == '\t')) len--;
-    if (len == 0 || line[len-1] != '}') return false;
+static void linkTick() {
+#if UART_BAUD_FAST
+    if (!uartBootGuardExpired) {
+        return;
+    }
+    unsigned long now = millis();
+    switch (linkState) {
+        case LINK_IDLE:
+            if (now - linkStateTime >= linkWaitMs) {
+                char req[48];
+                snprintf(req, sizeof(req), "{\"N\":%d,\"H\":\"bd\",\"D1\":%lu}\n",
+                         UART_BAUD_CMD, (unsigned long)(UART_BAUD_FAST / 1000));
+                uartSend(req);
+                linkState = LINK_REQUEST;
+                linkStateTime = now;
+            }
+            break;
+            
+        case LINK_REQUEST:
+            if (now - linkStateTime >= UART_BAUD_REPLY_MS) {
+                linkFallback("no N=124 reply", UART_BAUD_RETRY_MS);
+            }
+            break;
+            
+        case LINK_PROBE:
+            if (now - linkStateTime >= UART_BAUD_PROBE_MS) {
+                if (linkProbes >= UART_BAUD_PROBES) {
+                    linkFallback("no probe reply", UART_BAUD_RETRY_MS);
+                    break;
+                }
+                char probe[40];
+                snprintf(probe, sizeof(probe), "{\"N\":%d,\"H\":\"bp\",\"D1\":0}\n", UART_BAUD_CMD);
+                uartSend(probe);
+                linkProbes++;
+                linkStateTime = now;
+            }
+            break;
+            
+        case LINK_FAST:
+            break;
+    }
+#endif
+}
+
+/**
+ * Handshake replies and the UNO boot marker.
+ * Returns true if the line belongs to the handshake (not forwarded).
+ */
+static bool linkHandleLine(const char* line) {
+    linkGarbage = 0;  // A clean line: the rate is right
     
-    return true;
+    if (strcmp(line, "R") == 0) {
+        // UNO reset: it is back at UART_BAUD
+        if (linkBaud != UART_BAUD) {
+            linkSetBaud(UART_BAUD);
+        }
+        linkSchedule(UART_BAUD_SETTLE_MS);
+        return false;
+    }
+    if (strncmp(line, "{bd_", 4) == 0) {
+        if (linkState == LINK_REQUEST) {
+            if (strcmp(line, "{bd_ok}") == 0) {
+                linkSetBaud(UART_BAUD_FAST);
+                linkState = LINK_PROBE;
+                linkProbes = 0;
+                linkStateTime = millis() - UART_BAUD_PROBE_MS;  // Probe right away
+            } else {
+                linkFallback("rate refused", UART_BAUD_RETRY_MS);
+            }
+        }
+        return true;
+    }
+    if (strncmp(line, "{bp_", 4) == 0) {
+        if (linkState == LINK_PROBE && (uint32_t)atol(line + 4) * 1000 == linkBaud) {
+            linkState = LINK_FAST;
+            LOG("UART link at %lu baud", (unsigned long)linkBaud);
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * True while a switch is in flight: bytes sent now could arrive at the UNO
+ * after it changed rate.
+ */
+static inline bool linkTxBlocked() {
+    return linkState == LINK_REQUEST;
 }
 
 // ============================================================================
@@ -341,6 +444,19 @@ static void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t
                 }
                 
                 const char* msg = (const char*)payload;
+                
+                // Link rate is owned by the bridge
+                if (commandNumber(msg, length) == UART_BAUD_CMD) {
+                    LOG_W("WS[%u] N=%d ignored (bridge-managed)", num, UART_BAUD_CMD);
+                    break;
+                }
+                
+                // Mid-handshake: drop rather than garble (setpoints are resent)
+                if (linkTxBlocked()) {
+                    droppedLines++;
+                    break;
+                }
+                
                 bool isMotion = isMotionCommand(msg, length);
                 
                 if (isMotion) {
@@ -411,7 +527,8 @@ static void handleHealth() {
     json += "\"ws_path\":\"" + String(WS_PATH) + "\",";
     json += "\"clients\":" + String(wsServer.connectedClients()) + ",";
     json += "\"controller\":" + String(controllerClientNum >= 0 ? "true" : "false") + ",";
-    json += "\"uart_baud\":" + String(UART_BAUD) + ",";
+    json += "\"uart_baud\":" + String(linkBaud) + ",";
+    json += "\"uart_link_failures\":" + String(linkFailures) + ",";
     json += "\"rx_lines\":" + String(rxLines) + ",";
     json += "\"tx_lines\":" + String(txLines) + ",";
     json += "\"dropped_lines\":" + String(droppedLines) + ",";
@@ -547,7 +664,9 @@ static void bridgeTick() {
         rxLines++;
         
         // Check if it's valid JSON
-        if (isValidJsonLine(lineBuffer)) {
+        if (linkHandleLine(lineBuffer)) {
+            // Handshake reply - bridge-internal
+        } else if (isValidJsonLine(lineBuffer)) {
             // Forward to controller if connected
             if (controllerClientNum >= 0) {
                 wsServer.sendTXT(controllerClientNum, lineBuffer);
@@ -599,6 +718,9 @@ void loop() {
     // Bridge UART to WebSocket
     bridgeTick();
     
+    // Link baud negotiation
+    linkTick();
+    
     // Safety watchdog
     safetyTick();
     
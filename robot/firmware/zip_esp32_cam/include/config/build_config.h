@@ -32,6 +32,11 @@
 #define ENABLE_STREAM               1
 #endif
 
+// Adapt JPEG quality / frame size to the stream link (needs the pipeline)
+#ifndef ENABLE_STREAM_ADAPT
+#define ENABLE_STREAM_ADAPT         1
+#endif
+
 // Verbose logging (debug builds only)
 #ifndef ENABLE_VERBOSE_LOGS
 #define ENABLE_VERBOSE_LOGS         0
@@ -64,6 +64,12 @@
 #define CONFIG_UART_BAUD            115200
 #endif
 
+// Negotiated fast rate (N=124 handshake with the UNO), 0 = stay at
+// CONFIG_UART_BAUD. Falls back to CONFIG_UART_BAUD on any failure.
+#ifndef CONFIG_UART_BAUD_FAST
+#define CONFIG_UART_BAUD_FAST       1000000
+#endif
+
 // Debug serial baud rate
 #ifndef CONFIG_DEBUG_BAUD
 #define CONFIG_DEBUG_BAUD           115200
@@ -138,6 +144,71 @@
 #define CONFIG_STREAM_PORT          81
 #endif
 
+// Stream clients served at once (one sender task each); more get a 503
+#ifndef CONFIG_STREAM_MAX_CLIENTS
+#define CONFIG_STREAM_MAX_CLIENTS   3
+#endif
+
+// Stream pipeline: PSRAM slots between the capture task and the senders.
+// Clients + 2 = one being filled, one newest, one held per client - the
+// capture task never waits, however the clients are spread over frames.
+#ifndef CONFIG_STREAM_SLOTS
+#define CONFIG_STREAM_SLOTS         (CONFIG_STREAM_MAX_CLIENTS + 2)
+#endif
+
+#if CONFIG_STREAM_SLOTS < CONFIG_STREAM_MAX_CLIENTS + 2
+#error "CONFIG_STREAM_SLOTS must be at least CONFIG_STREAM_MAX_CLIENTS + 2"
+#endif
+
+// Bytes per slot (part header + JPEG + boundary). VGA at quality 10 is
+// 20-60 KB; bigger frames are dropped and counted as oversize.
+#ifndef CONFIG_STREAM_SLOT_BYTES
+#define CONFIG_STREAM_SLOT_BYTES    (128 * 1024)
+#endif
+
+// Sender gives up waiting for a frame after this long (then re-checks)
+#ifndef CONFIG_STREAM_FRAME_TIMEOUT_MS
+#define CONFIG_STREAM_FRAME_TIMEOUT_MS 1000
+#endif
+
+// Adaptive quality: frame rate the slowest client should hold. Its send
+// budget is 1000 / fps ms per frame.
+#ifndef CONFIG_STREAM_TARGET_FPS
+#define CONFIG_STREAM_TARGET_FPS    15
+#endif
+
+// Adaptive quality: evaluation window
+#ifndef CONFIG_STREAM_ADAPT_WINDOW_MS
+#define CONFIG_STREAM_ADAPT_WINDOW_MS 1000
+#endif
+
+// Step down when the slowest client's mean send time is above this % of
+// the budget for DEGRADE_WINDOWS windows in a row
+#ifndef CONFIG_STREAM_ADAPT_DEGRADE_PCT
+#define CONFIG_STREAM_ADAPT_DEGRADE_PCT 100
+#endif
+
+#ifndef CONFIG_STREAM_ADAPT_DEGRADE_WINDOWS
+#define CONFIG_STREAM_ADAPT_DEGRADE_WINDOWS 2
+#endif
+
+// Step up when the next level's predicted send time (its frame bytes at the
+// measured link rate) stays below this % for UPGRADE_WINDOWS windows.
+// The gap to DEGRADE_PCT and the longer wait are the hysteresis.
+#ifndef CONFIG_STREAM_ADAPT_UPGRADE_PCT
+#define CONFIG_STREAM_ADAPT_UPGRADE_PCT 60
+#endif
+
+#ifndef CONFIG_STREAM_ADAPT_UPGRADE_WINDOWS
+#define CONFIG_STREAM_ADAPT_UPGRADE_WINDOWS 5
+#endif
+
+// A single send above this % of the budget is a stall (socket backpressure)
+// and steps down at the end of its window without waiting
+#ifndef CONFIG_STREAM_ADAPT_STALL_PCT
+#define CONFIG_STREAM_ADAPT_STALL_PCT 400
+#endif
+
 // ============================================================================
 // Watchdog Configuration
 // ============================================================================
@@ -83,6 +83,58 @@ def print_camera_diagnostics(health: Dict[str, Any]):
     else:
         print(f"  ⚠️  Camera status: {status}")
 
+def print_stream_diagnostics(health: Dict[str, Any]):
+    """Print MJPEG stream pipeline diagnostics."""
+    stream = health.get("stream")
+    if stream is None:
+        return
+    
+    print("\n" + "="*60)
+    print("  STREAM DIAGNOSTICS")
+    print("="*60)
+    
+    pipelined = stream.get("pipelined", False)
+    print(f"Pipelined:     {'YES' if pipelined else 'NO (inline capture)'}")
+    handoff = stream.get("handoff", "none")
+    print(f"Handoff:       {handoff.upper() if handoff != 'none' else 'NO (one client at a time)'}")
+    print(f"Clients:       {stream.get('clients', 0)}/{stream.get('max_clients', 0)}")
+    print(f"Sensor FPS:    {stream.get('sensor_fps', 0)}")
+    print(f"Stream FPS:    {stream.get('stream_fps', 0)}")
+    client_fps = stream.get("client_fps", [])
+    if client_fps:
+        print(f"Client FPS:    {', '.join(str(fps) for fps in client_fps)}")
+    
+    print(f"\nStatistics:")
+    print(f"  Captured:    {stream.get('captured', 0)}")
+    print(f"  Sent:        {stream.get('sent', 0)}")
+    print(f"  Skipped:     {stream.get('skipped', 0)}")
+    print(f"  Dropped:     {stream.get('dropped', 0)}")
+    print(f"  Rejected:    {stream.get('rejected', 0)}")
+    print(f"  Oversize:    {stream.get('oversize', 0)}")
+    print(f"  Last Copy:   {stream.get('last_copy_us', 0)} us")
+    print(f"  Last Send:   {stream.get('last_send_ms', 0)} ms")
+    
+    adapt = stream.get("adapt", {})
+    if adapt.get("enabled", False):
+        print(f"\nAdaptive Quality:")
+        print(f"  Level:       {adapt.get('level', 0)}/{adapt.get('levels', 0) - 1} "
+              f"({adapt.get('framesize', '?')} q{adapt.get('quality', 0)})")
+        print(f"  Pressure:    {adapt.get('pressure_pct', 0)}% of {adapt.get('target_fps', 0)} fps budget "
+              f"(next level up: {adapt.get('predicted_pct', 0)}%)")
+        print(f"  Steps:       {adapt.get('degrades', 0)} down, {adapt.get('upgrades', 0)} up, "
+              f"{adapt.get('stalls', 0)} stalls")
+        print(f"  Last Step:   {adapt.get('last_reason', 'none')} at {adapt.get('last_change_ms', 0)} ms")
+    
+    print(f"\nDiagnosis:")
+    if not pipelined:
+        print("  ⚠️  Pipeline not running - check PSRAM")
+    elif stream.get("oversize", 0) > 0:
+        print("  ⚠️  Frames larger than a slot - raise CONFIG_STREAM_SLOT_BYTES")
+    elif stream.get("clients", 0) > 0 and stream.get("skipped", 0) > stream.get("sent", 0):
+        print("  ⚠️  Link slower than the sensor - most frames skipped")
+    else:
+        print("  ✅ Stream pipeline is operational")
+
 def print_uart_diagnostics(health: Dict[str, Any]):
     """Print UART diagnostics."""
     uart = health.get("uart", {})
@@ -221,6 +273,7 @@ def main():
     health = query_health(ip)
     
     print_camera_diagnostics(health)
+    print_stream_diagnostics(health)
     print_uart_diagnostics(health)
     print_system_info(health)
     
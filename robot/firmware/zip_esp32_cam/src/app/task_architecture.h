@@ -20,6 +20,16 @@
  *   - Serial output (ESP_LOG)
  *   - Diagnostics
  *   - Non-critical logging
+ * 
+ * Task D: Camera Capture (Low Priority, Core 1) - web/stream_pipeline.cpp
+ *   - Pulls frames from the sensor while a stream client is connected
+ *   - Copies each into a PSRAM slot for the stream senders (Core 0)
+ * 
+ * Task E: Stream Senders (Low Priority, Core 0) - web/web_server.cpp
+ *   - One per stream client (CONFIG_STREAM_MAX_CLIENTS), fed by httpd
+ *     async requests (IDF 5.1+) or the client's socket (IDF 4.4) so no
+ *     client holds the httpd worker
+ *   - Each sends the newest slot it has not sent yet
  */
 
 #ifndef TASK_ARCHITECTURE_H
@@ -35,6 +45,8 @@
 #define TASK_PRIORITY_CMD_CONTROL    5  // High priority - motor safety critical
 #define TASK_PRIORITY_NETWORK_CAMERA 3  // Medium priority - networking
 #define TASK_PRIORITY_LOGGING        1  // Low priority - can be delayed
+#define TASK_PRIORITY_CAMERA_CAPTURE 2  // Blocks on the sensor, then one memcpy
+#define TASK_PRIORITY_STREAM_SENDER  2  // Blocks in lwip send; below networking
 
 // ============================================================================
 // Task Stack Sizes
@@ -42,6 +54,8 @@
 #define TASK_STACK_CMD_CONTROL      4096   // 4KB for command processing
 #define TASK_STACK_NETWORK_CAMERA   8192   // 8KB for networking stack
 #define TASK_STACK_LOGGING          2048   // 2KB for logging
+#define TASK_STACK_CAMERA_CAPTURE   4096   // 4KB for capture + slot copy
+#define TASK_STACK_STREAM_SENDER    4096   // 4KB for httpd chunked sends
 
 // ============================================================================
 // Core Assignments
@@ -49,6 +63,8 @@
 #define TASK_CORE_CMD_CONTROL       1  // Core 1 - isolated from WiFi
 #define TASK_CORE_NETWORK_CAMERA    0  // Core 0 - ESP-IDF networking default
 #define TASK_CORE_LOGGING           1  // Core 1 - same as CMD_CONTROL but lower priority
+#define TASK_CORE_CAMERA_CAPTURE    1  // Core 1 - capture overlaps the send on Core 0
+#define TASK_CORE_STREAM_SENDER     0  // Core 0 - stream httpd + senders, next to TCP/IP
 
 // ============================================================================
 // Queue Definitions
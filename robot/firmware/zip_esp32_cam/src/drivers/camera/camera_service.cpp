@@ -31,6 +31,7 @@ static bool s_config_saved = false;
 static framesize_t s_saved_framesize = FRAMESIZE_VGA;
 static int s_saved_vflip = 0;
 static int s_saved_hmirror = 0;
+static uint32_t s_generation = 0;  // Successful inits + resumes
 
 
 // ============================================================================
@@ -243,6 +244,7 @@ bool camera_init() {
     
     s_status = CameraStatus::OK;
     s_error_message = "OK";
+    s_generation++;
     LOG_I("CAM", "Camera initialized successfully");
     
     return true;
@@ -260,6 +262,10 @@ CameraStatus camera_status() {
     return s_status;
 }
 
+uint32_t camera_generation() {
+    return s_generation;
+}
+
 const char* camera_last_error() {
     return s_error_message;
 }
@@ -427,6 +433,7 @@ bool camera_resume() {
     unsigned long resume_duration = millis() - resume_start;
     s_status = CameraStatus::OK;
     s_error_message = "OK";
+    s_generation++;
     LOG_I("CAM", "Camera resumed (reinit) successfully (took %lu ms)", resume_duration);
     
     return true;
@@ -53,6 +53,14 @@ bool camera_init();
  */
 bool camera_is_ok();
 
+/**
+ * Count of successful camera_init()/camera_resume() calls. A change means
+ * the sensor is back on its init frame size and quality.
+ * 
+ * @return Init generation (0 = never initialized)
+ */
+uint32_t camera_generation();
+
 /**
  * Get current camera status.
  * 
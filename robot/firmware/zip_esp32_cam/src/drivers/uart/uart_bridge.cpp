@@ -13,9 +13,13 @@
  * internal USB-CDC bridge logic on ESP32-S3.
  * 
  * This ensures reliable communication even when USB is connected or disconnected.
+ * 
+ * Link rate: starts at CONFIG_UART_BAUD and negotiates CONFIG_UART_BAUD_FAST
+ * with the UNO (N=124), see uart_link_tick().
  */
 
 #include "uart_bridge.h"
+#include "uart_ring.h"
 #include <Arduino.h>
 #include "board/board_esp32s3_elegoo_cam.h"
 #include "config/build_config.h"
@@ -30,52 +34,56 @@ static unsigned long s_boot_start_time = 0;
 static UartStats s_stats = {0, 0, 0, 0, 0, 0, 0, 0};
 
 // Ring buffer for RX data
-static uint8_t s_rx_buffer[CONFIG_UART_RX_BUFFER_SIZE];
-static volatile size_t s_rx_head = 0;
-static volatile size_t s_rx_tail = 0;
+static UartRing<CONFIG_UART_RX_BUFFER_SIZE> s_rx = {};
 
 // Frame parsing state
 static bool s_in_frame = false;
 static size_t s_frame_start = 0;
 
+// Link baud negotiation (N=124)
+enum LinkState : uint8_t {
+    LINK_IDLE,      // At CONFIG_UART_BAUD, next attempt after s_link_wait_ms
+    LINK_REQUEST,   // N=124 sent, waiting for {bd_ok}
+    LINK_PROBE,     // Switched, waiting for a {bp_<kbaud>} probe reply
+    LINK_FAST       // Confirmed at CONFIG_UART_BAUD_FAST
+};
+static const unsigned long LINK_REPLY_MS = 300;
+static const unsigned long LINK_PROBE_MS = 100;
+static const uint8_t LINK_PROBES = 3;
+static const unsigned long LINK_RETRY_MS = 30000;
+static const unsigned long LINK_SETTLE_MS = 1500;  // UNO boot / reset
+static const uint8_t LINK_GARBAGE_LIMIT = 16;
+
+static LinkState s_link_state = LINK_IDLE;
+static uint32_t s_link_baud = CONFIG_UART_BAUD;
+static unsigned long s_link_state_ts = 0;
+static unsigned long s_link_wait_ms = LINK_SETTLE_MS;
+static uint8_t s_link_probes = 0;
+static uint8_t s_link_garbage = 0;
+
 // ============================================================================
 // Ring Buffer Helpers
 // ============================================================================
 static inline size_t ring_buffer_count() {
-    if (s_rx_head >= s_rx_tail) {
-        return s_rx_head - s_rx_tail;
-    }
-    return CONFIG_UART_RX_BUFFER_SIZE - s_rx_tail + s_rx_head;
+    return s_rx.count();
 }
 
 static inline bool ring_buffer_full() {
-    return ring_buffer_count() >= (CONFIG_UART_RX_BUFFER_SIZE - 1);
+    return s_rx.full();
 }
 
 static inline void ring_buffer_push(uint8_t byte) {
-    size_t next = (s_rx_head + 1) % CONFIG_UART_RX_BUFFER_SIZE;
-    if (next != s_rx_tail) {
-        s_rx_buffer[s_rx_head] = byte;
-        s_rx_head = next;
-    } else {
+    if (!s_rx.push(byte)) {
         s_stats.buffer_overflows++;
     }
 }
 
 static inline int ring_buffer_pop() {
-    if (s_rx_head == s_rx_tail) {
-        return -1;
-    }
-    uint8_t byte = s_rx_buffer[s_rx_tail];
-    s_rx_tail = (s_rx_tail + 1) % CONFIG_UART_RX_BUFFER_SIZE;
-    return byte;
+    return s_rx.pop();
 }
 
 static inline int ring_buffer_peek() {
-    if (s_rx_head == s_rx_tail) {
-        return -1;
-    }
-    return s_rx_buffer[s_rx_tail];
+    return s_rx.peek();
 }
 
 // ============================================================================
@@ -104,6 +112,7 @@ bool uart_init() {
     
     s_initialized = true;
     s_boot_guard_expired = true;  // No boot guard needed for GPIO3
+    s_link_state_ts = millis();
     
     LOG_I("UART", "Serial1 (UART1) initialized on RX=GPIO%d TX=GPIO%d", 
           UART_RX_GPIO, UART_TX_GPIO);
@@ -127,6 +136,113 @@ bool uart_boot_guard_expired() {
     return s_boot_guard_expired;
 }
 
+// ============================================================================
+// Link Baud Negotiation (N=124)
+// ============================================================================
+// 1. @CONFIG_UART_BAUD: {"N":124,"H":"bd","D1":<kbaud>}  ->  {bd_ok}
+// 2. both ends switch; probe with {"N":124,"H":"bp","D1":0} (rate query)
+//    until {bp_<kbaud>} comes back - that also confirms the UNO side
+// No reply, no probe reply, or framing garbage once fast all drop back to
+// CONFIG_UART_BAUD. The UNO reverts by itself if no valid frame follows the
+// switch within 500ms, so both ends always meet again at the default rate.
+
+static void link_send(const char* line) {
+    size_t written = Serial1.print(line);
+    s_stats.tx_bytes += written;
+    s_stats.tx_frames++;
+    s_stats.last_tx_ts = millis();
+}
+
+static void link_set_baud(uint32_t baud) {
+    Serial1.flush();
+    Serial1.updateBaudRate(baud);
+    while (Serial1.available()) {
+        Serial1.read();  // Bytes that straddled the switch
+    }
+    s_link_baud = baud;
+    s_link_garbage = 0;
+}
+
+static void link_schedule(unsigned long wait_ms) {
+    s_link_state = LINK_IDLE;
+    s_link_state_ts = millis();
+    s_link_wait_ms = wait_ms;
+}
+
+static void link_fallback(const char* reason, unsigned long retry_ms) {
+    if (s_link_baud != CONFIG_UART_BAUD) {
+        link_set_baud(CONFIG_UART_BAUD);
+    }
+    LOG_W("UART", "Link at %d baud (%s), retry in %lu ms", CONFIG_UART_BAUD, reason, retry_ms);
+    link_schedule(retry_ms);
+}
+
+static void uart_link_tick() {
+#if CONFIG_UART_BAUD_FAST
+    unsigned long now = millis();
+    char line[48];
+    switch (s_link_state) {
+        case LINK_IDLE:
+            if (now - s_link_state_ts >= s_link_wait_ms) {
+                snprintf(line, sizeof(line), "{\"N\":124,\"H\":\"bd\",\"D1\":%lu}\n",
+                         (unsigned long)(CONFIG_UART_BAUD_FAST / 1000));
+                link_send(line);
+                s_link_state = LINK_REQUEST;
+                s_link_state_ts = now;
+            }
+            break;
+            
+        case LINK_REQUEST:
+            if (now - s_link_state_ts >= LINK_REPLY_MS) {
+                link_fallback("no N=124 reply", LINK_RETRY_MS);
+            }
+            break;
+            
+        case LINK_PROBE:
+            if (now - s_link_state_ts >= LINK_PROBE_MS) {
+                if (s_link_probes >= LINK_PROBES) {
+                    link_fallback("no probe reply", LINK_RETRY_MS);
+                    break;
+                }
+                link_send("{\"N\":124,\"H\":\"bp\",\"D1\":0}\n");
+                s_link_probes++;
+                s_link_state_ts = now;
+            }
+            break;
+            
+        case LINK_FAST:
+            break;
+    }
+#endif
+}
+
+// Returns true if the frame is a handshake reply (consumed here)
+static bool link_handle_frame(const char* frame) {
+    s_link_garbage = 0;  // A clean frame: the rate is right
+    
+    if (strncmp(frame, "{bd_", 4) == 0) {
+        if (s_link_state == LINK_REQUEST) {
+            if (strcmp(frame, "{bd_ok}") == 0) {
+                link_set_baud(CONFIG_UART_BAUD_FAST);
+                s_link_state = LINK_PROBE;
+                s_link_probes = 0;
+                s_link_state_ts = millis() - LINK_PROBE_MS;  // Probe right away
+            } else {
+                link_fallback("rate refused", LINK_RETRY_MS);
+            }
+        }
+        return true;
+    }
+    if (strncmp(frame, "{bp_", 4) == 0) {
+        if (s_link_state == LINK_PROBE && (uint32_t)atol(frame + 4) * 1000 == s_link_baud) {
+            s_link_state = LINK_FAST;
+            LOG_I("UART", "Link at %lu baud", (unsigned long)s_link_baud);
+        }
+        return true;
+    }
+    return false;
+}
+
 // ============================================================================
 // UART Tick (Main Loop Processing)
 // ============================================================================
@@ -161,6 +277,13 @@ void uart_tick() {
     while (Serial1.available() && !ring_buffer_full()) {
         int byte = Serial1.read();
         if (byte >= 0) {
+            // UNO talking at CONFIG_UART_BAUD while we listen fast (reset,
+            // or it timed out the switch): framing garbage
+            if (s_link_baud != CONFIG_UART_BAUD && (byte < 0x09 || byte > 0x7E) &&
+                ++s_link_garbage >= LINK_GARBAGE_LIMIT) {
+                link_fallback("rate mismatch", LINK_SETTLE_MS);
+                break;
+            }
             ring_buffer_push((uint8_t)byte);
             s_stats.rx_bytes++;
             s_stats.last_rx_ts = millis();
@@ -189,6 +312,8 @@ void uart_tick() {
             s_stats.tx_bytes++;
         }
     }
+#else
+    uart_link_tick();
 #endif
 }
 
@@ -200,6 +325,11 @@ size_t uart_tx(const uint8_t* data, size_t len) {
         return 0;
     }
     
+    // Mid-handshake: bytes sent now could reach the UNO after it switched
+    if (s_link_state == LINK_REQUEST) {
+        return 0;
+    }
+    
     size_t written = Serial1.write(data, len);
     s_stats.tx_bytes += written;
     s_stats.last_tx_ts = millis();
@@ -212,8 +342,17 @@ size_t uart_tx_string(const char* str) {
         return 0;
     }
     
+    // Link rate is owned by the bridge
+    if (strstr(str, "\"N\":124") != nullptr) {
+        LOG_W("UART", "N=124 from client ignored (bridge-managed)");
+        return 0;
+    }
+    
     size_t len = strlen(str);
     size_t written = uart_tx((const uint8_t*)str, len);
+    if (written == 0) {
+        return 0;
+    }
     
     // Add newline after JSON commands for Arduino compatibility
     if (len > 0 && str[len - 1] == '}') {
@@ -261,59 +400,15 @@ int uart_rx_peek() {
 // ============================================================================
 bool uart_frame_available() {
     // Scan buffer for complete frame (ends with })
-    size_t count = ring_buffer_count();
-    if (count == 0) {
-        return false;
-    }
-    
-    // Look for closing brace in buffer
-    for (size_t i = 0; i < count; i++) {
-        size_t idx = (s_rx_tail + i) % CONFIG_UART_RX_BUFFER_SIZE;
-        if (s_rx_buffer[idx] == '}') {
-            return true;
-        }
-    }
-    
-    return false;
+    return s_rx.has_frame();
 }
 
 size_t uart_read_frame(char* buffer, size_t max_len) {
-    if (!buffer || max_len == 0) {
-        return 0;
-    }
-    
-    size_t count = 0;
-    bool in_frame = false;
-    
-    while (count < (max_len - 1) && uart_rx_available() > 0) {
-        int byte = ring_buffer_peek();
-        if (byte < 0) {
-            break;
-        }
-        
-        if (byte == '{') {
-            in_frame = true;
-            count = 0;  // Reset on new frame start
-        }
-        
-        if (in_frame) {
-            ring_buffer_pop();
-            buffer[count++] = (char)byte;
-            
-            if (byte == '}') {
-                buffer[count] = '\0';
-                return count;
-            }
-        } else {
-            // Discard bytes outside of frame
-            ring_buffer_pop();
-            s_stats.framing_errors++;
-        }
+    size_t len = s_rx.read_frame(buffer, max_len, &s_stats.framing_errors);
+    if (len > 0 && link_handle_frame(buffer)) {
+        return 0;  // Handshake reply
     }
-    
-    // Incomplete frame
-    buffer[count] = '\0';
-    return 0;
+    return len;
 }
 
 // ============================================================================
@@ -336,7 +431,7 @@ int uart_get_tx_pin() {
 }
 
 uint32_t uart_get_baud_rate() {
-    return CONFIG_UART_BAUD;
+    return s_link_baud;  // CONFIG_UART_BAUD until N=124 negotiated faster
 }
 
 size_t uart_get_rx_buffer_size() {
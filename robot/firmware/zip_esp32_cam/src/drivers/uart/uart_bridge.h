@@ -69,7 +69,7 @@ bool uart_boot_guard_expired();
 
 /**
  * Process UART data (call from main loop).
- * Handles RX/TX buffering and frame parsing.
+ * Handles RX/TX buffering, frame parsing and the N=124 link rate handshake.
  */
 void uart_tick();
 
@@ -142,7 +142,8 @@ int uart_get_rx_pin();
 int uart_get_tx_pin();
 
 /**
- * Get the UART baud rate.
+ * Get the current UART baud rate (CONFIG_UART_BAUD, or
+ * CONFIG_UART_BAUD_FAST once negotiated with N=124).
  * 
  * @return Baud rate in bits per second
  */
@@ -172,7 +173,8 @@ bool uart_frame_available();
 
 /**
  * Read a complete JSON frame.
- * Reads characters until } is found.
+ * Reads characters until } is found. N=124 handshake replies ({bd_*},
+ * {bp_*}) are consumed here and return 0.
  * 
  * @param buffer Destination buffer
  * @param max_len Maximum bytes to read
@@ -0,0 +1,120 @@
+/**
+ * UART RX Ring Buffer - JSON Frame Extraction
+ *
+ * Byte ring and '{'..'}' frame scanner behind uart_frame_available() and
+ * uart_read_frame(). Header-only with no Arduino/ESP-IDF dependency so the
+ * host benchmark suite (zip_robot_uno env:native_bench) runs the exact same
+ * code as the firmware.
+ *
+ * Single producer (uart_tick) / single consumer (app loop), same task.
+ */
+
+#ifndef UART_RING_H
+#define UART_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+template <size_t N>
+struct UartRing {
+    uint8_t buf[N];
+    volatile size_t head;
+    volatile size_t tail;
+
+    void clear() {
+        head = 0;
+        tail = 0;
+    }
+
+    size_t count() const {
+        if (head >= tail) {
+            return head - tail;
+        }
+        return N - tail + head;
+    }
+
+    bool full() const {
+        return count() >= (N - 1);
+    }
+
+    // Returns false (byte dropped) when full
+    bool push(uint8_t byte) {
+        size_t next = (head + 1) % N;
+        if (next == tail) {
+            return false;
+        }
+        buf[head] = byte;
+        head = next;
+        return true;
+    }
+
+    int pop() {
+        if (head == tail) {
+            return -1;
+        }
+        uint8_t byte = buf[tail];
+        tail = (tail + 1) % N;
+        return byte;
+    }
+
+    int peek() const {
+        if (head == tail) {
+            return -1;
+        }
+        return buf[tail];
+    }
+
+    // True if a '}' is buffered (a complete frame may be waiting)
+    bool has_frame() const {
+        size_t n = count();
+        for (size_t i = 0; i < n; i++) {
+            if (buf[(tail + i) % N] == '}') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Pop one '{'..'}' frame into buffer (NUL-terminated).
+     * Bytes before the '{' are discarded and counted in *discarded.
+     * A second '{' restarts the frame. Returns 0 if no complete frame was
+     * found within max_len - 1 bytes (consumed bytes are not restored).
+     */
+    size_t read_frame(char* buffer, size_t max_len, uint32_t* discarded) {
+        if (!buffer || max_len == 0) {
+            return 0;
+        }
+
+        size_t len = 0;
+        bool in_frame = false;
+
+        while (len < (max_len - 1)) {
+            int byte = pop();
+            if (byte < 0) {
+                break;
+            }
+
+            if (byte == '{') {
+                in_frame = true;
+                len = 0;  // Reset on new frame start
+            }
+
+            if (in_frame) {
+                buffer[len++] = (char)byte;
+                if (byte == '}') {
+                    buffer[len] = '\0';
+                    return len;
+                }
+            } else if (discarded) {
+                (*discarded)++;
+            }
+        }
+
+        // Incomplete frame
+        buffer[len] = '\0';
+        return 0;
+    }
+};
+
+#endif // UART_RING_H
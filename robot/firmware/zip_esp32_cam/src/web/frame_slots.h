@@ -0,0 +1,108 @@
+/**
+ * Stream Frame Slots - Newest-Frame Handoff
+ *
+ * Bookkeeping for the ring of JPEG slots between the capture task (producer,
+ * Core 1) and the stream senders (Core 0). The producer fills a slot nobody is
+ * reading and publishes it as the newest; each sender takes the newest
+ * published slot, so a slow link skips frames instead of queueing them.
+ * readers is a refcount: senders on the same frame share one slot, and it
+ * is reused only once the last of them releases it. Each sender holds at
+ * most one slot, so with N >= senders + 2 the producer always finds one free.
+ *
+ * Header-only with no Arduino/ESP-IDF dependency so the host benchmark suite
+ * (zip_robot_uno env:native_bench) runs the exact same code as the firmware.
+ * Not thread-safe by itself: stream_pipeline.cpp calls it under a spinlock.
+ */
+
+#ifndef FRAME_SLOTS_H
+#define FRAME_SLOTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+template <size_t N>
+struct FrameSlots {
+    struct Slot {
+        uint32_t seq;      // Publish sequence (0 = never published)
+        uint32_t offset;   // First byte of the part in the slot buffer
+        uint32_t len;      // Part bytes (header + JPEG + boundary)
+        uint8_t readers;   // Senders holding the slot
+        bool writing;      // Being filled by the producer
+        bool taken;        // Taken by a sender since it was published
+    };
+
+    Slot slots[N];
+    int latest;            // Newest published slot (-1 = none yet)
+    uint32_t seq;
+    uint32_t published;
+    uint32_t skipped;      // Published, then reused without ever being sent
+
+    void clear() {
+        for (size_t i = 0; i < N; i++) {
+            slots[i] = Slot();
+        }
+        latest = -1;
+        seq = 0;
+        published = 0;
+        skipped = 0;
+    }
+
+    // Oldest slot that is not the newest and not held; -1 if none
+    int acquire_write() {
+        int best = -1;
+        for (size_t i = 0; i < N; i++) {
+            const Slot& s = slots[i];
+            if ((int)i == latest || s.readers != 0 || s.writing) {
+                continue;
+            }
+            if (best < 0 || s.seq < slots[best].seq) {
+                best = (int)i;
+            }
+        }
+        if (best >= 0) {
+            Slot& s = slots[best];
+            if (s.seq != 0 && !s.taken) {
+                skipped++;
+            }
+            s.writing = true;
+            s.seq = 0;
+        }
+        return best;
+    }
+
+    void publish(int i, uint32_t offset, uint32_t len) {
+        Slot& s = slots[i];
+        s.writing = false;
+        s.taken = false;
+        s.offset = offset;
+        s.len = len;
+        s.seq = ++seq;
+        latest = i;
+        published++;
+    }
+
+    // Producer dropped the frame (too big, copy failed)
+    void abort_write(int i) {
+        slots[i].writing = false;
+    }
+
+    // Newest slot if it is newer than after_seq (the caller's last frame),
+    // held until release(); -1 if there is nothing new
+    int acquire_latest(uint32_t after_seq) {
+        if (latest < 0 || slots[latest].seq <= after_seq) {
+            return -1;
+        }
+        Slot& s = slots[latest];
+        s.readers++;
+        s.taken = true;
+        return latest;
+    }
+
+    void release(int i) {
+        if (slots[i].readers > 0) {
+            slots[i].readers--;
+        }
+    }
+};
+
+#endif // FRAME_SLOTS_H
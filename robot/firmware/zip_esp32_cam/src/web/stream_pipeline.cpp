@@ -0,0 +1,602 @@
+/**
+ * Stream Pipeline - Implementation
+ *
+ * Capture task (producer) -> FrameSlots -> one sender per client.
+ * All slot bookkeeping happens under s_lock (a cross-core spinlock); the
+ * copies and sends run outside it, on slots the bookkeeping has reserved.
+ * A publish notifies every waiting sender task directly, so any number of
+ * clients wake on the same frame.
+ */
+
+#include "stream_pipeline.h"
+#include <Arduino.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+#include "config/build_config.h"
+#include "config/runtime_config.h"
+#include "app/task_architecture.h"
+#include "drivers/camera/camera_service.h"
+#include "frame_slots.h"
+
+// Rate window for the FPS figures
+#define STREAM_FPS_WINDOW_MS    1000
+
+// ============================================================================
+// Module State
+// ============================================================================
+static FrameSlots<CONFIG_STREAM_SLOTS> s_slots;
+static uint8_t* s_slot_buf[CONFIG_STREAM_SLOTS] = {};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_capture_task = NULL;
+static bool s_running = false;
+static uint32_t s_clients = 0;
+
+// ============================================================================
+// Frame Rate Meter
+// ============================================================================
+struct RateMeter {
+    uint32_t window_start;
+    uint32_t count;
+    uint32_t rate_x10;
+};
+
+static RateMeter s_sensor_rate = {0, 0, 0};
+static RateMeter s_send_rate = {0, 0, 0};
+
+// Call with s_lock held
+static void rate_tick(RateMeter& m, uint32_t now) {
+    m.count++;
+    uint32_t elapsed = now - m.window_start;
+    if (elapsed >= STREAM_FPS_WINDOW_MS) {
+        m.rate_x10 = m.count * 10000 / elapsed;
+        m.count = 0;
+        m.window_start = now;
+    }
+}
+
+// A meter that stopped ticking reads 0, not its last window
+static uint32_t rate_read(const RateMeter& m, uint32_t now) {
+    return (now - m.window_start > 2 * STREAM_FPS_WINDOW_MS) ? 0 : m.rate_x10;
+}
+
+static StreamStats s_stats = {};
+
+// ============================================================================
+// Stream Clients
+// ============================================================================
+struct StreamClient {
+    bool active;
+    TaskHandle_t waiter;        // Sender task to notify on publish
+    uint32_t last_seq;          // Newest frame this client has taken
+    RateMeter rate;
+    uint32_t win_send_ms;       // Adapt window: time spent sending
+    uint32_t win_sends;
+    uint32_t win_bytes;
+};
+
+static StreamClient s_client[CONFIG_STREAM_MAX_CLIENTS] = {};
+
+// Wake every client's sender; handles are copied out so the notifies run
+// outside the spinlock
+static void notify_clients() {
+    TaskHandle_t waiters[CONFIG_STREAM_MAX_CLIENTS];
+    int count = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        if (s_client[i].active && s_client[i].waiter) {
+            waiters[count++] = s_client[i].waiter;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    for (int i = 0; i < count; i++) {
+        xTaskNotifyGive(waiters[i]);
+    }
+}
+
+// ============================================================================
+// Adaptive Quality (quality first, then frame size)
+// ============================================================================
+
+// Best first. Quality steps down before each frame size step; the first
+// quality at a smaller size still gives smaller frames than the last level.
+// bytes_pct is a rough frame size vs level 0, only used to predict a step up.
+// Level 0 is what camera_init() configures with PSRAM.
+struct AdaptLevel {
+    framesize_t framesize;
+    const char* name;
+    uint8_t quality;
+    uint8_t bytes_pct;
+};
+
+static const AdaptLevel ADAPT_LADDER[] = {
+    { FRAMESIZE_VGA,  "VGA",  CONFIG_JPEG_QUALITY_PSRAM, 100 },
+    { FRAMESIZE_VGA,  "VGA",  15, 75 },
+    { FRAMESIZE_VGA,  "VGA",  20, 60 },
+    { FRAMESIZE_VGA,  "VGA",  30, 45 },
+    { FRAMESIZE_HVGA, "HVGA", 20, 30 },
+    { FRAMESIZE_HVGA, "HVGA", 30, 22 },
+    { FRAMESIZE_QVGA, "QVGA", 20, 15 },
+    { FRAMESIZE_QVGA, "QVGA", 30, 11 },
+};
+
+#define ADAPT_LEVELS ((int)(sizeof(ADAPT_LADDER) / sizeof(ADAPT_LADDER[0])))
+#define ADAPT_BUDGET_MS (1000 / CONFIG_STREAM_TARGET_FPS)
+
+struct AdaptState {
+    int level;
+    uint32_t window_start;
+    uint32_t win_frames;        // Captured this window
+    uint32_t win_frame_bytes;
+    uint32_t win_stalls;
+    uint8_t over;               // Consecutive windows over DEGRADE_PCT
+    uint8_t under;              // Consecutive windows under UPGRADE_PCT
+    uint32_t camera_gen;        // camera_generation() the level was applied to
+};
+
+static AdaptState s_adapt = {};
+static StreamAdaptStats s_adapt_stats = {};
+
+#if ENABLE_STREAM_ADAPT
+// Move the sensor to a ladder level; called from the capture task only,
+// between captures
+static bool adapt_apply(int level) {
+    const AdaptLevel& from = ADAPT_LADDER[s_adapt.level];
+    const AdaptLevel& to = ADAPT_LADDER[level];
+    // Both every time: adapt_sync() re-applies a level to a sensor that a
+    // camera re-init put back on level 0 settings
+    bool ok = camera_set_framesize(to.framesize) && camera_set_quality(to.quality);
+    if (!ok) {
+        LOG_W("STREAM", "Adapt: sensor rejected %s q%d", to.name, to.quality);
+        return false;
+    }
+    LOG_I("STREAM", "Adapt: %s q%d -> %s q%d (%s)",
+          from.name, from.quality, to.name, to.quality, s_adapt_stats.last_reason);
+    s_adapt.level = level;
+    return true;
+}
+#endif
+
+// Keep the sensor and the ladder in step, once per capture loop pass. Idle:
+// back to level 0, so the next viewer starts at full quality instead of
+// wherever the last one left it. Streaming: a camera re-init put the sensor
+// back on level 0 settings, so re-apply the current level.
+static void adapt_sync(bool idle, uint32_t now) {
+#if ENABLE_STREAM_ADAPT
+    if (!camera_is_ok()) {
+        return;
+    }
+    uint32_t gen = camera_generation();
+    bool reinit = (gen != s_adapt.camera_gen);
+    s_adapt.camera_gen = gen;
+    if (s_adapt.level == 0) {
+        return;
+    }
+
+    if (idle) {
+        s_adapt_stats.last_reason = "idle";
+        if (reinit) {
+            s_adapt.level = 0;  // Already there
+        } else if (!adapt_apply(0)) {
+            return;
+        }
+    } else if (reinit) {
+        s_adapt_stats.last_reason = "reinit";
+        if (!adapt_apply(s_adapt.level)) {
+            s_adapt.level = 0;  // Sensor refused: it stays on init settings
+        }
+    } else {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_adapt_stats.level = s_adapt.level;
+    s_adapt_stats.last_change_ms = now;
+    portEXIT_CRITICAL(&s_lock);
+#else
+    (void)idle;
+    (void)now;
+#endif
+}
+
+// No clients: the next window starts from nothing
+static void adapt_idle(uint32_t now) {
+    portENTER_CRITICAL(&s_lock);
+    s_adapt.window_start = now;
+    s_adapt.win_frames = 0;
+    s_adapt.win_frame_bytes = 0;
+    s_adapt.win_stalls = 0;
+    s_adapt.over = 0;
+    s_adapt.under = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// Once per window while clients are connected: judge the slowest client
+static void adapt_tick(uint32_t now) {
+#if ENABLE_STREAM_ADAPT
+    if (now - s_adapt.window_start < CONFIG_STREAM_ADAPT_WINDOW_MS) {
+        return;
+    }
+
+    // Collect and reset the window
+    uint32_t worst_avg_ms = 0;
+    uint32_t worst_send_ms = 0;
+    uint32_t worst_bytes = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        StreamClient& c = s_client[i];
+        if (c.active && c.win_sends > 0) {
+            uint32_t avg = c.win_send_ms / c.win_sends;
+            if (avg >= worst_avg_ms) {
+                worst_avg_ms = avg;
+                worst_send_ms = c.win_send_ms;
+                worst_bytes = c.win_bytes;
+            }
+        }
+        c.win_send_ms = 0;
+        c.win_sends = 0;
+        c.win_bytes = 0;
+    }
+    uint32_t frames = s_adapt.win_frames;
+    uint32_t frame_bytes = s_adapt.win_frame_bytes;
+    uint32_t stalls = s_adapt.win_stalls;
+    s_adapt.win_frames = 0;
+    s_adapt.win_frame_bytes = 0;
+    s_adapt.win_stalls = 0;
+    portEXIT_CRITICAL(&s_lock);
+    s_adapt.window_start = now;
+
+    if (worst_bytes == 0 || frames == 0) {
+        // Nothing sent - no evidence either way
+        s_adapt.over = 0;
+        s_adapt.under = 0;
+        return;
+    }
+
+    uint32_t avg_frame = frame_bytes / frames;
+    uint32_t pressure = worst_avg_ms * 100 / ADAPT_BUDGET_MS;
+
+    // Next level up: its frame bytes at the slowest client's link rate
+    uint32_t predicted = 0;
+    if (s_adapt.level > 0) {
+        uint32_t next_bytes = avg_frame * ADAPT_LADDER[s_adapt.level - 1].bytes_pct /
+                              ADAPT_LADDER[s_adapt.level].bytes_pct;
+        uint32_t next_ms = (uint32_t)((uint64_t)next_bytes * worst_send_ms / worst_bytes);
+        predicted = next_ms * 100 / ADAPT_BUDGET_MS;
+    }
+
+    s_adapt.over = (pressure > CONFIG_STREAM_ADAPT_DEGRADE_PCT) ? s_adapt.over + 1 : 0;
+    s_adapt.under = (s_adapt.level > 0 && predicted < CONFIG_STREAM_ADAPT_UPGRADE_PCT &&
+                     stalls == 0) ? s_adapt.under + 1 : 0;
+
+    int level = s_adapt.level;
+    const char* reason = NULL;
+    if (stalls > 0 && level + 1 < ADAPT_LEVELS) {
+        level++;
+        reason = "stall";
+    } else if (s_adapt.over >= CONFIG_STREAM_ADAPT_DEGRADE_WINDOWS && level + 1 < ADAPT_LEVELS) {
+        level++;
+        reason = "slow_send";
+    } else if (s_adapt.under >= CONFIG_STREAM_ADAPT_UPGRADE_WINDOWS) {
+        level--;
+        reason = "headroom";
+    }
+
+    bool changed = false;
+    if (reason) {
+        s_adapt_stats.last_reason = reason;
+        changed = adapt_apply(level);
+        // Judge the new level on fresh windows only
+        s_adapt.over = 0;
+        s_adapt.under = 0;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_adapt_stats.pressure_pct = pressure;
+    s_adapt_stats.predicted_pct = predicted;
+    s_adapt_stats.avg_frame_bytes = avg_frame;
+    s_adapt_stats.stalls += stalls;
+    if (changed) {
+        if ((uint32_t)level > s_adapt_stats.level) {
+            s_adapt_stats.degrades++;
+        } else {
+            s_adapt_stats.upgrades++;
+        }
+        s_adapt_stats.level = level;
+        s_adapt_stats.last_change_ms = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+#else
+    (void)now;
+#endif
+}
+
+// ============================================================================
+// Capture Task (Producer)
+// ============================================================================
+
+// Copy one camera frame into a slot as a complete multipart part:
+// [unused][part header][JPEG][boundary], header right-aligned against the
+// JPEG so the sender can send it all from one pointer.
+static bool fill_slot(int slot, const camera_fb_t* fb, uint32_t* offset, uint32_t* len) {
+    const size_t boundary_len = sizeof(STREAM_BOUNDARY_LINE) - 1;
+    if (STREAM_PART_HEADER_MAX + fb->len + boundary_len > CONFIG_STREAM_SLOT_BYTES) {
+        return false;
+    }
+
+    char header[STREAM_PART_HEADER_MAX];
+    int hlen = snprintf(header, sizeof(header), STREAM_PART_HEADER_FMT, (unsigned)fb->len);
+    if (hlen <= 0 || hlen >= (int)sizeof(header)) {
+        return false;
+    }
+
+    uint8_t* buf = s_slot_buf[slot];
+    uint32_t start = STREAM_PART_HEADER_MAX - hlen;
+    memcpy(buf + start, header, hlen);
+    memcpy(buf + STREAM_PART_HEADER_MAX, fb->buf, fb->len);
+    memcpy(buf + STREAM_PART_HEADER_MAX + fb->len, STREAM_BOUNDARY_LINE, boundary_len);
+
+    *offset = start;
+    *len = hlen + fb->len + boundary_len;
+    return true;
+}
+
+static void task_camera_capture(void* pvParameters) {
+    esp_task_wdt_add(NULL);
+    LOG_I("STREAM", "Capture task started on core %d", xPortGetCoreID());
+
+    while (1) {
+        esp_task_wdt_reset();
+
+        // Idle until a client attaches (woken by stream_client_attach)
+        if (s_clients == 0 || !camera_is_ok()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+            adapt_idle(millis());
+            adapt_sync(true, millis());
+            continue;
+        }
+
+        adapt_sync(false, millis());
+
+        camera_fb_t* fb = camera_capture();
+        if (!fb) {
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
+        }
+
+        uint32_t now = millis();
+        portENTER_CRITICAL(&s_lock);
+        rate_tick(s_sensor_rate, now);
+        int slot = s_slots.acquire_write();
+        portEXIT_CRITICAL(&s_lock);
+
+        if (slot < 0) {
+            // Every slot held - cannot happen with CONFIG_STREAM_SLOTS >=
+            // clients + 2, kept as a guard
+            camera_return_frame(fb);
+            continue;
+        }
+
+        int64_t copy_start = esp_timer_get_time();
+        uint32_t offset = 0;
+        uint32_t len = 0;
+        uint32_t frame_bytes = fb->len;
+        bool ok = fill_slot(slot, fb, &offset, &len);
+        uint32_t copy_us = (uint32_t)(esp_timer_get_time() - copy_start);
+        camera_return_frame(fb);  // Sensor refills it while we publish/send
+
+        portENTER_CRITICAL(&s_lock);
+        s_adapt.win_frames++;
+        s_adapt.win_frame_bytes += frame_bytes;
+        if (ok) {
+            s_slots.publish(slot, offset, len);
+            s_stats.captured++;
+            s_stats.last_copy_us = copy_us;
+        } else {
+            s_slots.abort_write(slot);
+            s_stats.oversize++;
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (ok) {
+            notify_clients();
+        }
+        adapt_tick(now);
+    }
+}
+
+// ============================================================================
+// Pipeline Interface
+// ============================================================================
+bool stream_pipeline_init() {
+    if (s_running) {
+        return true;
+    }
+    if (!psramFound()) {
+        LOG_W("STREAM", "No PSRAM - streaming without pipeline");
+        return false;
+    }
+
+    for (int i = 0; i < CONFIG_STREAM_SLOTS; i++) {
+        if (!s_slot_buf[i]) {
+            s_slot_buf[i] = (uint8_t*)heap_caps_malloc(CONFIG_STREAM_SLOT_BYTES,
+                                                       MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        }
+        if (!s_slot_buf[i]) {
+            LOG_E("STREAM", "Slot %d allocation failed (%u bytes)", i, (unsigned)CONFIG_STREAM_SLOT_BYTES);
+            return false;
+        }
+    }
+
+    s_slots.clear();
+
+    xTaskCreatePinnedToCore(
+        task_camera_capture,
+        "cam_capture",
+        TASK_STACK_CAMERA_CAPTURE,
+        NULL,
+        TASK_PRIORITY_CAMERA_CAPTURE,
+        &s_capture_task,
+        TASK_CORE_CAMERA_CAPTURE
+    );
+    if (!s_capture_task) {
+        LOG_E("STREAM", "Failed to create capture task");
+        return false;
+    }
+
+    s_running = true;
+    LOG_I("STREAM", "Pipeline ready: %d slots x %u bytes in PSRAM",
+          CONFIG_STREAM_SLOTS, (unsigned)CONFIG_STREAM_SLOT_BYTES);
+    return true;
+}
+
+bool stream_pipeline_ok() {
+    return s_running;
+}
+
+int stream_client_attach() {
+    uint32_t now = millis();
+    int client = -1;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        if (!s_client[i].active) {
+            client = i;
+            break;
+        }
+    }
+    if (client >= 0) {
+        StreamClient& c = s_client[client];
+        c.active = true;
+        c.waiter = NULL;
+        c.last_seq = 0;
+        c.rate.window_start = now;
+        c.rate.count = 0;
+        c.rate.rate_x10 = 0;
+        c.win_send_ms = 0;
+        c.win_sends = 0;
+        c.win_bytes = 0;
+        s_clients++;
+    } else {
+        s_stats.rejected++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (client < 0) {
+        LOG_W("STREAM", "Client rejected: %d already streaming", CONFIG_STREAM_MAX_CLIENTS);
+    } else if (s_capture_task) {
+        xTaskNotifyGive(s_capture_task);
+    }
+    return client;
+}
+
+void stream_client_detach(int client) {
+    if (client < 0 || client >= CONFIG_STREAM_MAX_CLIENTS) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    if (s_client[client].active) {
+        s_client[client].active = false;
+        s_client[client].waiter = NULL;
+        s_clients--;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool stream_wait_frame(int client, StreamFrame* frame, uint32_t timeout_ms) {
+    if (client < 0 || client >= CONFIG_STREAM_MAX_CLIENTS) {
+        return false;
+    }
+    StreamClient& c = s_client[client];
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    uint32_t start = millis();
+    while (1) {
+        // Registering and checking under one lock: a publish after the
+        // check leaves a pending notify, so the take below returns at once
+        portENTER_CRITICAL(&s_lock);
+        c.waiter = self;
+        int slot = s_slots.acquire_latest(c.last_seq);
+        if (slot >= 0) {
+            frame->slot = slot;
+            frame->seq = s_slots.slots[slot].seq;
+            frame->len = s_slots.slots[slot].len;
+            frame->data = s_slot_buf[slot] + s_slots.slots[slot].offset;
+            if (c.last_seq != 0) {
+                s_stats.dropped += frame->seq - c.last_seq - 1;
+            }
+            c.last_seq = frame->seq;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        if (slot >= 0) {
+            return true;
+        }
+
+        uint32_t waited = millis() - start;
+        if (waited >= timeout_ms) {
+            return false;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms - waited));
+    }
+}
+
+void stream_release_frame(const StreamFrame* frame) {
+    portENTER_CRITICAL(&s_lock);
+    s_slots.release(frame->slot);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void stream_note_sent(int client, uint32_t send_ms, uint32_t bytes) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&s_lock);
+    rate_tick(s_send_rate, now);
+    if (client >= 0 && client < CONFIG_STREAM_MAX_CLIENTS) {
+        StreamClient& c = s_client[client];
+        rate_tick(c.rate, now);
+        c.win_send_ms += send_ms;
+        c.win_sends++;
+        c.win_bytes += bytes;
+    }
+    if (send_ms * 100 > (uint32_t)ADAPT_BUDGET_MS * CONFIG_STREAM_ADAPT_STALL_PCT) {
+        s_adapt.win_stalls++;
+    }
+    s_stats.sent++;
+    s_stats.last_send_ms = send_ms;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+StreamStats stream_get_stats() {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&s_lock);
+    StreamStats stats = s_stats;
+    stats.skipped = s_slots.skipped;
+    stats.clients = s_clients;
+    stats.sensor_fps_x10 = rate_read(s_sensor_rate, now);
+    stats.stream_fps_x10 = rate_read(s_send_rate, now);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        stats.client_fps_x10[i] = s_client[i].active ? rate_read(s_client[i].rate, now) : 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    stats.pipelined = s_running;
+    stats.max_clients = CONFIG_STREAM_MAX_CLIENTS;
+    stats.slot_bytes = CONFIG_STREAM_SLOT_BYTES;
+    stats.slots = CONFIG_STREAM_SLOTS;
+    return stats;
+}
+
+StreamAdaptStats stream_get_adapt_stats() {
+    portENTER_CRITICAL(&s_lock);
+    StreamAdaptStats stats = s_adapt_stats;
+    portEXIT_CRITICAL(&s_lock);
+    const AdaptLevel& level = ADAPT_LADDER[stats.level];
+    stats.enabled = ENABLE_STREAM_ADAPT && s_running;
+    stats.levels = ADAPT_LEVELS;
+    stats.quality = level.quality;
+    stats.framesize = level.name;
+    stats.target_fps = CONFIG_STREAM_TARGET_FPS;
+    if (!stats.last_reason) {
+        stats.last_reason = "none";
+    }
+    return stats;
+}
@@ -0,0 +1,149 @@
+/**
+ * Stream Pipeline - Interface
+ *
+ * Overlaps sensor capture with the WiFi send of the MJPEG stream:
+ *   - Capture task (Core 1) pulls each frame from the sensor, copies it into
+ *     a PSRAM slot between a pre-rendered part header and the boundary, and
+ *     hands the camera buffer straight back to the driver.
+ *   - Each stream client's sender (Core 0) sends the newest slot as one
+ *     chunk. Clients showing the same frame share its slot (refcounted).
+ * The sensor keeps running while a frame is on the air. Each client skips
+ * to the newest frame rather than falling behind, so a slow viewer costs
+ * its own frame rate, not the sensor's or the other viewers'.
+ *
+ * While clients are connected the capture task also steps JPEG quality,
+ * then frame size, down when the slowest client cannot hold
+ * CONFIG_STREAM_TARGET_FPS, and back up once the link has headroom
+ * (ENABLE_STREAM_ADAPT).
+ *
+ * Needs PSRAM for the slots; without it stream_pipeline_ok() is false and
+ * the stream handler captures inline as before.
+ */
+
+#ifndef STREAM_PIPELINE_H
+#define STREAM_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config/runtime_config.h"
+
+// ============================================================================
+// MJPEG Multipart Framing
+// ============================================================================
+#define STREAM_PART_BOUNDARY    "123456789000000000000987654321"
+#define STREAM_BOUNDARY_LINE    "\r\n--" STREAM_PART_BOUNDARY "\r\n"
+#define STREAM_PART_HEADER_FMT  "Content-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n"
+#define STREAM_PART_HEADER_MAX  64   // Reserved in front of the JPEG in a slot
+
+// ============================================================================
+// Stream Statistics
+// ============================================================================
+struct StreamStats {
+    bool pipelined;             // Slots allocated, capture task running
+    uint32_t clients;           // Stream clients connected
+    uint32_t max_clients;
+    uint32_t rejected;          // Clients turned away (max_clients streaming)
+    uint32_t sensor_fps_x10;    // Frames from the sensor per second (x10)
+    uint32_t stream_fps_x10;    // Frames sent per second, all clients (x10)
+    uint32_t client_fps_x10[CONFIG_STREAM_MAX_CLIENTS];  // Per client (0 = idle)
+    uint32_t captured;          // Frames copied into a slot
+    uint32_t sent;              // Frames sent, all clients
+    uint32_t skipped;           // Captured but superseded before any send
+    uint32_t dropped;           // Frames clients jumped over to stay newest
+    uint32_t oversize;          // Dropped: larger than a slot
+    uint32_t last_copy_us;      // Slot copy time of the last frame
+    uint32_t last_send_ms;      // Send time of the last frame
+    uint32_t slot_bytes;
+    uint32_t slots;
+};
+
+// Adaptive quality state and decisions
+struct StreamAdaptStats {
+    bool enabled;
+    uint32_t level;             // 0 = best (VGA, CONFIG_JPEG_QUALITY_PSRAM)
+    uint32_t levels;
+    uint32_t quality;           // JPEG quality in use (lower = better)
+    const char* framesize;      // "VGA", "HVGA", "QVGA"
+    uint32_t target_fps;
+    uint32_t pressure_pct;      // Slowest client's mean send time vs budget
+    uint32_t predicted_pct;     // Same, predicted for the next level up
+    uint32_t avg_frame_bytes;   // Mean frame size, last window
+    uint32_t stalls;            // Sends over CONFIG_STREAM_ADAPT_STALL_PCT
+    uint32_t degrades;
+    uint32_t upgrades;
+    const char* last_reason;    // "none", "stall", "slow_send", "headroom", "idle", "reinit"
+    uint32_t last_change_ms;    // millis() of the last step (0 = never)
+};
+
+// A published slot, held by the caller until stream_release_frame()
+struct StreamFrame {
+    const uint8_t* data;        // Part header + JPEG + boundary
+    uint32_t len;
+    uint32_t seq;
+    int slot;
+};
+
+// ============================================================================
+// Stream Pipeline Interface
+// ============================================================================
+
+/**
+ * Allocate the PSRAM slots and start the capture task.
+ * Safe to call more than once.
+ *
+ * @return true if the pipeline is running
+ */
+bool stream_pipeline_init();
+
+/**
+ * Check if the pipeline is running (false without PSRAM).
+ */
+bool stream_pipeline_ok();
+
+/**
+ * Register a stream client. Capture runs only while at least one client is
+ * attached.
+ *
+ * @return Client id, or -1 if CONFIG_STREAM_MAX_CLIENTS are streaming
+ */
+int stream_client_attach();
+
+/**
+ * Unregister a client from stream_client_attach().
+ */
+void stream_client_detach(int client);
+
+/**
+ * Wait for a frame newer than the client's last one. Frames published
+ * meanwhile are skipped (drop-to-latest). The calling task is woken by
+ * the capture task, so call it from the task that sends for this client.
+ *
+ * @param client Id from stream_client_attach()
+ * @param frame Filled in on success; release with stream_release_frame()
+ * @param timeout_ms Maximum wait
+ * @return true if a frame is held
+ */
+bool stream_wait_frame(int client, StreamFrame* frame, uint32_t timeout_ms);
+
+/**
+ * Release a frame from stream_wait_frame().
+ */
+void stream_release_frame(const StreamFrame* frame);
+
+/**
+ * Record one completed send for a client (stream FPS, send time, and the
+ * link-rate sample for adaptive quality).
+ */
+void stream_note_sent(int client, uint32_t send_ms, uint32_t bytes);
+
+/**
+ * Get pipeline statistics.
+ */
+StreamStats stream_get_stats();
+
+/**
+ * Get adaptive quality state.
+ */
+StreamAdaptStats stream_get_adapt_stats();
+
+#endif // STREAM_PIPELINE_H
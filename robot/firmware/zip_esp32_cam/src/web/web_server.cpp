@@ -11,12 +11,16 @@
 #include "esp_camera.h"
 #include "esp_task_wdt.h"
 #include "esp_err.h"
+#include "esp_idf_version.h"
+#include "lwip/sockets.h"
 #include <string.h>
 #include "config/build_config.h"
 #include "config/runtime_config.h"
 #include "drivers/camera/camera_service.h"
 #include "drivers/uart/uart_bridge.h"
 #include "net/net_service.h"
+#include "app/task_architecture.h"
+#include "stream_pipeline.h"
 
 // ============================================================================
 // Module State
@@ -29,10 +33,18 @@ static const char* s_error_message = "Not initialized";
 // ============================================================================
 // Stream Constants (MJPEG multipart)
 // ============================================================================
-#define PART_BOUNDARY "123456789000000000000987654321"
-static const char* STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" PART_BOUNDARY;
-static const char* STREAM_BOUNDARY = "\r\n--" PART_BOUNDARY "\r\n";
-static const char* STREAM_PART = "Content-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n";
+static const char* STREAM_CONTENT_TYPE = "multipart/x-mixed-replace;boundary=" STREAM_PART_BOUNDARY;
+static const char* STREAM_BOUNDARY = STREAM_BOUNDARY_LINE;
+static const char* STREAM_PART = STREAM_PART_HEADER_FMT;
+
+// Each stream client is handed to its own sender task so the httpd worker is
+// free for the next one. ESP-IDF 5.1+ does that with httpd async requests;
+// older IDF (the pinned 4.4) hands over the socket itself.
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#define STREAM_ASYNC_HANDLERS 1
+#else
+#define STREAM_ASYNC_HANDLERS 0
+#endif
 
 // ============================================================================
 // Index Handler (/)
@@ -81,6 +93,239 @@ static esp_err_t capture_handler(httpd_req_t *req) {
 // Stream Handler (/stream) - Port 81
 // ============================================================================
 #if ENABLE_STREAM
+// Pipelined: the capture task fills PSRAM slots on Core 1 while this sends
+// the newest one (header + JPEG + boundary) with one send_part call.
+// Detaches the client when the connection ends.
+typedef bool (*StreamSendPart)(void* ctx, const uint8_t* data, size_t len);
+
+static esp_err_t stream_send_frames(int client, StreamSendPart send_part, void* ctx) {
+    esp_err_t res = ESP_OK;
+    while (res == ESP_OK) {
+        esp_task_wdt_reset();
+        
+        StreamFrame frame;
+        if (!stream_wait_frame(client, &frame, CONFIG_STREAM_FRAME_TIMEOUT_MS)) {
+            if (!camera_is_ok()) {
+                LOG_W("WEB", "Stream stopped: camera %s", camera_last_error());
+                res = ESP_FAIL;
+            }
+            continue;
+        }
+        
+        unsigned long start = millis();
+        bool ok = send_part(ctx, frame.data, frame.len);
+        stream_release_frame(&frame);
+        if (ok) {
+            stream_note_sent(client, millis() - start, frame.len);
+        } else {
+            res = ESP_FAIL;
+        }
+    }
+    stream_client_detach(client);
+    
+    return res;
+}
+
+static bool stream_send_chunk(void* ctx, const uint8_t* data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t*)ctx, (const char*)data, len) == ESP_OK;
+}
+
+// Through httpd (chunked), on whichever task holds the request
+static esp_err_t stream_send_pipelined(httpd_req_t *req, int client) {
+    esp_err_t res = httpd_resp_set_type(req, STREAM_CONTENT_TYPE);
+    if (res != ESP_OK) {
+        stream_client_detach(client);
+        return res;
+    }
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return stream_send_frames(client, stream_send_chunk, req);
+}
+
+struct StreamJob {
+#if STREAM_ASYNC_HANDLERS
+    httpd_req_t* req;           // From httpd_req_async_handler_begin()
+#else
+    int fd;                     // Socket claimed from httpd
+#endif
+    int client;
+};
+
+static QueueHandle_t s_stream_jobs = NULL;
+static bool s_senders_ok = false;       // Every sender task is running
+
+#if !STREAM_ASYNC_HANDLERS
+// Socket handoff (IDF < 5.1, no async requests): the handler claims the
+// session's socket, asks httpd to delete the session and returns without a
+// response. httpd closes sockets only through stream_sock_close(), which
+// skips a claimed one and queues it to a sender instead. So the session
+// leaves httpd's table (no more select(), LRU purge or request parsing on
+// it) before any sender touches the socket, and the sender owns it from
+// then on: it writes the whole response with send() and closes it. The
+// delete is queued work, which the server loop runs before it looks at
+// session sockets again, so httpd never reads a claimed socket.
+static StreamJob s_claimed[CONFIG_STREAM_MAX_CLIENTS];  // fd -1 = free
+static portMUX_TYPE s_claim_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int stream_sock_claim(int fd, int client) {
+    int slot = -1;
+    portENTER_CRITICAL(&s_claim_lock);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        if (s_claimed[i].fd < 0) {
+            s_claimed[i].fd = fd;
+            s_claimed[i].client = client;
+            slot = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_claim_lock);
+    return slot;
+}
+
+// Frees the claim on fd; false if it was not claimed
+static bool stream_sock_unclaim(int fd, StreamJob* job) {
+    bool claimed = false;
+    portENTER_CRITICAL(&s_claim_lock);
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        if (s_claimed[i].fd == fd) {
+            *job = s_claimed[i];
+            s_claimed[i].fd = -1;
+            claimed = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_claim_lock);
+    return claimed;
+}
+
+// httpd close_fn for the stream server: runs on the httpd task as it drops
+// the session, so this is where a claimed socket changes hands
+static void stream_sock_close(httpd_handle_t hd, int fd) {
+    (void)hd;
+    StreamJob job;
+    if (!stream_sock_unclaim(fd, &job)) {
+        close(fd);
+        return;
+    }
+    // One sender per client slot, so this only fails if one died
+    if (xQueueSend(s_stream_jobs, &job, 0) != pdTRUE) {
+        LOG_W("WEB", "No stream sender for fd %d", fd);
+        stream_client_detach(job.client);
+        close(fd);
+    }
+}
+
+static bool stream_send_sock(void* ctx, const uint8_t* data, size_t len) {
+    int fd = *(const int*)ctx;
+    while (len > 0) {
+        int n = send(fd, data, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;  // Peer gone, or SO_SNDTIMEO (httpd send_wait_timeout)
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+static void stream_send_socket(int fd, int client) {
+    static const char HEADER[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: multipart/x-mixed-replace;boundary=" STREAM_PART_BOUNDARY "\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        STREAM_BOUNDARY_LINE;
+    if (stream_send_sock(&fd, (const uint8_t*)HEADER, sizeof(HEADER) - 1)) {
+        stream_send_frames(client, stream_send_sock, &fd);
+    } else {
+        stream_client_detach(client);
+    }
+    close(fd);
+}
+#endif
+
+// One per client slot: streams a handed-off client until it disconnects
+static void task_stream_sender(void* pvParameters) {
+    StreamJob job;
+    while (1) {
+        if (xQueueReceive(s_stream_jobs, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        esp_task_wdt_add(NULL);  // Only while streaming; idle blocks forever
+#if STREAM_ASYNC_HANDLERS
+        stream_send_pipelined(job.req, job.client);
+        httpd_req_async_handler_complete(job.req);
+#else
+        stream_send_socket(job.fd, job.client);
+#endif
+        esp_task_wdt_delete(NULL);
+    }
+}
+
+static bool stream_senders_start() {
+#if !STREAM_ASYNC_HANDLERS
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        s_claimed[i].fd = -1;
+    }
+#endif
+    s_stream_jobs = xQueueCreate(CONFIG_STREAM_MAX_CLIENTS, sizeof(StreamJob));
+    if (!s_stream_jobs) {
+        return false;
+    }
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        BaseType_t ok = xTaskCreatePinnedToCore(
+            task_stream_sender,
+            "stream_send",
+            TASK_STACK_STREAM_SENDER,
+            NULL,
+            TASK_PRIORITY_STREAM_SENDER,
+            NULL,
+            TASK_CORE_STREAM_SENDER
+        );
+        if (ok != pdPASS) {
+            LOG_E("WEB", "Failed to create stream sender %d", i);
+            return false;
+        }
+    }
+    s_senders_ok = true;
+    return true;
+}
+
+// Hand a client to a sender task; a free one always exists, as each
+// attached client occupies exactly one. False: serve it from this worker.
+static bool stream_hand_off(httpd_req_t *req, int client) {
+    if (!s_senders_ok) {
+        return false;
+    }
+#if STREAM_ASYNC_HANDLERS
+    httpd_req_t* async_req = NULL;
+    if (httpd_req_async_handler_begin(req, &async_req) != ESP_OK) {
+        return false;
+    }
+    StreamJob job = { async_req, client };
+    if (xQueueSend(s_stream_jobs, &job, 0) != pdTRUE) {
+        httpd_req_async_handler_complete(async_req);
+        return false;
+    }
+#else
+    // stream_sock_close() queues the job once httpd has let go
+    int fd = httpd_req_to_sockfd(req);
+    if (stream_sock_claim(fd, client) < 0) {
+        return false;
+    }
+    if (httpd_sess_trigger_close(req->handle, fd) != ESP_OK) {
+        StreamJob unused;
+        stream_sock_unclaim(fd, &unused);
+        return false;
+    }
+#endif
+    return true;
+}
+
 static esp_err_t stream_handler(httpd_req_t *req) {
     if (!camera_is_ok()) {
         httpd_resp_set_status(req, "503 Service Unavailable");
@@ -89,6 +334,20 @@ static esp_err_t stream_handler(httpd_req_t *req) {
         return httpd_resp_send(req, msg, strlen(msg));
     }
     
+    if (stream_pipeline_ok()) {
+        int client = stream_client_attach();
+        if (client < 0) {
+            httpd_resp_set_status(req, "503 Service Unavailable");
+            httpd_resp_set_type(req, "text/plain");
+            const char* msg = "Too many stream clients";
+            return httpd_resp_send(req, msg, strlen(msg));
+        }
+        if (stream_hand_off(req, client)) {
+            return ESP_OK;
+        }
+        return stream_send_pipelined(req, client);
+    }
+    
     camera_fb_t *fb = NULL;
     esp_err_t res = ESP_OK;
     char part_buf[64];
@@ -98,6 +357,7 @@ static esp_err_t stream_handler(httpd_req_t *req) {
     
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     
+    // No pipeline (no PSRAM): capture and send inline
     while (true) {
         // #region agent log - Hypothesis E: Feed watchdog in stream loop
         esp_task_wdt_reset();  // Feed watchdog in stream loop
@@ -137,6 +397,19 @@ static esp_err_t health_handler(httpd_req_t *req) {
     CameraStats cam_stats = camera_get_stats();
     UartStats uart_stats = uart_get_stats();
     NetStats net_stats = net_get_stats();
+#if ENABLE_STREAM
+    StreamStats stream_stats = stream_get_stats();
+    StreamAdaptStats adapt_stats = stream_get_adapt_stats();
+    // How clients leave the httpd worker: none = served one at a time
+    const char* handoff = !s_senders_ok ? "none"
+                        : STREAM_ASYNC_HANDLERS ? "async" : "socket";
+#else
+    StreamStats stream_stats = {};
+    StreamAdaptStats adapt_stats = {};
+    adapt_stats.framesize = "-";
+    adapt_stats.last_reason = "none";
+    const char* handoff = "none";
+#endif
     
     // Get camera status string
     const char* cam_status_str;
@@ -197,6 +470,21 @@ static esp_err_t health_handler(httpd_req_t *req) {
         }
     }
     
+    // Per-client stream FPS as a JSON array body: "17.2,0.0,9.1"
+    char client_fps[16 * CONFIG_STREAM_MAX_CLIENTS];
+    size_t client_fps_len = 0;
+    client_fps[0] = '\0';
+    for (int i = 0; i < CONFIG_STREAM_MAX_CLIENTS; i++) {
+        int n = snprintf(client_fps + client_fps_len, sizeof(client_fps) - client_fps_len,
+                         "%s%lu.%lu", i ? "," : "",
+                         (unsigned long)(stream_stats.client_fps_x10[i] / 10),
+                         (unsigned long)(stream_stats.client_fps_x10[i] % 10));
+        if (n < 0 || (size_t)n >= sizeof(client_fps) - client_fps_len) {
+            break;
+        }
+        client_fps_len += n;
+    }
+    
     // CRITICAL: Store String objects in local variables to ensure they stay alive during snprintf
     // String.c_str() returns pointer to internal buffer - must keep String object alive
     String wifi_ssid = net_get_ssid();
@@ -226,6 +514,41 @@ static esp_err_t health_handler(httpd_req_t *req) {
             "\"last_capture_time\":%lu,"
             "\"idle_ms\":%lu"
         "},"
+        "\"stream\":{"
+            "\"pipelined\":%s,"
+            "\"handoff\":\"%s\","
+            "\"clients\":%lu,"
+            "\"max_clients\":%lu,"
+            "\"rejected\":%lu,"
+            "\"sensor_fps\":%lu.%lu,"
+            "\"stream_fps\":%lu.%lu,"
+            "\"client_fps\":[%s],"
+            "\"captured\":%lu,"
+            "\"sent\":%lu,"
+            "\"skipped\":%lu,"
+            "\"dropped\":%lu,"
+            "\"oversize\":%lu,"
+            "\"last_copy_us\":%lu,"
+            "\"last_send_ms\":%lu,"
+            "\"slots\":%lu,"
+            "\"slot_bytes\":%lu,"
+            "\"adapt\":{"
+                "\"enabled\":%s,"
+                "\"level\":%lu,"
+                "\"levels\":%lu,"
+                "\"quality\":%lu,"
+                "\"framesize\":\"%s\","
+                "\"target_fps\":%lu,"
+                "\"pressure_pct\":%lu,"
+                "\"predicted_pct\":%lu,"
+                "\"avg_frame_bytes\":%lu,"
+                "\"stalls\":%lu,"
+                "\"degrades\":%lu,"
+                "\"upgrades\":%lu,"
+                "\"last_reason\":\"%s\","
+                "\"last_change_ms\":%lu"
+            "}"
+        "},"
         "\"uart\":{"
             "\"init_ok\":%s,"
             "\"rx_pin\":%d,"
@@ -283,6 +606,40 @@ static esp_err_t health_handler(httpd_req_t *req) {
         (unsigned long)cam_stats.last_frame_bytes,
         (unsigned long)cam_stats.last_capture_time,
         (unsigned long)cam_idle_ms,
+        // Stream pipeline
+        stream_stats.pipelined ? "true" : "false",
+        handoff,
+        (unsigned long)stream_stats.clients,
+        (unsigned long)stream_stats.max_clients,
+        (unsigned long)stream_stats.rejected,
+        (unsigned long)(stream_stats.sensor_fps_x10 / 10),
+        (unsigned long)(stream_stats.sensor_fps_x10 % 10),
+        (unsigned long)(stream_stats.stream_fps_x10 / 10),
+        (unsigned long)(stream_stats.stream_fps_x10 % 10),
+        client_fps,
+        (unsigned long)stream_stats.captured,
+        (unsigned long)stream_stats.sent,
+        (unsigned long)stream_stats.skipped,
+        (unsigned long)stream_stats.dropped,
+        (unsigned long)stream_stats.oversize,
+        (unsigned long)stream_stats.last_copy_us,
+        (unsigned long)stream_stats.last_send_ms,
+        (unsigned long)stream_stats.slots,
+        (unsigned long)stream_stats.slot_bytes,
+        adapt_stats.enabled ? "true" : "false",
+        (unsigned long)adapt_stats.level,
+        (unsigned long)adapt_stats.levels,
+        (unsigned long)adapt_stats.quality,
+        adapt_stats.framesize,
+        (unsigned long)adapt_stats.target_fps,
+        (unsigned long)adapt_stats.pressure_pct,
+        (unsigned long)adapt_stats.predicted_pct,
+        (unsigned long)adapt_stats.avg_frame_bytes,
+        (unsigned long)adapt_stats.stalls,
+        (unsigned long)adapt_stats.degrades,
+        (unsigned long)adapt_stats.upgrades,
+        adapt_stats.last_reason,
+        (unsigned long)adapt_stats.last_change_ms,
         // UART
         uart_is_ok() ? "true" : "false",
         uart_get_rx_pin(),
@@ -435,9 +792,25 @@ bool web_server_init() {
     LOG_I("WEB", "Main server started");
     
 #if ENABLE_STREAM
-    // Stream server on port 81
+    // Stream server on port 81 - sender on Core 0, capture task on Core 1
     config.server_port = CONFIG_STREAM_PORT;
     config.ctrl_port = CONFIG_STREAM_PORT + 32768;  // Control port offset
+    config.core_id = TASK_CORE_STREAM_SENDER;
+#if STREAM_ASYNC_HANDLERS
+    // Room for every stream client plus a couple of plain requests
+    config.max_open_sockets = CONFIG_STREAM_MAX_CLIENTS + 2;
+#else
+    // Handed-off sockets leave httpd's table, so it only holds requests in
+    // flight. The lwIP socket total (clients + 2) is the same as above.
+    config.max_open_sockets = 2;
+    config.close_fn = stream_sock_close;  // Skips sockets claimed by a sender
+    config.lru_purge_enable = false;      // Never purge a session mid-handoff
+#endif
+    if (stream_pipeline_init()) {
+        if (!stream_senders_start()) {
+            LOG_W("WEB", "Stream senders unavailable - clients served one at a time");
+        }
+    }
     
     httpd_uri_t stream_uri = {
         .uri = "/stream",
@@ -0,0 +1,109 @@
+/*
+ * Range Scanner
+ *
+ * Servo-swept ultrasonic scan (N=150). Steps the pan servo without the
+ * 450ms blocking delay, pings once per stop and returns the whole
+ * polar profile in a single frame:
+ *
+ *   {<H>_<start>,<step>,<n>:<d0>,<d1>,...}
+ *
+ * Distances are in cm (0 = no echo). Step is signed (start > end sweeps
+ * right-to-left). The servo returns to its pre-scan angle when done.
+ */
+
+#ifndef RANGE_SCANNER_H
+#define RANGE_SCANNER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+class ServoPan;
+class UltrasonicHC_SR04;
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION
+// ============================================================================
+
+// Max points per scan (1 byte each). 37 = 0..180 in 5 degree steps.
+#ifndef SCAN_MAX_POINTS
+#define SCAN_MAX_POINTS  37
+#endif
+
+// Extra settle time after servo travel before pinging (ms)
+#ifndef SCAN_SETTLE_MS
+#define SCAN_SETTLE_MS  20
+#endif
+
+// Echo timeout sized to max range (58us/cm round trip) instead of 30ms
+#ifndef SCAN_ECHO_TIMEOUT_US
+#define SCAN_ECHO_TIMEOUT_US  ((ULTRASONIC_MAX_DISTANCE_CM + 10UL) * 58UL)
+#endif
+
+// Samples within this cone of center also feed the TTC reflex
+#ifndef SCAN_REFLEX_CONE_DEG
+#define SCAN_REFLEX_CONE_DEG  10
+#endif
+
+// Forward v cap for N=200 while scanning: the reflex only sees the stops
+// inside the cone, so it is blind for most of the sweep
+#ifndef SCAN_FORWARD_V_MAX
+#define SCAN_FORWARD_V_MAX  60
+#endif
+
+// Result frame is written this many points per chunk, each chunk only once
+// the TX ring has room for all of it (header <= 22 bytes, point <= 4)
+#ifndef SCAN_TX_POINTS
+#define SCAN_TX_POINTS  8
+#endif
+#define SCAN_TX_CHUNK_MAX  (SCAN_TX_POINTS * 4 + 2)
+
+class RangeScanner {
+public:
+  RangeScanner();
+
+  void init(ServoPan* servo, UltrasonicHC_SR04* sonar);
+
+  // Start a scan. Returns false if already scanning or arguments invalid.
+  bool start(int16_t startDeg, int16_t endDeg, int16_t stepDeg, const char* tag);
+
+  // Abort without sending a result; the servo heads back to its
+  // pre-scan angle (isActive() until it gets there). A result frame that
+  // has started going out is finished rather than cut short.
+  void cancel();
+
+  // Advance state machine (call every loop, non-blocking except echo wait)
+  void update();
+
+  bool isActive() const { return state != SCAN_IDLE; }
+  uint16_t getScansCompleted() const { return scansCompleted; }
+
+private:
+  enum ScanState : uint8_t {
+    SCAN_IDLE = 0,
+    SCAN_MOVING,
+    SCAN_SENDING,
+    SCAN_RETURNING
+  };
+
+  ServoPan* servo;
+  UltrasonicHC_SR04* sonar;
+
+  ScanState state;
+  uint8_t startAngle;
+  int8_t step;
+  uint8_t count;
+  uint8_t index;
+  bool headerSent;
+  uint8_t restoreAngle;
+  unsigned long readyAtMs;
+  uint16_t scansCompleted;
+  char tag[8];
+  uint8_t distances[SCAN_MAX_POINTS];
+
+  void moveTo(uint8_t angle);
+  bool sendChunk();
+};
+
+extern RangeScanner rangeScanner;
+
+#endif // RANGE_SCANNER_H
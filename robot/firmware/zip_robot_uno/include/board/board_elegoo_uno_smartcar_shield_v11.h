@@ -234,6 +234,7 @@
 #define SERVO_ANGLE_CENTER      90
 #define SERVO_PULSE_MIN_US      500   // 0 degrees (official ELEGOO calibration)
 #define SERVO_PULSE_MAX_US      2400  // 180 degrees (official ELEGOO calibration)
+#define SERVO_MS_PER_DEG        2     // SG90 ~0.1s/60deg @ 4.8V, rounded up
 
 // ============================================================================
 // ULTRASONIC CONSTANTS
@@ -39,6 +39,8 @@
 #define TASK_SENSORS_SLOW_HZ 10
 #define TASK_TELEMETRY_HZ 0  // DISABLED - telemetry flooding serial port
 #define TASK_PROTOCOL_RX_CONTINUOUS true
+#define TASK_SETPOINT_ACK_HZ 5  // {sq:...} cumulative ack while sequenced setpoints flow
+#define SETPOINT_SL_EVERY 5     // Every 5th ack slot (1Hz) sends {sl:...} instead
 
 // Motion Control Configuration
 #define MOTION_CONTROLLER_UPDATE_MS 20  // 50Hz update rate
@@ -47,6 +49,20 @@
 #define MOTION_MACRO_TTL_MIN_MS 1000
 #define MOTION_MACRO_TTL_MAX_MS 10000
 #define MOTION_RATE_LIMIT_HZ 50  // Max commands per second
+#define MOTION_SEQ_RESYNC_MS 1000   // Accept any seq after this long without one
+#define MOTION_SEQ_ACK_HOLD_MS 1000 // Keep acking this long after the last one
+
+// Adaptive setpoint TTL: once N=200 frames arrive as a stream, each one lives
+// for a multiple of the measured arrival period plus a jitter margin (EWMA
+// mean / mean deviation, as TCP sizes its RTO) instead of the host's T
+#ifndef MOTION_TTL_ADAPTIVE
+#define MOTION_TTL_ADAPTIVE 1
+#endif
+#define MOTION_TTL_PERIOD_MULT 2      // Periods covered (rides out one lost frame)
+#define MOTION_TTL_JITTER_MULT 4      // Jitter margin
+#define MOTION_TTL_MIN_SAMPLES 3      // Gaps measured before the TTL adapts
+#define MOTION_TTL_STREAM_GAP_MS 500  // Longer gap = not a stream, estimate restarts
+#define MOTION_TTL_STREAM_CAP_MS 500  // Upper bound on a streamed TTL
 
 // Motor Control (TB6612FNG parameters)
 // Note: Official ELEGOO code has NO ramping - PWM is applied immediately
@@ -86,7 +102,9 @@
 // Self-Test Configuration
 #define SELF_TEST_MOTOR_PWM 120
 #define SELF_TEST_DURATION_MS 500
+#ifndef SELF_TEST_ENABLED
 #define SELF_TEST_ENABLED false  // Disabled to test communication
+#endif
 
 // LED Configuration
 #define LED_BRIGHTNESS_DEFAULT 20
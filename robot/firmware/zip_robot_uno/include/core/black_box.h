@@ -0,0 +1,108 @@
+/*
+ * Black-Box Flight Recorder
+ *
+ * The last ~1.3s of the control loop - setpoint, applied PWM, battery, yaw,
+ * motion state and the time since the previous record - one record every
+ * BLACK_BOX_EVERY control ticks, in a ring that lives in .noinit RAM. The C runtime neither
+ * zeroes nor initialises .noinit, so the ring survives a watchdog reset, the
+ * reset button and the DTR reset that opening the port causes (a brownout
+ * too, as long as the SRAM kept its contents - the check byte catches the
+ * rest). N=125 dumps it in binary.
+ *
+ * Lifecycle:
+ *   boot()    garbage (power-on)           -> cleared, recording
+ *             last record was driving, or
+ *             MCUSR says watchdog/brownout -> frozen (the post-mortem)
+ *             last record was at rest      -> cleared, recording (a port
+ *                                             reopen while idle is no fault)
+ *             already frozen               -> stays frozen, counts the boot
+ *   record()  appends while recording (no-op while frozen)
+ *   rearm()   N=125 D1=1: clears and records again
+ *
+ * A frozen ring is kept through any number of further resets until it has
+ * been dumped and re-armed, so a host reconnecting after a stall cannot
+ * overwrite the evidence.
+ *
+ * The ring sits between .bss and the heap (.noinit is below _end), so it
+ * comes straight out of stack headroom: BLACK_BOX_RECORDS * 8 bytes + 10.
+ * Halving the rate doubles the window for the same RAM; a stall still shows
+ * up as a long dtMs.
+ */
+
+#ifndef BLACK_BOX_H
+#define BLACK_BOX_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable the recorder (N=125 replies {H_false} when disabled)
+#ifndef BLACK_BOX_ENABLED
+#define BLACK_BOX_ENABLED 1
+#endif
+
+// Ring length in records (32 = 266 bytes of RAM)
+#ifndef BLACK_BOX_RECORDS
+#define BLACK_BOX_RECORDS 32
+#endif
+
+// Control ticks per record (2 = 25 Hz, 32 records = 1.28s)
+#ifndef BLACK_BOX_EVERY
+#define BLACK_BOX_EVERY 2
+#endif
+
+#define BLACK_BOX_MAGIC 0xB10Cu
+
+// Record.state bits
+#define BB_STATE_MOTION_MASK  0x03  // MotionState (motion_types.h)
+#define BB_STATE_BATT_SHIFT   2     // BatteryState (drive_safety_layer.h)
+#define BB_STATE_BATT_MASK    0x0C
+#define BB_STATE_INIT         0x10  // Init sequence running
+
+// One record, 8 bytes on the wire in field order. Values are
+// halved/scaled to fit a byte each.
+struct BlackBoxRecord {
+  int8_t v2;        // Setpoint v / 2
+  int8_t w2;        // Setpoint w / 2
+  int8_t pwmL2;     // Applied left PWM / 2
+  int8_t pwmR2;     // Applied right PWM / 2
+  uint8_t battMv40; // Battery mV / 40 (last 10 Hz reading)
+  int8_t yaw;       // Yaw, 180 deg / 128 per step (yawX10 * 128 / 1800)
+  uint8_t state;    // BB_STATE_* bits
+  uint8_t dtMs;     // ms since the previous record (255 = 255 or more)
+};
+
+class BlackBox {
+public:
+  // Decide between freezing the previous run and recording (setup(), early)
+  void boot();
+
+  // Call once per control tick; keeps every BLACK_BOX_EVERY-th
+  void record(int16_t v, int16_t w, int16_t pwmL, int16_t pwmR,
+              int16_t yawX10, uint8_t state);
+
+  // Cached from the slow sensor task; stamped into each record
+  void setBatteryMv(uint16_t mv) { battMv = mv; }
+
+  // Clear the ring and start recording
+  void rearm();
+
+  // Format: {<H>_bb:<count>,<boots>,<cause>,<lastMs>,<frozen>}\n followed by
+  // count * 8 raw record bytes, oldest first, and a closing '\n'.
+  // cause = MCUSR at the freezing boot, lastMs = millis() of the newest
+  // record (uptime at the fault).
+  void dump(const char* tag) const;
+
+  bool isFrozen() const;
+  uint8_t getCount() const;
+
+private:
+  uint16_t battMv;
+  uint8_t skip;
+};
+
+extern BlackBox blackBox;
+
+#endif // BLACK_BOX_H
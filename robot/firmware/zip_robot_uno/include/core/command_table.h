@@ -0,0 +1,91 @@
+/*
+ * Command Dispatch Table
+ *
+ * Maps protocol N values to handlers through a table in flash instead of an
+ * if/else chain. The table is sorted by N (checked at compile time with
+ * commandTableSorted()) and searched with a fixed-step lower bound, so every
+ * lookup - N=200 setpoints included - costs the same ceil(log2(count))
+ * PROGMEM compares, and adding a command never lengthens the hot path beyond
+ * the next power of two.
+ *
+ * Per-handler metadata:
+ *   CMD_ACK     handler always replies ({H_ok}/{H_false}/value)
+ *   CMD_MOTION  handler drives or stops the motors
+ *   CMD_CLASS_* admission class: motion, sensor query, config or diagnostics
+ *   maxRateHz   highest sensible command rate (0 = unlimited, never refused);
+ *               admission control in front of dispatch charges each command
+ *               1000/maxRateHz ms of its class budget (src/motion/safety.h)
+ *
+ * The table itself lives next to the handlers (main.cpp), which also
+ * defines commandLookup().
+ */
+
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "../../src/serial/frame_parser.h"
+
+#define CMD_ACK     0x01
+#define CMD_MOTION  0x02
+
+// Admission class (bits 4-5): one token bucket each in SafetyLayer
+#define CMD_CLASS_SHIFT   4
+#define CMD_CLASS_MOTION  (0 << CMD_CLASS_SHIFT)
+#define CMD_CLASS_SENSOR  (1 << CMD_CLASS_SHIFT)
+#define CMD_CLASS_CONFIG  (2 << CMD_CLASS_SHIFT)
+#define CMD_CLASS_DIAG    (3 << CMD_CLASS_SHIFT)
+
+typedef void (*CommandHandlerFn)(const ParsedCommand& cmd);
+
+struct CommandEntry {
+  int16_t n;
+  CommandHandlerFn handler;
+  uint8_t flags;
+  uint8_t maxRateHz;
+};
+
+// Compile-time check: strictly ascending N (no duplicates)
+constexpr bool commandTableSorted(const CommandEntry* table, size_t count, size_t i = 0) {
+  return (i + 1 >= count) ||
+         (table[i].n < table[i + 1].n && commandTableSorted(table, count, i + 1));
+}
+
+// Fixed-step lower bound over a PROGMEM table: the loop runs
+// ceil(log2(count)) times whatever N is. Returns nullptr if N is not listed.
+template <size_t COUNT>
+static inline const CommandEntry* commandTableFind(const CommandEntry (&table)[COUNT], int16_t n) {
+  static_assert(COUNT > 0 && COUNT < 256, "command table size");
+  const CommandEntry* base = table;
+  uint8_t len = COUNT;
+  while (len > 1) {
+    uint8_t half = len / 2;
+    if ((int16_t)pgm_read_word(&base[half].n) <= n) {
+      base += half;
+    }
+    len -= half;
+  }
+  return ((int16_t)pgm_read_word(&base->n) == n) ? base : nullptr;
+}
+
+static inline CommandHandlerFn commandHandler(const CommandEntry* entry) {
+  return (CommandHandlerFn)pgm_read_ptr(&entry->handler);
+}
+
+static inline uint8_t commandFlags(const CommandEntry* entry) {
+  return pgm_read_byte(&entry->flags);
+}
+
+static inline uint8_t commandClass(const CommandEntry* entry) {
+  return (commandFlags(entry) >> CMD_CLASS_SHIFT) & 0x03;
+}
+
+static inline uint8_t commandMaxRateHz(const CommandEntry* entry) {
+  return pgm_read_byte(&entry->maxRateHz);
+}
+
+// Table entry for N (PROGMEM pointer), or nullptr for unlisted commands
+const CommandEntry* commandLookup(int16_t n);
+
+#endif // COMMAND_TABLE_H
@@ -0,0 +1,84 @@
+/*
+ * Stackless Coroutines (protothreads)
+ *
+ * Lets a long routine be written top to bottom - drive, wait 500ms, stop,
+ * print, wait again - and still run as a scheduler task that returns in
+ * microseconds. The body is a switch on the line number of the last yield
+ * point (Duff's device), so resuming costs one jump and the whole state is
+ * a Coroutine: 6 bytes, no stack of its own.
+ *
+ *   static Coroutine co;
+ *   CoStatus blink() {
+ *     CO_BEGIN(co);
+ *     for (n = 0; n < 3; n++) {       // n: static or member, see below
+ *       led(1);
+ *       CO_DELAY(co, 200);
+ *       led(0);
+ *       CO_YIELD_UNTIL(co, buttonUp());
+ *     }
+ *     CO_END(co);
+ *   }
+ *
+ * Call it from a task until it returns CO_DONE (it then restarts from the
+ * top on the next call). Rules that follow from having no stack:
+ *   - Locals do not survive a yield: keep loop counters and results in
+ *     static or member variables.
+ *   - No switch statement in the body across a yield point, and at most
+ *     one yield per source line (the line number is the resume label).
+ *   - Yields only in the coroutine function itself, not in callees.
+ */
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <Arduino.h>
+
+enum CoStatus : uint8_t {
+  CO_WAITING = 0,  // Yielded - call again
+  CO_DONE = 1      // Ran to CO_END (or CO_EXIT)
+};
+
+struct Coroutine {
+  uint16_t line;     // Resume point (__LINE__ of the last yield, 0 = top)
+  uint32_t wakeMs;   // Deadline for CO_DELAY / CO_YIELD_UNTIL_MS
+};
+
+// Back to the top on the next call
+#define CO_RESET(co)      do { (co).line = 0; } while (0)
+#define CO_RUNNING(co)    ((co).line != 0)
+
+// Marks the deliberate fall into a yield's case label for
+// -Wimplicit-fallthrough (-Wextra). A /* fallthrough */ comment would be
+// stripped before the macro expands, so this has to be the GCC attribute;
+// gnu++11 has no [[fallthrough]].
+#if defined(__GNUC__) && __GNUC__ >= 7 && !defined(__clang__)
+#define CO_FALLTHROUGH    __attribute__((fallthrough))
+#else
+#define CO_FALLTHROUGH    ((void)0)
+#endif
+
+#define CO_BEGIN(co)      switch ((co).line) { case 0:
+
+#define CO_END(co)        } (co).line = 0; return CO_DONE
+
+// Finish early (next call starts from the top)
+#define CO_EXIT(co)       do { (co).line = 0; return CO_DONE; } while (0)
+
+// Give the CPU back once, resume on the next call
+#define CO_YIELD(co) \
+  do { (co).line = __LINE__; return CO_WAITING; case __LINE__:; } while (0)
+
+// Resume once cond is true (checked on this call already)
+#define CO_YIELD_UNTIL(co, cond) \
+  do { (co).line = __LINE__; CO_FALLTHROUGH; \
+       case __LINE__: if (!(cond)) return CO_WAITING; } while (0)
+
+// Resume once millis() reaches deadline (wrap-safe)
+#define CO_YIELD_UNTIL_MS(co, deadline) \
+  do { (co).wakeMs = (deadline); \
+       CO_YIELD_UNTIL(co, (int32_t)(millis() - (co).wakeMs) >= 0); } while (0)
+
+// Resume ms milliseconds from now
+#define CO_DELAY(co, ms)  CO_YIELD_UNTIL_MS(co, millis() + (uint32_t)(ms))
+
+#endif // COROUTINE_H
@@ -4,6 +4,19 @@
  * Deterministic hardware initialization routine executed at boot.
  * Non-blocking state machine that validates sensors, IMU, and drivetrain
  * without requiring wheel encoders.
+ *
+ * Optional drivetrain calibration (N=130 D1=1, or every boot with
+ * INIT_CAL_AT_BOOT): the IMU gyro stands in for encoders. Each wheel is
+ * driven alone, so the car pivots and gyro Z sees its motion. Per wheel and
+ * direction:
+ *   1. Ramp raw PWM (no deadband/kick) from rest until gyro Z leaves the
+ *      noise band for two samples in a row -> onset PWM
+ *   2. Step from rest to onset + INIT_CAL_STEP_MARGIN and time the first
+ *      sample over threshold (interpolated between ticks) -> dead time
+ *   3. Breakaway = onset PWM minus the ramp travelled during the dead time
+ * The larger breakaway of the two directions becomes the wheel's deadband
+ * and the longest dead time sets the kickstart duration in DriveSafetyLayer.
+ * Result line: CAL:<done|fail> lf=<pwm>/<ms> lr=.. rf=.. rr=.. db=<L>/<R> kick=<ticks>
  */
 
 #ifndef INIT_SEQUENCE_H
@@ -24,6 +37,30 @@
 
 // Total expected time: ~1.7 seconds
 
+// ============================================================================
+// DRIVETRAIN CALIBRATION
+// ============================================================================
+
+#ifndef INIT_CAL_ENABLED
+#define INIT_CAL_ENABLED 1        // 1 = N=130 D1=1 runs the deadband calibration
+#endif
+
+#ifndef INIT_CAL_AT_BOOT
+#define INIT_CAL_AT_BOOT 0        // 1 = calibrate on every boot (adds ~8 s)
+#endif
+
+#define INIT_CAL_SETTLE_MS        300   // Stopped before each ramp/step (gyro baseline)
+#define INIT_CAL_PWM_START        20    // Ramp start (below any real breakaway)
+#define INIT_CAL_PWM_MAX          160   // Ramp end - no motion by here = fail
+#define INIT_CAL_TICK_MS          20    // update() period (task_control_loop)
+#define INIT_CAL_RAMP_STEP        2     // PWM per tick (100 PWM/s)
+#define INIT_CAL_STEP_MARGIN      10    // Step test PWM above the ramp onset
+#define INIT_CAL_STEP_TIMEOUT_MS  400   // No onset after the step = dead time unknown
+#define INIT_CAL_GYRO_MIN_LSB     262   // Onset threshold floor (2 deg/s at 131 LSB/dps)
+#define INIT_CAL_KICK_MIN_TICKS   2
+#define INIT_CAL_KICK_MAX_TICKS   10
+#define INIT_CAL_NONE             0xFF  // Run result: no onset detected
+
 // ============================================================================
 // INIT STATE ENUMS
 // ============================================================================
@@ -49,9 +86,23 @@ enum InitStep : uint8_t {
   STEP_SPIN_L,          // Spin left (L=-PWM, R=+PWM)
   STEP_PAUSE_3,         // Pause
   STEP_SPIN_R,          // Spin right (L=+PWM, R=-PWM)
+  STEP_CALIBRATE,       // Deadband/dead time calibration (opt-in)
   STEP_COMPLETE         // Finalize and report
 };
 
+// Calibration sub-steps (per run: wheel x direction)
+enum CalPhase : uint8_t {
+  CAL_SETTLE_RAMP = 0,  // Stopped, sample gyro baseline
+  CAL_RAMP,             // Raw PWM ramp until motion onset
+  CAL_SETTLE_STEP,      // Stopped, sample gyro baseline
+  CAL_STEP              // Step from rest, time the onset
+};
+
+// Calibration result (getCalStatus)
+#define CAL_STATUS_NONE     0
+#define CAL_STATUS_DONE     1
+#define CAL_STATUS_FAIL     2
+
 // ============================================================================
 // WARNING BIT FLAGS
 // ============================================================================
@@ -63,6 +114,7 @@ enum InitStep : uint8_t {
 #define WARN_IMU_NO_MOTION  0x08  // IMU didn't detect spin motion
 #define WARN_ULTRA_MISSING  0x10  // Ultrasonic returned 0/invalid
 #define WARN_SERVO_SKIP     0x20  // Servo step skipped (low battery)
+#define WARN_CAL_FAIL       0x40  // Calibration skipped (no IMU/battery) or no onset
 
 // ============================================================================
 // INIT SEQUENCE CLASS
@@ -85,6 +137,9 @@ public:
   // Request re-run (for N=130 command)
   void requestRerun();
   
+  // Request re-run with drivetrain calibration (for N=130 D1=1)
+  void requestCalibration();
+  
   // Abort sequence (for N=201 stop preemption)
   void abort();
   
@@ -98,6 +153,11 @@ public:
   // IMU yaw delta observed during spins (degrees * 10, e.g., 120 = 12.0°)
   int16_t getYawDelta() const { return yawDelta; }
   
+  uint8_t getCalStatus() const { return calStatus; }
+  
+  // Print the last CAL: line (N=130 D1=2)
+  void printCalReport();
+  
 private:
   // Current state
   InitState state;
@@ -116,6 +176,25 @@ private:
   uint16_t initBatteryMv;
   uint16_t initUltrasonicCm;
   
+  // Calibration state
+  bool calRequested;
+  uint8_t calStatus;        // CAL_STATUS_*
+  uint8_t calRun;           // 0=L fwd, 1=L rev, 2=R fwd, 3=R rev
+  CalPhase calPhase;
+  uint8_t calPwm;           // Raw PWM being applied
+  uint8_t calAbove;         // Consecutive samples over threshold (ramp)
+  uint8_t calSamples;       // Baseline sample count
+  int16_t calBase;          // Gyro Z at rest (LSB)
+  int16_t calThresh;        // Onset threshold above |base| (LSB)
+  int16_t calMin, calMax;   // Baseline noise band
+  int32_t calSum;
+  int16_t calPrevDev;       // Step test: previous sample
+  uint32_t calPrevUs;
+  uint32_t calStepUs;       // Step test: PWM applied
+  uint8_t calOnset[4];      // Ramp onset PWM per run
+  uint8_t calBreakaway[4];  // Breakaway PWM per run (INIT_CAL_NONE = fail)
+  uint8_t calDeadMs[4];     // PWM -> motion latency per run (INIT_CAL_NONE = timeout)
+  
   // ---- Step handlers ----
   
   void enterStep(InitStep step);
@@ -129,10 +208,20 @@ private:
   void handleSpinL();
   void handlePause3();
   void handleSpinR();
+  void handleCalibrate();
   void handleComplete();
   
+  // Calibration helpers
+  void calEnterPhase(CalPhase phase);
+  void calResetBaseline();
+  void calSampleBaseline(int16_t gyro);
+  void calWriteRun(uint8_t pwm);
+  void calFinishRun(uint8_t breakaway, uint8_t deadMs);
+  void calApply();
+  
   // Helpers
   void setMotors(int16_t left, int16_t right);
+  void writeMotorsRaw(int16_t left, int16_t right);  // Bypasses DriveSafetyLayer
   void stopMotors();
   uint8_t getInitPwm() const;  // Returns PWM based on battery state
   void printInitStatus();
@@ -0,0 +1,104 @@
+/*
+ * Link Baud - negotiated serial rate switch (N=124)
+ *
+ * The UNO always boots at SERIAL_BAUD (115200). The peer (ESP32 bridge,
+ * camera board or USB host) can move the link to a faster rate:
+ *
+ *   1. peer @115200:  {"N":124,"H":"bd","D1":1000}     D1 = kbaud
+ *   2. UNO  @115200:  {bd_ok}, drains TX, switches      (unsupported: {bd_false})
+ *   3. peer switches and sends any frame as the probe (e.g. N=0 hello)
+ *   4. UNO: the first valid frame at the new rate confirms it
+ *
+ * Fallback to SERIAL_BAUD, so a failed or half-finished switch never
+ * leaves the link dead:
+ *   - no valid frame within LINK_BAUD_CONFIRM_MS of the switch
+ *   - LINK_BAUD_GARBAGE_LIMIT non-text bytes since the last valid frame.
+ *     A peer that fell back (or rebooted) to 115200 shows up at 1M as a
+ *     burst of 0x00/0x80 framing garbage, so this also covers peers that
+ *     give up after the UNO had already confirmed.
+ *
+ * 250k, 500k and 1M are exact at 16MHz with U2X (0% error, vs. -3.5% at
+ * 115200 - Arduino picks U2X itself). D1=0 queries the current rate:
+ * {H_<kbaud>}.
+ *
+ * Note: the 128-byte HardwareSerial RX ring (SERIAL_RX_BUFFER_SIZE) holds
+ * 1.28ms of traffic at 1M, barely more than the 1ms task_protocol_rx()
+ * period, so peers should not send frames back to back at the fastest rate.
+ */
+
+#ifndef LINK_BAUD_H
+#define LINK_BAUD_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable N=124 rate switching (disabled: N=124 answers {H_false})
+#ifndef LINK_BAUD_ENABLED
+#define LINK_BAUD_ENABLED 1
+#endif
+
+// Revert if no valid frame arrives this long after a switch
+#ifndef LINK_BAUD_CONFIRM_MS
+#define LINK_BAUD_CONFIRM_MS 500
+#endif
+
+// Non-text bytes (since the last valid frame) that mean a rate mismatch
+#ifndef LINK_BAUD_GARBAGE_LIMIT
+#define LINK_BAUD_GARBAGE_LIMIT 16
+#endif
+
+class LinkBaud {
+public:
+  LinkBaud();
+
+  // kbaud 115/250/500/1000
+  static bool supported(uint16_t kbaud);
+
+  // Switch to kbaud once the reply has left the UART (blocks for the drain,
+  // ~1ms at 115200). Caller resets its frame parser afterwards.
+  void switchTo(uint16_t kbaud);
+
+  // A valid frame was parsed: confirms a pending switch
+  void onFrame() {
+    garbage = 0;
+    pending = false;
+  }
+
+  // Every received byte. Returns true if it triggered a fallback (caller
+  // resets its frame parser).
+  bool onByte(uint8_t b) {
+    if (baud == SERIAL_BAUD || (b >= 0x09 && b <= 0x7E)) {
+      return false;
+    }
+    if (++garbage < LINK_BAUD_GARBAGE_LIMIT) {
+      return false;
+    }
+    fallback();
+    return true;
+  }
+
+  // Confirm timeout. Returns true if it triggered a fallback.
+  bool update();
+
+  uint32_t current() const { return baud; }
+  uint16_t currentKbaud() const { return (uint16_t)(baud / 1000); }
+  uint8_t fallbacks() const { return fallbackCount; }
+
+private:
+  void begin(uint32_t rate);
+  void fallback();
+
+  uint32_t baud;
+  uint32_t switchMs;
+  bool pending;
+  uint8_t garbage;
+  uint8_t fallbackCount;
+};
+
+extern LinkBaud linkBaud;
+
+#endif // LINK_BAUD_H
@@ -0,0 +1,82 @@
+/*
+ * RAM Overlay Arena
+ *
+ * Scratch buffers that are never live at the same time share one static
+ * block instead of each owning its own. Each union member below belongs to
+ * one phase; the phase owns the arena from acquire() until release():
+ *
+ *   OVERLAY_JSON_RX     FrameParser, '{' .. '}' (released once parsed)
+ *   OVERLAY_BINARY_RX   ProtocolDecoder, 0xAA .. CRC (binary protocol)
+ *
+ * Both decode the same RX stream, so only one frame is ever being
+ * accumulated. acquire() by a different phase while the arena is held
+ * returns nullptr (the caller drops that frame) and counts a conflict -
+ * that is a bug, not a load condition.
+ *
+ * Long-lived state does not belong here (parsed commands, pending replies,
+ * scan profiles): it outlives the RX phase.
+ *
+ * The static RAM budget of the serial path (HardwareSerial rings + arena)
+ * is checked at compile time below; the README lists the breakdown.
+ */
+
+#ifndef RAM_OVERLAY_H
+#define RAM_OVERLAY_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// PHASE BUFFER SIZES
+// ============================================================================
+
+#define OVERLAY_JSON_LINE_MAX     64  // Longest JSON frame ('{' .. '}')
+#define OVERLAY_BINARY_FRAME_MAX  48  // Header+len+type+seq+32 payload+CRC = 38
+
+// ============================================================================
+// SERIAL PATH RAM BUDGET (bytes, static)
+// ============================================================================
+
+// Before the overlay: RX 64 + TX 64 + parser ring 32 + JSON line 65
+// + pending reply 32 = 257. The reclaimed bytes went to a 128-byte RX ring.
+#ifndef RAM_SERIAL_PATH_BUDGET
+#define RAM_SERIAL_PATH_BUDGET 272
+#endif
+
+enum OverlayOwner : uint8_t {
+  OVERLAY_FREE = 0,
+  OVERLAY_JSON_RX,
+  OVERLAY_BINARY_RX
+};
+
+union RamOverlayStorage {
+  char jsonLine[OVERLAY_JSON_LINE_MAX + 1];
+  uint8_t binaryFrame[OVERLAY_BINARY_FRAME_MAX];
+};
+
+// No constructor on purpose: zero-initialized before any global constructor
+// runs, so other globals may acquire/release from theirs.
+class RamOverlay {
+public:
+  // Storage for the phase, or nullptr if another phase holds it.
+  // Re-acquiring the phase already held returns the same storage.
+  RamOverlayStorage* acquire(OverlayOwner who);
+  
+  // No-op unless `who` holds the arena
+  void release(OverlayOwner who);
+  
+  OverlayOwner owner() const { return current; }
+  uint8_t getConflicts() const { return conflicts; }
+  
+private:
+  RamOverlayStorage storage;
+  OverlayOwner current;
+  uint8_t conflicts;
+};
+
+extern RamOverlay ramOverlay;
+
+static_assert(SERIAL_RX_BUFFER_SIZE + SERIAL_TX_BUFFER_SIZE + sizeof(RamOverlay)
+                <= RAM_SERIAL_PATH_BUDGET,
+              "Serial path RAM over budget (RX/TX rings + overlay arena)");
+
+#endif // RAM_OVERLAY_H
@@ -21,6 +21,7 @@ struct Task {
   unsigned long lastRunTime;
   bool enabled;
   const char* name;
+  uint16_t stackPeak;  // Deepest sampled stack use (bytes below scheduler SP)
 };
 
 class Scheduler {
@@ -43,12 +44,20 @@ public:
   // Get task count
   uint8_t getTaskCount() const { return taskCount; }
   
+  // Per-task diagnostics (index < getTaskCount())
+  const char* getTaskName(uint8_t index) const { return tasks[index].name; }
+  uint16_t getTaskStackPeak(uint8_t index) const { return tasks[index].stackPeak; }
+  
 private:
   static const uint8_t MAX_TASKS = 8;  // Reduced from 10 to save RAM (we only use 5 tasks)
   Task tasks[MAX_TASKS];
   uint8_t taskCount;
   
   unsigned long lastWatchdogReset;
+  
+  // Stack sampling: next task to sample and when
+  uint8_t stackSampleTask;
+  unsigned long lastStackSampleMs;
 };
 
 #endif // SCHEDULER_H
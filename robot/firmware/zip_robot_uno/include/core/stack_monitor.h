@@ -0,0 +1,72 @@
+/*
+ * Stack Monitor - Boot-time stack painting + high-water scans
+ *
+ * Before main() runs, all RAM between the end of .bss and RAMEND is filled
+ * with STACK_CANARY. Any byte the stack (or an ISR frame) ever touches loses
+ * the pattern, so scanning up from the heap top to the first non-canary byte
+ * gives the true minimum headroom since boot - not just what a freeRam()
+ * probe happened to see.
+ *
+ * Per-task peaks: the scheduler samples one task run at a time (round robin,
+ * every STACK_SAMPLE_INTERVAL_MS). beginSample() repaints the region earlier
+ * calls dirtied, endSample() rescans and returns how far the task (plus any
+ * ISR that fired during it) went below the scheduler's stack pointer.
+ *
+ * Cost: scans and repaints run at ~5 cycles/byte; one sample (two scans of
+ * the free window plus a repaint of the dirtied part) is ~0.5ms, so the
+ * default 50ms interval costs ~1% of the CPU. Each task is sampled every
+ * (task count * interval) ms.
+ */
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable stack painting and watermark scans (default: AVR only -
+// the native build has no AVR stack layout)
+#ifndef STACK_MONITOR_ENABLED
+#if defined(__AVR__)
+#define STACK_MONITOR_ENABLED 1
+#else
+#define STACK_MONITOR_ENABLED 0
+#endif
+#endif
+
+// Fill pattern (unlikely as a real stack value: not 0x00/0xFF, not a small int)
+#define STACK_CANARY 0xC5
+
+// One sampled task run per interval (round robin across tasks)
+#ifndef STACK_SAMPLE_INTERVAL_MS
+#define STACK_SAMPLE_INTERVAL_MS 50
+#endif
+
+// Bytes left unpainted below beginSample()'s own frame
+#define STACK_PAINT_GUARD 8
+
+class StackMonitor {
+public:
+  StackMonitor();
+
+  // Bytes between the heap top and the deepest stack point since boot.
+  // Full scan (~0.3ms); updates the low-water mark.
+  uint16_t unusedBytes();
+
+  // Per-task sampling (called by the scheduler around one task run)
+  void beginSample();
+  uint16_t endSample();
+
+private:
+  uint8_t* scanDeepest();
+
+  uint8_t* lowWater;    // Deepest address ever seen dirty
+  uint8_t* sampleBase;  // SP at beginSample()
+};
+
+extern StackMonitor stackMonitor;
+
+#endif // STACK_MONITOR_H
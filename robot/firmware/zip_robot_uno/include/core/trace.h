@@ -0,0 +1,122 @@
+/*
+ * Hot-Path Trace - Timer1 log2 latency histograms
+ *
+ * TRACE_SCOPE(point) timestamps the enclosing scope with Timer1 and bins the
+ * duration into a log2 histogram for that trace point. N=122 dumps and
+ * resets all histograms.
+ *
+ * Timer1 runs free in normal mode at /8 (0.5us per tick, 32.7ms range) -
+ * the same mode the Servo library programs on attach and leaves running on
+ * detach, so both can share it. Servo attach and each 20ms servo frame
+ * (while held, e.g. during an N=150 scan) reset TCNT1; a scope spanning
+ * that reset records a bogus value.
+ *
+ * Bucket b holds durations of [2^b, 2^(b+1)) ticks, i.e. [2^(b-1), 2^b) us
+ * (bucket 0 = under 1us). Bins saturate at 255, counts at 65535.
+ *
+ * Cost when enabled: ~1.5us per scope (two atomic TCNT1 reads + binning)
+ * and 20 bytes of RAM per trace point. Compiled out entirely by default.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable trace points (default: disabled - build env:uno_trace)
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+#define TRACE_BUCKETS 16
+
+// Trace points (keep in sync with the name table in trace.cpp)
+enum TracePoint {
+  TRACE_RX_BYTE = 0,     // FrameParser::processByte (includes parseJson on '}')
+  TRACE_PARSE_JSON,      // FrameParser::parseJson
+  TRACE_SAFETY_LIMITS,   // DriveSafetyLayer::applyLimits
+  TRACE_CMD_LOOKUP,      // commandLookup (dispatch table search)
+  TRACE_CMD_SYS,         // N=0, 5, 100-150 handlers (incl. reply)
+  TRACE_CMD_LEGACY,      // N=1-99 ELEGOO handlers
+  TRACE_CMD_MOTION,      // N=200+ handlers
+  TRACE_TASK_CTRL,       // task_control_loop
+  TRACE_TASK_SENS_S,     // task_sensors_slow
+  TRACE_POINT_COUNT
+};
+
+// Handler class for a command number
+static inline uint8_t traceCommandPoint(int16_t n) {
+  if (n >= 200) {
+    return TRACE_CMD_MOTION;
+  }
+  if (n == 0 || n == 5 || n >= 100) {
+    return TRACE_CMD_SYS;
+  }
+  return TRACE_CMD_LEGACY;
+}
+
+#if TRACE_ENABLED
+
+// Free-running 0.5us tick (Timer1 /8)
+static inline uint16_t traceTicks() {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();  // 16-bit TCNT1 read goes through the shared TEMP register
+  uint16_t t = TCNT1;
+  SREG = sreg;
+  return t;
+#else
+  return (uint16_t)(micros() * 2);
+#endif
+}
+
+class TraceHistograms {
+public:
+  TraceHistograms();
+
+  // Start Timer1 in normal mode /8 (call before servoPan.init())
+  void init();
+
+  void record(uint8_t point, uint16_t ticks);
+
+  // Print {<tag>_<name>:<n>,<maxUs>,<firstBucket>:<c>.<c>...;...} and optionally reset
+  void dump(const char* tag, bool resetAfter);
+  void reset();
+
+private:
+  struct PointStats {
+    uint16_t count;
+    uint16_t maxTicks;
+    uint8_t bins[TRACE_BUCKETS];
+  };
+
+  PointStats points[TRACE_POINT_COUNT];
+};
+
+extern TraceHistograms traceHist;
+
+class TraceScope {
+public:
+  explicit TraceScope(uint8_t point) : point(point), start(traceTicks()) {}
+  ~TraceScope() { traceHist.record(point, traceTicks() - start); }
+
+private:
+  uint8_t point;
+  uint16_t start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(point) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(point)
+
+#else
+
+#define TRACE_SCOPE(point) do { } while (0)
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
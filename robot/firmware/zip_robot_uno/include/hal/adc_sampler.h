@@ -0,0 +1,82 @@
+/*
+ * ADC Sampler HAL - Interrupt-driven background sampling
+ *
+ * Round-robins the analog inputs (A0-A3: line R/M/L + battery divider)
+ * from the ADC conversion-complete ISR. Each channel gets one settling
+ * conversion after the mux switch, then ADC_SAMPLER_OVERSAMPLE conversions
+ * that are averaged. Completed sweeps land in a double buffer so readers
+ * always see a consistent frame without blocking.
+ *
+ * At the default /128 prescaler one conversion takes ~104us, so a full
+ * sweep (4 channels x (1 + 4) conversions) completes every ~2ms.
+ *
+ * NOTE: Do not call analogRead() while the sampler is running - it would
+ * race the ISR for ADMUX/ADSC. Use the HAL getters instead.
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable background sampling (default: enabled)
+// When disabled, get() falls back to a blocking analogRead()
+#ifndef ADC_SAMPLER_ENABLED
+#define ADC_SAMPLER_ENABLED 1
+#endif
+
+// Conversions averaged per channel per sweep (power of 2 keeps the divide cheap)
+#ifndef ADC_SAMPLER_OVERSAMPLE
+#define ADC_SAMPLER_OVERSAMPLE 4
+#endif
+
+// Channels sampled: ADC0..ADC(n-1) (A0=line R, A1=line M, A2=line L, A3=battery)
+#define ADC_SAMPLER_CHANNELS 4
+
+class AdcSampler {
+public:
+  AdcSampler();
+
+  // Configure ADC and kick off the first conversion.
+  // Blocks (bounded) until the first full sweep is available.
+  void start();
+  void stop();
+  bool isRunning() const { return running; }
+
+  // Latest averaged sample for an Arduino analog pin (A0..A3), O(1)
+  uint16_t get(uint8_t pin) const;
+
+  // Consistent snapshot of all channels from the same sweep
+  void snapshot(uint16_t* out) const;
+
+  // millis() when the current front buffer was published
+  unsigned long getSampleTime() const;
+
+  // Completed sweeps since start (wraps)
+  uint16_t getSweepCount() const;
+
+  // ISR entry point (called from ADC_vect)
+  void onConversion(uint16_t value);
+
+private:
+  volatile uint16_t samples[2][ADC_SAMPLER_CHANNELS];
+  volatile uint8_t front;          // Index readers use; ISR writes the other
+  volatile unsigned long sampleTime;
+  volatile uint16_t sweepCount;
+  bool running;
+
+  // ISR-owned state
+  uint16_t accum;
+  uint8_t channel;
+  uint8_t conversion;              // 0 = settling, 1..N = accumulated
+
+  void selectChannel(uint8_t ch);
+};
+
+extern AdcSampler adcSampler;
+
+#endif // ADC_SAMPLER_H
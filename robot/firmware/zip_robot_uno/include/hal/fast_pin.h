@@ -0,0 +1,144 @@
+/*
+ * Fast Pin HAL - Compile-time port I/O
+ *
+ * digitalWrite()/analogWrite() look up port, bit mask and timer in PROGMEM
+ * tables on every call (~4-5us each). FastPin<N>/FastPwm<N> resolve the
+ * same information at compile time from the Arduino pin number, so with a
+ * constant pin a write folds down to a single SBI/CBI (2 cycles) or an
+ * OCRnx store.
+ *
+ * Pin numbers come from the board header (PIN_MOTOR_AIN_1 etc.), so the
+ * mapping stays single-source. UNO (ATmega328P) mapping only:
+ *   D0-D7 = PORTD0-7, D8-D13 = PORTB0-5, A0-A5 (14-19) = PORTC0-5
+ *
+ * Semantics match the Arduino core: FastPwm<N>::write(0) / write(255)
+ * disconnect the timer and drive the pin LOW / HIGH, like analogWrite().
+ * pinMode() is still used for setup (not on any hot path).
+ */
+
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Use direct port I/O (default: enabled on AVR).
+// Off-target builds fall back to digitalWrite()/analogWrite().
+#ifndef FAST_PIN_ENABLED
+#if defined(__AVR_ATmega328P__)
+#define FAST_PIN_ENABLED 1
+#else
+#define FAST_PIN_ENABLED 0
+#endif
+#endif
+
+// Run the digitalWrite vs FastPin timing benchmark at boot (env:uno_pin_bench)
+#ifndef FAST_PIN_BENCHMARK
+#define FAST_PIN_BENCHMARK 0
+#endif
+
+#define FAST_PIN_ALWAYS_INLINE inline __attribute__((always_inline))
+
+// ============================================================================
+// DIGITAL PIN
+// ============================================================================
+
+template <uint8_t PIN>
+struct FastPin {
+  static_assert(PIN < 20, "FastPin: UNO has D0-D13 and A0-A5 (14-19) only");
+
+#if FAST_PIN_ENABLED
+  static constexpr uint8_t bit = (PIN < 8) ? PIN : ((PIN < 14) ? (PIN - 8) : (PIN - 14));
+  static constexpr uint8_t mask = (uint8_t)(1 << bit);
+
+  // Constant PORTx in low I/O space + constant mask => SBI/CBI
+  static FAST_PIN_ALWAYS_INLINE void high() {
+    if (PIN < 8) PORTD |= mask; else if (PIN < 14) PORTB |= mask; else PORTC |= mask;
+  }
+  static FAST_PIN_ALWAYS_INLINE void low() {
+    if (PIN < 8) PORTD &= (uint8_t)~mask; else if (PIN < 14) PORTB &= (uint8_t)~mask; else PORTC &= (uint8_t)~mask;
+  }
+  static FAST_PIN_ALWAYS_INLINE bool read() {
+    if (PIN < 8) return (PIND & mask) != 0;
+    if (PIN < 14) return (PINB & mask) != 0;
+    return (PINC & mask) != 0;
+  }
+#else
+  static FAST_PIN_ALWAYS_INLINE void high() { digitalWrite(PIN, HIGH); }
+  static FAST_PIN_ALWAYS_INLINE void low() { digitalWrite(PIN, LOW); }
+  static FAST_PIN_ALWAYS_INLINE bool read() { return digitalRead(PIN) == HIGH; }
+#endif
+
+  static FAST_PIN_ALWAYS_INLINE void write(bool level) {
+    if (level) high(); else low();
+  }
+};
+
+// ============================================================================
+// PWM PIN
+// ============================================================================
+
+#if FAST_PIN_ENABLED
+// Timer output-compare for each PWM-capable UNO pin (matches wiring_analog.c)
+template <uint8_t PIN> struct FastPwmTimer;  // Undefined => not a PWM pin
+
+template <> struct FastPwmTimer<3> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR2A |= _BV(COM2B1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR2A &= (uint8_t)~_BV(COM2B1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR2B = v; }
+};
+template <> struct FastPwmTimer<5> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR0A |= _BV(COM0B1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR0A &= (uint8_t)~_BV(COM0B1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR0B = v; }
+};
+template <> struct FastPwmTimer<6> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR0A |= _BV(COM0A1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR0A &= (uint8_t)~_BV(COM0A1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR0A = v; }
+};
+template <> struct FastPwmTimer<9> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR1A |= _BV(COM1A1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR1A &= (uint8_t)~_BV(COM1A1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR1A = v; }
+};
+template <> struct FastPwmTimer<10> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR1A |= _BV(COM1B1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR1A &= (uint8_t)~_BV(COM1B1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR1B = v; }
+};
+template <> struct FastPwmTimer<11> {
+  static FAST_PIN_ALWAYS_INLINE void connect() { TCCR2A |= _BV(COM2A1); }
+  static FAST_PIN_ALWAYS_INLINE void disconnect() { TCCR2A &= (uint8_t)~_BV(COM2A1); }
+  static FAST_PIN_ALWAYS_INLINE void duty(uint8_t v) { OCR2A = v; }
+};
+#endif
+
+template <uint8_t PIN>
+struct FastPwm {
+#if FAST_PIN_ENABLED
+  // Same behaviour as analogWrite(): 0/255 become plain digital levels
+  static FAST_PIN_ALWAYS_INLINE void write(uint8_t value) {
+    if (value == 0) {
+      FastPwmTimer<PIN>::disconnect();
+      FastPin<PIN>::low();
+    } else if (value == 255) {
+      FastPwmTimer<PIN>::disconnect();
+      FastPin<PIN>::high();
+    } else {
+      FastPwmTimer<PIN>::duty(value);
+      FastPwmTimer<PIN>::connect();
+    }
+  }
+#else
+  static FAST_PIN_ALWAYS_INLINE void write(uint8_t value) { analogWrite(PIN, value); }
+#endif
+};
+
+// Boot-time timing comparison (no-op unless FAST_PIN_BENCHMARK)
+void runFastPinBenchmark();
+
+#endif // FAST_PIN_H
@@ -33,8 +33,13 @@ public:
   void readRaw(int16_t* accelX, int16_t* accelY, int16_t* accelZ,
                int16_t* gyroX, int16_t* gyroY, int16_t* gyroZ);
   
+  // Read gyro Z only (offset-corrected LSB, 131 per deg/s) - 2-byte read
+  // for fast polling (motion onset detection)
+  int16_t readGyroZ();
+  
   // Get fused yaw estimate (complementary filter)
   float getYaw();  // Returns yaw in degrees (converted from int16_t)
+  int16_t getYawX10() const { return yaw; }
   
   // Calibration
   void calibrate();  // Calibrate gyro offset
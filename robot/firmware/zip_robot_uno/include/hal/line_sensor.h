@@ -15,11 +15,12 @@ public:
   
   void init();
   
-  // Read raw ADC values
+  // Read raw ADC values (cached by AdcSampler, no blocking conversion)
   uint16_t readLeft() const;
   uint16_t readMiddle() const;
   uint16_t readRight() const;
   void readAll(uint16_t* left, uint16_t* middle, uint16_t* right) const;
+  unsigned long getSampleTime() const;  // millis() of the cached sweep
   
   // Calibration
   void calibrate();  // Run calibration routine
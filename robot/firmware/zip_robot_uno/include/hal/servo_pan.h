@@ -15,7 +15,15 @@ public:
   ServoPan();
   
   void init();
-  void setAngle(uint8_t angle);  // 0-180 degrees
+  void setAngle(uint8_t angle);  // 0-180 degrees (blocking, 450ms)
+  
+  // Non-blocking multi-step moves (range scan):
+  // attachHold() once, moveNoWait() per step, release() when done.
+  // moveNoWait() returns the estimated travel time in ms.
+  void attachHold();
+  uint16_t moveNoWait(uint8_t angle);
+  void release();
+  bool isHeld() const { return held; }
   uint8_t getAngle() const { return currentAngle; }
   
   // Safety limits
@@ -27,6 +35,7 @@ private:
   uint8_t currentAngle;
   uint8_t minAngle;
   uint8_t maxAngle;
+  bool held;
 };
 
 #endif // SERVO_PAN_H
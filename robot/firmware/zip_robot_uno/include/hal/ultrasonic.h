@@ -26,13 +26,20 @@ public:
   // Check if reading is available (for non-blocking operation)
   bool isReadingAvailable() const;
   
+  // Immediate measurement, bypasses rate limit and refreshes the cache.
+  // Shorter timeouts bound the blocking time to the useful range.
+  uint16_t measure(unsigned long timeout_us = ULTRASONIC_TIMEOUT_US);
+  
+  // millis() when the cached distance was measured
+  unsigned long getLastReadTime() const { return lastReadTime; }
+  
 private:
   unsigned long lastReadTime;
   uint16_t lastDistance;
   uint8_t minIntervalMs;  // Minimum time between reads (for rate limiting) - changed to uint8_t to save RAM
   
   // Blocking read (fallback)
-  uint16_t readBlocking();
+  uint16_t readBlocking(unsigned long timeout_us = ULTRASONIC_TIMEOUT_US);
 };
 
 #endif // ULTRASONIC_H
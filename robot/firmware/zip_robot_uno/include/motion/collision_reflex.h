@@ -0,0 +1,101 @@
+/*
+ * Collision Reflex (Time-To-Collision Brake)
+ *
+ * Onboard obstacle reflex that does not depend on the host round trip.
+ * Estimates time-to-collision from consecutive ultrasonic samples and the
+ * commanded forward speed, then caps or zeroes positive v before mixing.
+ * Reverse and pure rotation are never limited so the robot can back off.
+ *
+ * Applied to N=200 setpoints (MotionController) and N=210 macros
+ * (MacroEngine). N=999 direct motor PWM is a bench test that bypasses both
+ * and is deliberately not limited.
+ *
+ * Emits a single {reflex:...} event frame each time it starts braking.
+ */
+
+#ifndef COLLISION_REFLEX_H
+#define COLLISION_REFLEX_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable TTC reflex globally (default: enabled)
+#ifndef COLLISION_REFLEX_ENABLED
+#define COLLISION_REFLEX_ENABLED 1
+#endif
+
+// Brake when TTC drops below this (ms). Runtime-adjustable via N=140 D1=6.
+// Forward v is scaled down linearly between brake and 2x brake TTC.
+#ifndef REFLEX_TTC_BRAKE_MS_DEFAULT
+#define REFLEX_TTC_BRAKE_MS_DEFAULT  600
+#endif
+
+// Hard stop inside this distance regardless of speed (cm)
+#ifndef REFLEX_STOP_DISTANCE_CM
+#define REFLEX_STOP_DISTANCE_CM  12
+#endif
+
+// Commanded-speed model: cm/s per PWM unit, x100 (35 => 255 PWM ~ 89 cm/s)
+#ifndef REFLEX_CM_S_PER_PWM_X100
+#define REFLEX_CM_S_PER_PWM_X100  35
+#endif
+
+// Ignore samples older than this when estimating (ms)
+#ifndef REFLEX_SAMPLE_MAX_AGE_MS
+#define REFLEX_SAMPLE_MAX_AGE_MS  300
+#endif
+
+// ============================================================================
+// COLLISION REFLEX CLASS
+// ============================================================================
+
+class CollisionReflex {
+public:
+  CollisionReflex();
+
+  void init();
+
+  // Feed a new ultrasonic sample (call from task_sensors_slow)
+  // distance_cm: 0 = timeout/no echo (treated as clear)
+  // sample_ms: millis() when the echo was measured
+  void updateDistance(uint16_t distance_cm, unsigned long sample_ms);
+
+  // Limit forward command based on current TTC estimate.
+  // Returns v unchanged when clear, reduced or 0 when braking.
+  int16_t limitForward(int16_t v);
+
+  // ---- Configuration (N=140 D1=6) ----
+  void setBrakeTtcMs(uint16_t ms) { brakeTtcMs = ms; }  // 0 = disabled
+  uint16_t getBrakeTtcMs() const { return brakeTtcMs; }
+
+  // ---- Getters for diagnostics (N=120) ----
+  uint16_t getInterventions() const { return interventions; }
+  uint16_t getBrakeEvents() const { return brakeEvents; }
+  uint16_t getLastTtcMs() const { return lastTtcMs; }
+  bool isBraking() const { return braking; }
+
+private:
+  uint16_t brakeTtcMs;
+
+  // Last two samples for closing-speed estimate
+  uint16_t lastDistance;
+  unsigned long lastSampleMs;
+  int16_t closingCmS;  // Filtered measured closing speed (cm/s, + = approaching)
+  int16_t lastInstCmS; // Previous unfiltered sample-to-sample rate
+
+  // Telemetry
+  uint16_t interventions;  // Control ticks where v was reduced
+  uint16_t brakeEvents;    // Transitions into full brake
+  uint16_t lastTtcMs;
+  bool braking;
+
+  void emitEvent(uint16_t distance_cm, uint16_t ttc_ms);
+};
+
+// Global instance
+extern CollisionReflex collisionReflex;
+
+#endif // COLLISION_REFLEX_H
@@ -4,6 +4,14 @@
  * Battery-aware PWM limiting with deadband compensation, slew-rate limiting,
  * and kickstart pulse for torque-safe motor control.
  * 
+ * Battery sag feedforward: motor speed follows duty * loaded pack voltage,
+ * so the same PWM drives slower as the pack drains. The layer fits
+ * V = Voc - sag * load over the 10Hz battery samples (load = applied duty,
+ * both wheels, 0..1; exponentially weighted least squares) and scales each
+ * commanded PWM by nominal / (Voc - sag * commanded load) before the caps.
+ * Voc and sag move slowly, so a dip under acceleration does not feed back
+ * into the gain; the battery-state caps still apply afterwards.
+ * 
  * All PWM commands route through this layer before reaching the TB6612 driver.
  */
 
@@ -36,6 +44,11 @@
 #define STALL_DETECT_ENABLED 0
 #endif
 
+// Count per-stage interventions and slew lag (N=120 sl:/lag:, {sl:...})
+#ifndef SAFETY_STATS_ENABLED
+#define SAFETY_STATS_ENABLED 1
+#endif
+
 // ============================================================================
 // BATTERY THRESHOLDS (millivolts)
 // ============================================================================
@@ -108,6 +121,44 @@
 #define PWM_CAP_CRIT  100
 #endif
 
+// ============================================================================
+// BATTERY SAG FEEDFORWARD
+// ============================================================================
+
+// Enable/disable PWM scaling to a nominal-voltage equivalent (default: enabled)
+#ifndef BATT_FF_ENABLED
+#define BATT_FF_ENABLED  1
+#endif
+
+// Pack voltage under load that the host's v/w -> PWM mapping is tuned at
+#ifndef BATT_FF_NOMINAL_MV
+#define BATT_FF_NOMINAL_MV  7400
+#endif
+
+// Gain limits in percent (a full pack scales down, a drained one up)
+#ifndef BATT_FF_GAIN_MIN_PCT
+#define BATT_FF_GAIN_MIN_PCT  85
+#endif
+
+#ifndef BATT_FF_GAIN_MAX_PCT
+#define BATT_FF_GAIN_MAX_PCT  135
+#endif
+
+// Estimator weight per 10Hz sample (0.1 = ~1s memory)
+#ifndef BATT_FF_ALPHA
+#define BATT_FF_ALPHA  0.1f
+#endif
+
+// Largest plausible sag at full load on both wheels (mV)
+#ifndef BATT_FF_SAG_MAX_MV
+#define BATT_FF_SAG_MAX_MV  1500
+#endif
+
+// Below this the pack is absent (USB power) or the reading is bogus: gain 1.0
+#ifndef BATT_FF_MIN_MV
+#define BATT_FF_MIN_MV  6000
+#endif
+
 // ============================================================================
 // KICKSTART CONFIGURATION
 // ============================================================================
@@ -131,6 +182,25 @@ enum BatteryState : uint8_t {
   BATT_CRIT = 2   // < 7000mV - minimal capability
 };
 
+// Intervention accounting. Stage counters are free-running and count
+// applyLimits() calls in which the stage changed either wheel; the host diffs
+// them against calls. There is one call per 20ms control tick plus one per
+// applied setpoint, so calls are not a time base. Lag is the slew limiter
+// trailing its target, in calls: a run starts when the capped target moves
+// out of reach and ends when the output arrives there.
+struct DriveLimitStats {
+  uint16_t calls;         // applyLimits() calls
+  uint16_t feedforward;   // Battery sag gain moved the target
+  uint16_t cap;           // PWM cap clipped the target
+  uint16_t slew;          // Ramp held the output short of the target
+  uint16_t kick;          // Kickstart raised the output
+  uint16_t deadband;      // Deadband bumped (or snapped) the output
+  uint8_t lagRunCalls;    // Current lag run (0 = output on target)
+  uint8_t lagLastCalls;   // Length of the last completed run
+  uint8_t lagPeakCalls;   // Longest run since the last reset
+  uint8_t gapPwm;         // |target - output| after slew, worse wheel, last call
+};
+
 // ============================================================================
 // DRIVE SAFETY LAYER CLASS
 // ============================================================================
@@ -160,6 +230,8 @@ public:
   void setDecelStep(uint8_t step) { decelStepOverride = step; }
   void setMaxPwmCap(uint8_t cap) { maxPwmOverride = cap; }
   void setKickEnabled(bool en) { kickEnabledOverride = en ? 1 : 0; }
+  void setKickTicks(uint8_t ticks) { kickTicks = ticks; }
+  void setFeedforwardNominal(uint16_t mv) { ffNominalMv = mv; }  // 0 = off
   
   // Clear overrides (use battery-based defaults)
   void clearAccelOverride() { accelStepOverride = 0; }
@@ -176,8 +248,16 @@ public:
   uint8_t getEffectiveDecelStep() const;
   uint8_t getEffectiveMaxPwm() const;
   bool isKickEnabled() const;
+  uint8_t getKickTicks() const { return kickTicks; }
   int16_t getCurrentLimitedL() const { return currentLimitedL; }
   int16_t getCurrentLimitedR() const { return currentLimitedR; }
+  uint8_t getFeedforwardGainPct() const { return (uint8_t)((ffGainQ8 * 100U + 128) >> 8); }
+  uint16_t getOpenCircuitMv() const { return ffVocMv; }
+  uint16_t getSagMv() const { return ffSagMv; }
+  
+  // Intervention counters and slew lag (zeros with SAFETY_STATS_ENABLED 0)
+  const DriveLimitStats& getLimitStats() const { return limitStats; }
+  void resetLimitStats();
   
 #if STALL_DETECT_ENABLED
   bool isStallSuspected() const { return stallSuspected; }
@@ -200,6 +280,7 @@ private:
   uint8_t kickLeftEndTick;   // Tick count when kick ends (0 = inactive)
   uint8_t kickRightEndTick;
   uint8_t tickCounter;       // Rolling tick counter (0-255)
+  uint8_t kickTicks;         // Kick duration (KICKSTART_DURATION_TICKS or calibrated)
   
   // Runtime overrides (0 = use battery-based default, 0xFF for kick = use default)
   uint8_t accelStepOverride;
@@ -207,6 +288,19 @@ private:
   uint8_t maxPwmOverride;
   uint8_t kickEnabledOverride;  // 0=disabled, 1=enabled, 0xFF=use default
   
+  // Sag estimator (weighted means/moments of load x and voltage v) and the
+  // resulting fit, 0 until the first battery sample
+  float ffMeanX;
+  float ffMeanV;
+  float ffVarX;
+  float ffCovXV;
+  uint16_t ffVocMv;
+  uint16_t ffSagMv;       // Drop at full load on both wheels
+  uint16_t ffNominalMv;   // 0 = feedforward off
+  uint16_t ffGainQ8;      // Last applied gain (256 = 1.0)
+  
+  DriveLimitStats limitStats;
+  
 #if STALL_DETECT_ENABLED
   // Stall detection state
   bool stallSuspected;
@@ -216,6 +310,12 @@ private:
 
   // ---- Internal helper methods ----
   
+  // Feed one battery sample into the sag fit
+  void updateSagEstimate(uint16_t voltage_mv);
+  
+  // Gain (Q8) for a commanded load, |L| + |R| in PWM units
+  uint16_t feedforwardGain(uint16_t loadPwm) const;
+  
   // Apply slew rate limiting to a single value
   int16_t applySlewLimit(int16_t current, int16_t target, uint8_t accelStep, uint8_t decelStep);
   
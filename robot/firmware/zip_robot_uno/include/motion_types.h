@@ -33,6 +33,33 @@ struct SetpointCommand {
   uint32_t timestamp; // When command was received
 };
 
+// Admission result for a sequenced setpoint (N=200 with D3/D4)
+enum SetpointAdmit {
+  SETPOINT_ADMIT_OK = 0,
+  SETPOINT_ADMIT_STALE = 1,     // Older than its own TTL on arrival
+  SETPOINT_ADMIT_REORDERED = 2  // seq not newer than the last applied one
+};
+
+// Sequenced setpoint bookkeeping, reported in the {sq:...} cumulative ack.
+// Counters are free-running uint16_t; the host works with differences.
+struct SetpointSeqStats {
+  uint16_t lastSeq;     // Last applied seq (0 = none yet)
+  uint16_t applied;     // Sequenced setpoints applied
+  uint16_t stale;       // Rejected: age > TTL
+  uint16_t reordered;   // Rejected: duplicate or older seq
+  uint32_t lastRxMs;    // millis() of the last sequenced setpoint (any outcome)
+};
+
+// Setpoint inter-arrival estimate behind the adaptive TTL (N=120 ttl: field).
+// Fixed point as TCP keeps SRTT/RTTVAR: mean in 1/8 ms, jitter in 1/4 ms.
+struct SetpointArrivalStats {
+  uint32_t lastMs;      // millis() of the last setpoint
+  uint16_t meanX8;      // EWMA inter-arrival period (gain 1/8)
+  uint16_t jitterX4;    // EWMA mean deviation of the period (gain 1/4)
+  uint16_t ttlMs;       // TTL given to the last setpoint
+  uint8_t samples;      // Gaps measured in the current stream (saturates)
+};
+
 // Macro state structure
 struct MacroState {
   MacroID id;
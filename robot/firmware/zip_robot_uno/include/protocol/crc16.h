@@ -8,6 +8,7 @@
 #define CRC16_H
 
 #include <Arduino.h>
+#include <avr/pgmspace.h>
 
 class CRC16 {
 public:
@@ -18,11 +19,8 @@ public:
   static uint16_t update(uint16_t crc, uint8_t byte);
   
 private:
-  static const uint16_t POLYNOMIAL = 0x1021;  // CRC16-CCITT polynomial
-  static uint16_t crcTable[256];
-  static bool tableInitialized;
-  
-  static void initTable();
+  static const uint16_t POLYNOMIAL = 0x1021;  // CRC16-CCITT polynomial (table generator)
+  static const uint16_t crcTable[256];         // PROGMEM
 };
 
 #endif // CRC16_H
@@ -9,6 +9,7 @@
 
 #include <Arduino.h>
 #include "protocol_types.h"
+#include "../core/ram_overlay.h"
 
 // Decoded message structure (minimized for RAM)
 struct DecodedMessage {
@@ -46,7 +47,7 @@ private:
   };
   
   State state;
-  uint8_t buffer[48];   // Reduced from 128 to save RAM (max frame: header+len+type+seq+32+crc = 38)
+  uint8_t* buffer;      // RAM overlay arena while a frame is open (OVERLAY_BINARY_FRAME_MAX)
   uint8_t bufferPos;
   uint8_t expectedLen;
   uint8_t expectedPayloadLen;
@@ -1,11 +1,23 @@
 /*
  * Motor Self-Test Header
+ *
+ * Runs as a coroutine from task_control_loop (after the init sequence),
+ * one motor at a time: left fwd, right fwd, left back, right back.
  */
 
 #ifndef SELF_TEST_H
 #define SELF_TEST_H
 
-bool runSelfTest();
+// Queue the self-test (no-op while it is running)
+void selfTestStart();
 
-#endif // SELF_TEST_H
+// Advance the self-test. Returns true while it owns the motors.
+bool selfTestUpdate();
+
+// Queued or running (motion commands must not drive the motors)
+bool selfTestActive();
 
+// Stop it where it is and zero the motors (N=201 and other stops)
+void selfTestAbort();
+
+#endif // SELF_TEST_H
@@ -0,0 +1,89 @@
+/*
+ * Host Microbenchmark Harness (env:native_bench)
+ *
+ * Minimal Google Benchmark-style runner for the protocol and motion kernels
+ * of all three firmwares (UNO, ESP32 bridge, ESP32 camera). Each case builds
+ * a deterministic workload once (untimed), then runs whole passes over it:
+ *
+ *   BENCH_CASE(name, setup, pass)
+ *     setup() -> Workload   ops/bytes per pass (untimed)
+ *     pass()  -> uint32_t   one pass over the workload, returns a check hash
+ *
+ * The check hash of the first pass must match the stored baseline exactly
+ * (the kernel still does the same thing); the time per op is compared with
+ * a tolerance (the kernel did not get slower).
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct Workload {
+  uint32_t ops;    // Kernel calls per pass (bytes for byte-at-a-time kernels)
+  uint32_t bytes;  // Input bytes per pass (0 = not a byte stream)
+};
+
+typedef Workload (*SetupFn)();
+typedef uint32_t (*PassFn)();
+
+struct Case {
+  const char* name;
+  SetupFn setup;
+  PassFn pass;
+};
+
+std::vector<Case>& registry();
+
+struct Registrar {
+  Registrar(const char* name, SetupFn setup, PassFn pass) {
+    Case c = {name, setup, pass};
+    registry().push_back(c);
+  }
+};
+
+#define BENCH_CASE(name, setup, pass) \
+  static bench::Registrar bench_reg_##name(#name, setup, pass)
+
+// ---- Workload helpers ----
+
+// Deterministic xorshift32 (same streams on every host)
+class Rng {
+public:
+  explicit Rng(uint32_t seed) : s(seed ? seed : 1) {}
+  uint32_t next() {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+  }
+  int32_t range(int32_t lo, int32_t hi) {  // Inclusive
+    return lo + (int32_t)(next() % (uint32_t)(hi - lo + 1));
+  }
+  bool chance(uint32_t percent) { return next() % 100 < percent; }
+private:
+  uint32_t s;
+};
+
+// FNV-1a, for check hashes
+static inline uint32_t mix(uint32_t h, uint32_t v) {
+  for (int i = 0; i < 4; i++) {
+    h ^= (v >> (i * 8)) & 0xFF;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static const uint32_t HASH_SEED = 2166136261u;
+
+// Appends printf-formatted text to a byte stream
+void appendf(std::string& out, const char* fmt, ...);
+
+}  // namespace bench
+
+#endif // BENCH_H
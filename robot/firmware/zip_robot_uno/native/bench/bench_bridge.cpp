@@ -0,0 +1,193 @@
+/*
+ * ESP32 Bridge Kernels: isMotionCommand, isValidJsonLine
+ *
+ * isMotionCommand() runs on every WebSocket message before rate limiting;
+ * isValidJsonLine() on every UART line from the UNO before broadcast.
+ */
+
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "json_line.h"  // zip_esp32_bridge/include
+
+using bench::Rng;
+using bench::Workload;
+using bench::mix;
+
+// Messages packed back to back, NUL-terminated (isValidJsonLine needs it)
+static std::string s_msgs;
+static std::vector<uint32_t> s_offsets;
+static std::vector<uint32_t> s_lengths;
+
+static void addMessage(const std::string& m) {
+  s_offsets.push_back((uint32_t)s_msgs.size());
+  s_lengths.push_back((uint32_t)m.size());
+  s_msgs += m;
+  s_msgs.push_back('\0');
+}
+
+static Workload messageWorkload() {
+  uint32_t bytes = 0;
+  for (size_t i = 0; i < s_lengths.size(); i++) {
+    bytes += s_lengths[i];
+  }
+  Workload w = {(uint32_t)s_offsets.size(), bytes};
+  return w;
+}
+
+static void clearMessages() {
+  s_msgs.clear();
+  s_offsets.clear();
+  s_lengths.clear();
+}
+
+// ---- isMotionCommand ----
+
+static Workload setupMotionRealistic() {
+  // WebSocket controller traffic: setpoints dominate
+  Rng rng(0x4D07u);
+  clearMessages();
+  for (int i = 0; i < 2048; i++) {
+    std::string m;
+    switch (rng.next() % 8) {
+      case 0: bench::appendf(m, "{\"N\":0,\"H\":\"hello\"}"); break;
+      case 1: bench::appendf(m, "{\"N\":201,\"H\":\"stop\"}"); break;
+      case 2: bench::appendf(m, "{\"N\":999,\"H\":\"m\",\"D1\":%d,\"D2\":%d}",
+                             (int)rng.range(-255, 255), (int)rng.range(-255, 255)); break;
+      case 3: bench::appendf(m, "{\"N\": 200, \"H\": \"sp\", \"D1\": %d, \"D2\": %d, \"T\": 200}",
+                             (int)rng.range(-255, 255), (int)rng.range(-255, 255)); break;
+      default: bench::appendf(m, "{\"N\":200,\"H\":\"sp\",\"D1\":%d,\"D2\":%d,\"T\":200}",
+                              (int)rng.range(-255, 255), (int)rng.range(-255, 255)); break;
+    }
+    addMessage(m);
+  }
+  return messageWorkload();
+}
+
+static Workload setupMotionAdversarial() {
+  // Worst cases for the scan: "N" late or absent in WS_MAX_PAYLOAD-sized
+  // messages, quote-heavy strings, near-miss keys, long digit runs
+  Rng rng(0xA77Cu);
+  clearMessages();
+  for (int i = 0; i < 1024; i++) {
+    std::string m;
+    switch (rng.next() % 5) {
+      case 0: {  // "N" at the very end
+        m = "{\"H\":\"";
+        while (m.size() < WS_MAX_PAYLOAD - 16) {
+          m.push_back((char)('a' + rng.next() % 26));
+        }
+        m += "\",\"N\":200}";
+        break;
+      }
+      case 1: {  // No "N" at all
+        m = "{";
+        while (m.size() < WS_MAX_PAYLOAD - 2) {
+          bench::appendf(m, "\"K%u\":%u,", rng.next() % 100, rng.next() % 1000);
+        }
+        m += "}";
+        break;
+      }
+      case 2: {  // Quote storm with near-miss keys
+        m = "{";
+        while (m.size() < WS_MAX_PAYLOAD - 8) {
+          m += (rng.next() & 1) ? "\"N\"\"" : "\"n\":\"";
+        }
+        m += "}";
+        break;
+      }
+      case 3:  // Long (but non-overflowing) digit run
+        bench::appendf(m, "{\"N\":  \t %u%u,\"H\":\"x\"}", 100000 + rng.next() % 900000, rng.next() % 999);
+        break;
+      default:  // Short fragments below the 7-byte minimum
+        m = (rng.next() & 1) ? "{\"N\":" : "\"N\":2";
+        break;
+    }
+    addMessage(m);
+  }
+  return messageWorkload();
+}
+
+static uint32_t passMotion() {
+  uint32_t h = bench::HASH_SEED;
+  uint32_t motion = 0;
+  const char* base = s_msgs.data();
+  for (size_t i = 0; i < s_offsets.size(); i++) {
+    if (isMotionCommand(base + s_offsets[i], s_lengths[i])) {
+      motion++;
+      h = mix(h, (uint32_t)i);
+    }
+  }
+  return mix(h, motion);
+}
+
+BENCH_CASE(bridge_motion_realistic, setupMotionRealistic, passMotion);
+BENCH_CASE(bridge_motion_adversarial, setupMotionAdversarial, passMotion);
+
+// ---- isValidJsonLine ----
+
+static Workload setupLinesRealistic() {
+  // UNO replies as the bridge sees them: acks, sensor values, diagnostics,
+  // boot banner lines
+  Rng rng(0x11E5u);
+  clearMessages();
+  for (int i = 0; i < 2048; i++) {
+    std::string m;
+    switch (rng.next() % 8) {
+      case 0: m = "{hello_ok}"; break;
+      case 1: bench::appendf(m, "{us_%d}", (int)rng.range(2, 400)); break;
+      case 2: bench::appendf(m, "{bat_%d}", (int)rng.range(6500, 8400)); break;
+      case 3: bench::appendf(m, "{I%dM%dR0,%d,%d,ram:%d,min:%d,err:0,0,0,0,0,stk:%d}",
+                             (int)rng.range(0, 2), (int)rng.range(0, 3), (int)rng.range(-255, 255),
+                             (int)rng.range(-255, 255), (int)rng.range(600, 900),
+                             (int)rng.range(500, 700), (int)rng.range(400, 650)); break;
+      case 4: bench::appendf(m, "INIT:done batt=%d imu=1 yaw=%d", (int)rng.range(6500, 8400),
+                             (int)rng.range(-40, 40)); break;
+      default: m = "{stop_ok}"; break;
+    }
+    addMessage(m);
+  }
+  return messageWorkload();
+}
+
+static Workload setupLinesAdversarial() {
+  // Whitespace padding on both ends (both trims walk it), near-miss framing
+  Rng rng(0x7AB5u);
+  clearMessages();
+  for (int i = 0; i < 1024; i++) {
+    std::string m;
+    uint32_t pad = rng.range(0, 120);
+    for (uint32_t k = 0; k < pad; k++) {
+      m.push_back((rng.next() & 1) ? ' ' : '\t');
+    }
+    switch (rng.next() % 4) {
+      case 0: m += "{sp_ok}"; break;
+      case 1: m += "{sp_ok"; break;
+      case 2: m += "sp_ok}"; break;
+      default: m += "{"; break;
+    }
+    uint32_t tail = rng.range(0, 120);  // Stays under MAX_LINE_LENGTH
+    for (uint32_t k = 0; k < tail; k++) {
+      m.push_back((rng.next() & 1) ? ' ' : '\t');
+    }
+    addMessage(m);
+  }
+  return messageWorkload();
+}
+
+static uint32_t passLines() {
+  uint32_t h = bench::HASH_SEED;
+  uint32_t valid = 0;
+  const char* base = s_msgs.data();
+  for (size_t i = 0; i < s_offsets.size(); i++) {
+    if (isValidJsonLine(base + s_offsets[i])) {
+      valid++;
+      h = mix(h, (uint32_t)i);
+    }
+  }
+  return mix(h, valid);
+}
+
+BENCH_CASE(bridge_lines_realistic, setupLinesRealistic, passLines);
+BENCH_CASE(bridge_lines_adversarial, setupLinesAdversarial, passLines);
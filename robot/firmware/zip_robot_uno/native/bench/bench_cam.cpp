@@ -0,0 +1,238 @@
+/*
+ * ESP32 Camera Kernels
+ *
+ * uart_frame_available / uart_read_frame: runs the UartRing behind both
+ * calls (zip_esp32_cam/src/drivers/uart) the way the app loop drives it:
+ * each iteration uart_tick() moves one UART FIFO burst into the ring, then
+ * the loop reads at most one frame into a 64-byte buffer. ops = loop
+ * iterations.
+ *
+ * Stream frame slots: the FrameSlots handoff (zip_esp32_cam/src/web) between
+ * the capture task and the stream senders, in virtual time - a frame every
+ * 40ms, each send holding its slot for a drawn link time. ops = frames.
+ */
+
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uart_ring.h"    // zip_esp32_cam/src/drivers/uart
+#include "frame_slots.h"  // zip_esp32_cam/src/web
+
+using bench::Rng;
+using bench::Workload;
+using bench::mix;
+
+static const size_t CAM_RX_RING_SIZE = 512;  // CONFIG_UART_RX_BUFFER_SIZE
+static const size_t CAM_FIFO_BURST = 12;     // 1ms loop at 115200 baud
+static const size_t CAM_FRAME_BUF = 64;      // app_main/task_architecture buffer
+
+static UartRing<CAM_RX_RING_SIZE> s_ring;
+static std::string s_uart;
+
+static Workload uartWorkload() {
+  uint32_t loops = (uint32_t)((s_uart.size() + CAM_FIFO_BURST - 1) / CAM_FIFO_BURST);
+  Workload w = {loops, (uint32_t)s_uart.size()};
+  return w;
+}
+
+static Workload setupFramesRealistic() {
+  // UNO replies and heartbeats, newline-terminated
+  Rng rng(0xCA3Eu);
+  s_uart.clear();
+  while (s_uart.size() < 16384) {
+    switch (rng.next() % 6) {
+      case 0: s_uart += "{Heartbeat}\n"; break;
+      case 1: bench::appendf(s_uart, "{us_%d}\n", (int)rng.range(2, 400)); break;
+      case 2: s_uart += "{hello_ok}\n"; break;
+      default: s_uart += "{sp_ok}\n"; break;
+    }
+  }
+  return uartWorkload();
+}
+
+static Workload setupFramesAdversarial() {
+  // Boot noise without '}' (has_frame scans the whole ring), frames longer
+  // than the 64-byte read buffer, '{' storms and binary line noise
+  Rng rng(0xD15Cu);
+  s_uart.clear();
+  while (s_uart.size() < 16384) {
+    switch (rng.next() % 4) {
+      case 0: {
+        uint32_t n = rng.range(64, 400);
+        for (uint32_t i = 0; i < n; i++) {
+          char c = (char)(rng.next() & 0xFF);
+          s_uart.push_back(c == '}' ? '~' : c);
+        }
+        break;
+      }
+      case 1: {
+        s_uart += "{diag_";
+        uint32_t n = rng.range(60, 120);
+        for (uint32_t i = 0; i < n; i++) {
+          s_uart.push_back((char)('0' + rng.next() % 10));
+        }
+        s_uart += "}\n";
+        break;
+      }
+      case 2:
+        s_uart += "{{{{{{{{{{{{{{{{sp_ok}\n";
+        break;
+      default:
+        s_uart += "{sp_ok}\n";
+        break;
+    }
+  }
+  return uartWorkload();
+}
+
+static uint32_t passFrames() {
+  s_ring.clear();
+  uint32_t h = bench::HASH_SEED;
+  uint32_t frames = 0;
+  uint32_t dropped = 0;
+  uint32_t discarded = 0;
+  char frame[CAM_FRAME_BUF];
+  size_t pos = 0;
+  size_t n = s_uart.size();
+
+  while (pos < n) {
+    // uart_tick(): stop at full, leave the rest in the UART FIFO
+    size_t burst = 0;
+    while (burst < CAM_FIFO_BURST && pos < n) {
+      if (s_ring.full()) {
+        dropped++;  // Would stay in the HW FIFO and eventually overrun
+        pos++;
+      } else {
+        s_ring.push((uint8_t)s_uart[pos++]);
+      }
+      burst++;
+    }
+
+    if (s_ring.has_frame()) {
+      size_t len = s_ring.read_frame(frame, sizeof(frame), &discarded);
+      if (len > 0) {
+        frames++;
+        h = mix(h, (uint32_t)len);
+        h = mix(h, (uint32_t)(uint8_t)frame[1]);
+      }
+    }
+  }
+
+  h = mix(h, frames);
+  h = mix(h, dropped);
+  return mix(h, discarded);
+}
+
+BENCH_CASE(cam_frames_realistic, setupFramesRealistic, passFrames);
+BENCH_CASE(cam_frames_adversarial, setupFramesAdversarial, passFrames);
+
+// ---- Stream frame slots (capture task -> senders) ----
+
+static const uint32_t CAM_SLOT_FRAMES = 4096;
+static const uint32_t CAM_FRAME_PERIOD_MS = 40;  // 25 fps sensor
+static const int CAM_MAX_SENDERS = 3;            // CONFIG_STREAM_MAX_CLIENTS
+
+static FrameSlots<3> s_slots;                    // One sender: senders + 2
+static FrameSlots<CAM_MAX_SENDERS + 2> s_fanSlots;
+static std::vector<uint32_t> s_sendMs;
+
+static Workload slotsWorkload() {
+  Workload w = {CAM_SLOT_FRAMES, 0};
+  return w;
+}
+
+static Workload setupSlotsFastLink() {
+  // Link keeps up: sends finish within a frame period
+  Rng rng(0x5107u);
+  s_sendMs.resize(CAM_SLOT_FRAMES);
+  for (size_t i = 0; i < s_sendMs.size(); i++) {
+    s_sendMs[i] = rng.range(5, 35);
+  }
+  return slotsWorkload();
+}
+
+static Workload setupSlotsSlowLink() {
+  // Congested WiFi: 1-3 frame periods per send, occasional 400ms stalls
+  Rng rng(0x5108u);
+  s_sendMs.resize(CAM_SLOT_FRAMES);
+  for (size_t i = 0; i < s_sendMs.size(); i++) {
+    s_sendMs[i] = rng.chance(5) ? 400 : rng.range(30, 120);
+  }
+  return slotsWorkload();
+}
+
+static Workload setupSlotsFanout() {
+  // Three viewers on one sensor; sender s takes (s + 1)x the drawn time
+  Rng rng(0x5109u);
+  s_sendMs.resize(CAM_SLOT_FRAMES);
+  for (size_t i = 0; i < s_sendMs.size(); i++) {
+    s_sendMs[i] = rng.chance(3) ? 300 : rng.range(10, 50);
+  }
+  return slotsWorkload();
+}
+
+template <size_t N>
+static uint32_t runSlots(FrameSlots<N>& slots, int senders) {
+  slots.clear();
+  uint32_t h = bench::HASH_SEED;
+  uint32_t sendEnd[CAM_MAX_SENDERS] = {};
+  uint32_t lastSeq[CAM_MAX_SENDERS] = {};
+  int held[CAM_MAX_SENDERS];
+  uint32_t noSlot = 0;
+  size_t draw = 0;
+
+  for (int s = 0; s < senders; s++) {
+    held[s] = -1;
+  }
+
+  for (uint32_t f = 0; f < CAM_SLOT_FRAMES; f++) {
+    uint32_t now = f * CAM_FRAME_PERIOD_MS;
+
+    // Senders finished -> slots back
+    for (int s = 0; s < senders; s++) {
+      if (held[s] >= 0 && sendEnd[s] <= now) {
+        slots.release(held[s]);
+        held[s] = -1;
+      }
+    }
+
+    // Producer: fill and publish the new frame
+    int w = slots.acquire_write();
+    if (w >= 0) {
+      slots.publish(w, 64 - (f & 15), 20000 + ((f * 37) & 0x3FFF));
+    } else {
+      noSlot++;
+    }
+
+    // Idle senders take the newest frame
+    for (int s = 0; s < senders; s++) {
+      if (held[s] >= 0) {
+        continue;
+      }
+      held[s] = slots.acquire_latest(lastSeq[s]);
+      if (held[s] >= 0) {
+        lastSeq[s] = slots.slots[held[s]].seq;
+        sendEnd[s] = now + s_sendMs[draw++ % s_sendMs.size()] * (uint32_t)(s + 1);
+        h = mix(h, lastSeq[s]);
+        h = mix(h, slots.slots[held[s]].len);
+      }
+    }
+  }
+
+  h = mix(h, slots.published);
+  h = mix(h, slots.skipped);
+  return mix(h, noSlot);
+}
+
+static uint32_t passSlots() {
+  return runSlots(s_slots, 1);
+}
+
+static uint32_t passSlotsFanout() {
+  return runSlots(s_fanSlots, CAM_MAX_SENDERS);
+}
+
+BENCH_CASE(cam_slots_fast_link, setupSlotsFastLink, passSlots);
+BENCH_CASE(cam_slots_slow_link, setupSlotsSlowLink, passSlots);
+BENCH_CASE(cam_slots_fanout, setupSlotsFanout, passSlotsFanout);
@@ -0,0 +1,207 @@
+/*
+ * Host Microbenchmark Runner (env:native_bench)
+ *
+ *   program [--filter SUBSTR] [--min-ms N] [--baseline FILE] [--update]
+ *           [--tolerance PCT] [--strict]
+ *
+ * Each case is timed in 5 rounds of at least min-ms/5 and the fastest round
+ * is reported (least disturbed by the OS). Results are compared with the
+ * baseline file (default native/bench/baselines.txt, run from the UNO
+ * project directory):
+ *   check mismatch          -> FAIL (exit 1): kernel output changed
+ *   time > base * (1+tol)   -> SLOWER (exit 1 only with --strict)
+ *   time < base * (1-tol)   -> faster
+ * --update rewrites the baseline file from this run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+namespace bench {
+
+std::vector<Case>& registry() {
+  static std::vector<Case> cases;
+  return cases;
+}
+
+void appendf(std::string& out, const char* fmt, ...) {
+  char buf[512];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n > 0) {
+    out.append(buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+  }
+}
+
+}  // namespace bench
+
+struct Baseline {
+  double nsPerOp;
+  uint32_t check;
+};
+
+static const int ROUNDS = 5;
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool loadBaselines(const char* path, std::map<std::string, Baseline>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    char name[128];
+    Baseline b;
+    if (sscanf(line, "%127s %lf %x", name, &b.nsPerOp, &b.check) == 3) {
+      out[name] = b;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+static bool saveBaselines(const char* path, const std::map<std::string, Baseline>& in) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    return false;
+  }
+  fprintf(f, "# Host microbenchmark baselines (env:native_bench --update)\n");
+  fprintf(f, "# name ns_per_op check\n");
+  for (std::map<std::string, Baseline>::const_iterator it = in.begin(); it != in.end(); ++it) {
+    fprintf(f, "%-30s %10.2f 0x%08x\n", it->first.c_str(), it->second.nsPerOp, it->second.check);
+  }
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* filter = nullptr;
+  const char* baselinePath = "native/bench/baselines.txt";
+  uint64_t minMs = 500;
+  double tolerance = 25.0;
+  bool update = false;
+  bool strict = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (arg == "--min-ms" && i + 1 < argc) {
+      minMs = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--baseline" && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else if (arg == "--tolerance" && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (arg == "--update") {
+      update = true;
+    } else if (arg == "--strict") {
+      strict = true;
+    } else {
+      fprintf(stderr, "usage: %s [--filter SUBSTR] [--min-ms N] [--baseline FILE] "
+                      "[--update] [--tolerance PCT] [--strict]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::map<std::string, Baseline> baselines;
+  bool haveBaselines = loadBaselines(baselinePath, baselines);
+  if (!haveBaselines && !update) {
+    printf("(no baseline file %s - run with --update to create it)\n", baselinePath);
+  }
+
+  printf("%-30s %10s %10s %12s %10s  %s\n", "Benchmark", "ns/op", "base", "MB/s", "check", "status");
+  printf("------------------------------------------------------------------------------------------\n");
+
+  int failures = 0;
+  int slower = 0;
+  uint64_t roundNs = minMs * 1000000ull / ROUNDS;
+  std::vector<bench::Case>& cases = bench::registry();
+
+  for (size_t c = 0; c < cases.size(); c++) {
+    const bench::Case& bc = cases[c];
+    if (filter && !strstr(bc.name, filter)) {
+      continue;
+    }
+
+    bench::Workload w = bc.setup();
+    uint32_t check = bc.pass();  // Also warms caches
+
+    double bestNsPerOp = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+      uint64_t passes = 0;
+      volatile uint32_t sink = 0;
+      uint64_t start = nowNs();
+      uint64_t elapsed = 0;
+      do {
+        sink = sink + bc.pass();
+        passes++;
+        elapsed = nowNs() - start;
+      } while (elapsed < roundNs);
+      double nsPerOp = (double)elapsed / (double)(passes * w.ops);
+      if (r == 0 || nsPerOp < bestNsPerOp) {
+        bestNsPerOp = nsPerOp;
+      }
+    }
+
+    char mbs[16] = "-";
+    if (w.bytes) {
+      double nsPerPass = bestNsPerOp * w.ops;
+      snprintf(mbs, sizeof(mbs), "%.1f", w.bytes / nsPerPass * 1000.0);
+    }
+
+    char base[16] = "-";
+    const char* status = "new";
+    std::map<std::string, Baseline>::iterator it = baselines.find(bc.name);
+    if (it != baselines.end()) {
+      snprintf(base, sizeof(base), "%.2f", it->second.nsPerOp);
+      double ratio = bestNsPerOp / it->second.nsPerOp;
+      if (check != it->second.check) {
+        status = "FAIL (check)";
+        failures++;
+      } else if (ratio > 1.0 + tolerance / 100.0) {
+        status = "SLOWER";
+        slower++;
+      } else if (ratio < 1.0 - tolerance / 100.0) {
+        status = "faster";
+      } else {
+        status = "ok";
+      }
+    }
+
+    printf("%-30s %10.2f %10s %12s 0x%08x  %s\n", bc.name, bestNsPerOp, base, mbs, check, status);
+
+    if (update) {
+      Baseline b = {bestNsPerOp, check};
+      baselines[bc.name] = b;
+    }
+  }
+
+  if (update) {
+    if (!saveBaselines(baselinePath, baselines)) {
+      fprintf(stderr, "cannot write %s\n", baselinePath);
+      return 2;
+    }
+    printf("baselines written to %s\n", baselinePath);
+    return 0;
+  }
+
+  printf("failures=%d slower=%d (tolerance %.0f%%)\n", failures, slower, tolerance);
+  return (failures || (strict && slower)) ? 1 : 0;
+}
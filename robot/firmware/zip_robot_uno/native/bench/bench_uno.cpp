@@ -0,0 +1,419 @@
+/*
+ * UNO Kernels: FrameParser, CRC16, DriveSafetyLayer, differential mix,
+ * command lookup, reply formatting
+ *
+ * Parser cases feed processByte() one byte at a time exactly like the rx
+ * task, so ops = bytes and parseJson() is included on every '}'. The
+ * "_bytes" case has no closing braces and isolates the per-byte path.
+ * The command lookup cases should report the same ns/op for any N mix.
+ * The reply cases format the same replies with the removed snprintf path
+ * and with ResponseWriter; matching checks = byte-identical output.
+ */
+
+// STL before Arduino.h (its min/max macros break <algorithm>)
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include <Arduino.h>
+#include "../../src/serial/frame_parser.h"
+#include "protocol/crc16.h"
+#include "motion/drive_safety_layer.h"
+#include "../../src/motion/motion_controller.h"
+#include "core/command_table.h"
+#include "../../src/serial/response_writer.h"
+
+using bench::Rng;
+using bench::Workload;
+using bench::mix;
+
+// ---- FrameParser ----
+
+static std::string s_stream;
+
+static void appendSetpoint(std::string& out, Rng& rng) {
+  bench::appendf(out, "{\"N\":200,\"H\":\"sp\",\"D1\":%d,\"D2\":%d,\"T\":%d}\n",
+                 (int)rng.range(-255, 255), (int)rng.range(-255, 255), (int)rng.range(150, 300));
+}
+
+// App traffic: mostly 20-50Hz setpoints, with the commands the host and
+// bridge interleave (hello, sensors, diagnostics, stop, servo, config)
+static void appendAppCommand(std::string& out, Rng& rng) {
+  switch (rng.next() % 10) {
+    case 0: bench::appendf(out, "{\"N\":0,\"H\":\"hello\"}\n"); break;
+    case 1: bench::appendf(out, "{\"N\":21,\"H\":\"us\",\"D1\":2}\n"); break;
+    case 2: bench::appendf(out, "{\"N\":23,\"H\":\"bat\"}\n"); break;
+    case 3: bench::appendf(out, "{\"N\":120,\"H\":\"diag\"}\n"); break;
+    case 4: bench::appendf(out, "{\"N\":201,\"H\":\"stop\"}\n"); break;
+    case 5: bench::appendf(out, "{\"N\":5,\"H\":\"srv\",\"D1\":%d}\n", (int)rng.range(0, 180)); break;
+    case 6: bench::appendf(out, "{\"N\":140,\"H\":\"cfg\",\"D1\":%d,\"D2\":%d}\n",
+                           (int)rng.range(1, 6), (int)rng.range(0, 255)); break;
+    case 7: bench::appendf(out, "{\"N\":999,\"H\":\"m\",\"D1\":%d,\"D2\":%d}\n",
+                           (int)rng.range(-255, 255), (int)rng.range(-255, 255)); break;
+    default: appendSetpoint(out, rng); break;
+  }
+}
+
+// Line noise, boot garbage, overlong and broken frames
+static void appendAdversarial(std::string& out, Rng& rng) {
+  switch (rng.next() % 8) {
+    case 0: {  // Raw binary (incl. legacy 0xAA 0x55 headers and NULs)
+      uint32_t n = rng.range(8, 48);
+      for (uint32_t i = 0; i < n; i++) {
+        out.push_back((char)(rng.next() & 0xFF));
+      }
+      break;
+    }
+    case 1: {  // Overlong frame (> MAX_JSON_LINE)
+      out += "{\"N\":200,\"H\":\"";
+      uint32_t n = rng.range(64, 160);
+      for (uint32_t i = 0; i < n; i++) {
+        out.push_back((char)('a' + rng.next() % 26));
+      }
+      out += "\",\"D1\":1}\n";
+      break;
+    }
+    case 2:  // Unterminated frame restarted by another '{'
+      bench::appendf(out, "{\"N\":200,\"D1\":%d{\"N\":201,\"H\":\"x\"}\n", (int)rng.range(-255, 255));
+      break;
+    case 3:  // Out-of-range and malformed numbers
+      bench::appendf(out, "{\"N\":200,\"D1\":%d99999,\"D2\":-,\"T\":4294967299}\n",
+                     (int)rng.range(-9, 9));
+      break;
+    case 4:  // Whitespace, CR/LF storms
+      out += "\r\n\r\n   \t{ \"N\" : 200 , \"H\" : \"ws\" , \"D1\" : 80 }\r\n\n\n";
+      break;
+    case 5:  // Stray closing braces and empty frames
+      out += "}}{}}{\"\"}{\"N\":}";
+      break;
+    case 6:  // Missing fields, unknown keys
+      bench::appendf(out, "{\"X\":%d,\"Y\":\"zz\",\"NN\":5,\"D9\":1}\n", (int)rng.range(0, 999));
+      break;
+    default:
+      appendSetpoint(out, rng);
+      break;
+  }
+}
+
+static Workload streamWorkload() {
+  Workload w = {(uint32_t)s_stream.size(), (uint32_t)s_stream.size()};
+  return w;
+}
+
+static Workload setupParseSetpoints() {
+  Rng rng(0x5E7901u);
+  s_stream.clear();
+  while (s_stream.size() < 16384) {
+    appendSetpoint(s_stream, rng);
+  }
+  return streamWorkload();
+}
+
+static Workload setupParseMixed() {
+  Rng rng(0x31A3Du);
+  s_stream.clear();
+  while (s_stream.size() < 16384) {
+    appendAppCommand(s_stream, rng);
+  }
+  return streamWorkload();
+}
+
+static Workload setupParseAdversarial() {
+  Rng rng(0xBADF00Du);
+  s_stream.clear();
+  while (s_stream.size() < 16384) {
+    appendAdversarial(s_stream, rng);
+  }
+  return streamWorkload();
+}
+
+static Workload setupParseBytes() {
+  // Frame bodies without the closing brace: accumulate, overflow, resync
+  Rng rng(0xB7E5u);
+  s_stream.clear();
+  while (s_stream.size() < 16384) {
+    std::string frame;
+    appendSetpoint(frame, rng);
+    for (size_t i = 0; i < frame.size(); i++) {
+      if (frame[i] != '}') {
+        s_stream.push_back(frame[i]);
+      }
+    }
+  }
+  return streamWorkload();
+}
+
+static uint32_t passParse() {
+  FrameParser parser;
+  uint32_t h = bench::HASH_SEED;
+  uint32_t frames = 0;
+  const uint8_t* p = (const uint8_t*)s_stream.data();
+  for (size_t i = 0, n = s_stream.size(); i < n; i++) {
+    if (parser.processByte(p[i])) {
+      ParsedCommand cmd;
+      if (parser.getCommand(cmd)) {
+        h = mix(h, (uint32_t)cmd.N);
+        h = mix(h, (uint32_t)cmd.D1);
+        h = mix(h, (uint32_t)cmd.D2);
+        h = mix(h, (uint32_t)cmd.T);
+        h = mix(h, (uint32_t)(uint8_t)cmd.H[0]);
+        frames++;
+      }
+      parser.reset();
+    }
+  }
+  return mix(h, frames);
+}
+
+BENCH_CASE(uno_parse_setpoints, setupParseSetpoints, passParse);
+BENCH_CASE(uno_parse_mixed, setupParseMixed, passParse);
+BENCH_CASE(uno_parse_adversarial, setupParseAdversarial, passParse);
+BENCH_CASE(uno_parse_bytes, setupParseBytes, passParse);
+
+// ---- CRC16 ----
+
+static std::vector<uint8_t> s_crcData;
+static uint32_t s_crcLen;
+
+static Workload setupCrc(uint32_t len) {
+  Rng rng(0xC2C16u + len);
+  s_crcLen = len;
+  s_crcData.resize(4096);
+  for (size_t i = 0; i < s_crcData.size(); i++) {
+    s_crcData[i] = (uint8_t)rng.next();
+  }
+  uint32_t blocks = (uint32_t)s_crcData.size() / len;
+  Workload w = {blocks, blocks * len};
+  return w;
+}
+
+static Workload setupCrcFrame() { return setupCrc(8); }   // LEN+TYPE+SEQ+5B payload
+static Workload setupCrcBlock() { return setupCrc(64); }
+
+static uint32_t passCrc() {
+  uint32_t h = bench::HASH_SEED;
+  for (size_t off = 0; off + s_crcLen <= s_crcData.size(); off += s_crcLen) {
+    h = mix(h, CRC16::calculate(&s_crcData[off], (uint16_t)s_crcLen));
+  }
+  return h;
+}
+
+BENCH_CASE(uno_crc16_frame8, setupCrcFrame, passCrc);
+BENCH_CASE(uno_crc16_block64, setupCrcBlock, passCrc);
+
+// ---- DriveSafetyLayer::applyLimits ----
+
+struct WheelPair {
+  int16_t left;
+  int16_t right;
+};
+
+static std::vector<WheelPair> s_targets;
+
+static Workload setupSafetyLimits() {
+  // 50Hz control ticks: holds, ramps, reversals and creeping through the
+  // deadband, each held for several ticks so slew/kick state is exercised
+  Rng rng(0x5AFEu);
+  s_targets.clear();
+  while (s_targets.size() < 4096) {
+    WheelPair t;
+    switch (rng.next() % 4) {
+      case 0: t.left = t.right = (int16_t)rng.range(-255, 255); break;
+      case 1: t.left = (int16_t)rng.range(-255, 255); t.right = (int16_t)-t.left; break;
+      case 2: t.left = (int16_t)rng.range(-80, 80); t.right = (int16_t)rng.range(-80, 80); break;
+      default: t.left = t.right = 0; break;
+    }
+    uint32_t hold = rng.range(1, 25);
+    for (uint32_t i = 0; i < hold; i++) {
+      s_targets.push_back(t);
+    }
+  }
+  Workload w = {(uint32_t)s_targets.size(), 0};
+  return w;
+}
+
+static uint32_t passSafetyLimits() {
+  DriveSafetyLayer layer;
+  layer.init();
+  uint32_t h = bench::HASH_SEED;
+  for (size_t i = 0; i < s_targets.size(); i++) {
+    int16_t l = s_targets[i].left;
+    int16_t r = s_targets[i].right;
+    layer.applyLimits(&l, &r);
+    h = mix(h, ((uint32_t)(uint16_t)l << 16) | (uint16_t)r);
+  }
+  return h;
+}
+
+BENCH_CASE(uno_safety_limits, setupSafetyLimits, passSafetyLimits);
+
+// ---- MotionController::applyDifferentialMix ----
+
+static std::vector<WheelPair> s_vw;
+
+static Workload setupDiffMix() {
+  Rng rng(0xD1FFu);
+  s_vw.resize(4096);
+  for (size_t i = 0; i < s_vw.size(); i++) {
+    s_vw[i].left = (int16_t)rng.range(-255, 255);   // v
+    s_vw[i].right = (int16_t)rng.range(-255, 255);  // w (saturates half the time)
+  }
+  Workload w = {(uint32_t)s_vw.size(), 0};
+  return w;
+}
+
+static uint32_t passDiffMix() {
+  uint32_t h = bench::HASH_SEED;
+  for (size_t i = 0; i < s_vw.size(); i++) {
+    int16_t l, r;
+    MotionController::applyDifferentialMix(s_vw[i].left, s_vw[i].right, l, r);
+    h = mix(h, ((uint32_t)(uint16_t)l << 16) | (uint16_t)r);
+  }
+  return h;
+}
+
+BENCH_CASE(uno_diff_mix, setupDiffMix, passDiffMix);
+
+// ---- commandLookup (dispatch table) ----
+
+static std::vector<int16_t> s_cmdN;
+
+static Workload setupLookupMixed() {
+  // Streaming client: setpoints dominate, periodic queries and stops
+  static const int16_t OTHERS[] = {0, 5, 21, 22, 23, 120, 140, 201, 210, 211, 999};
+  Rng rng(0xD15Au);
+  s_cmdN.resize(4096);
+  for (size_t i = 0; i < s_cmdN.size(); i++) {
+    s_cmdN[i] = rng.chance(70) ? 200 : OTHERS[rng.next() % (sizeof(OTHERS) / sizeof(OTHERS[0]))];
+  }
+  Workload w = {(uint32_t)s_cmdN.size(), 0};
+  return w;
+}
+
+static Workload setupLookupScattered() {
+  // Mostly unlisted N (legacy ELEGOO range, garbage), below/above the table
+  Rng rng(0x5CA7u);
+  s_cmdN.resize(4096);
+  for (size_t i = 0; i < s_cmdN.size(); i++) {
+    s_cmdN[i] = (int16_t)rng.range(-300, 1300);
+  }
+  Workload w = {(uint32_t)s_cmdN.size(), 0};
+  return w;
+}
+
+static uint32_t passLookup() {
+  uint32_t h = bench::HASH_SEED;
+  for (size_t i = 0; i < s_cmdN.size(); i++) {
+    const CommandEntry* e = commandLookup(s_cmdN[i]);
+    h = mix(h, e ? ((uint32_t)(uint16_t)e->n << 8) | commandFlags(e) : 0xFFFFFFFFu);
+  }
+  return h;
+}
+
+BENCH_CASE(uno_cmd_lookup_mixed, setupLookupMixed, passLookup);
+BENCH_CASE(uno_cmd_lookup_scattered, setupLookupScattered, passLookup);
+
+// ---- Replies: snprintf (reference) vs ResponseWriter ----
+
+struct Reply {
+  char H[8];
+  uint8_t kind;    // 0 = ok, 1 = false, 2 = number, 3 = stats
+  int32_t value;
+};
+
+static std::vector<Reply> s_replies;
+
+// TX ring stand-in: collects one reply, never full
+class ReplySink : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (len < sizeof(buf)) {
+      buf[len++] = c;
+    }
+    return 1;
+  }
+  int availableForWrite() override { return 63; }
+  uint32_t take(uint32_t h) {
+    for (size_t i = 0; i < len; i++) {
+      h = mix(h, buf[i]);
+    }
+    len = 0;
+    return h;
+  }
+private:
+  uint8_t buf[96];
+  size_t len = 0;
+};
+
+static Workload setupReplies() {
+  // What the handlers send: acks for most commands, sensor values
+  // (N=21/22/23), occasional {stats:...}
+  static const char* const TAGS[] = {"sp", "us", "bat", "cfg", "m", "12345", ""};
+  Rng rng(0x5E7Du);
+  s_replies.resize(4096);
+  for (size_t i = 0; i < s_replies.size(); i++) {
+    Reply& r = s_replies[i];
+    strcpy(r.H, TAGS[rng.next() % (sizeof(TAGS) / sizeof(TAGS[0]))]);
+    uint32_t k = rng.next() % 16;
+    r.kind = (k < 8) ? 0 : (k < 10) ? 1 : (k < 15) ? 2 : 3;
+    r.value = (r.kind == 2) ? rng.range(0, 9000) : (int32_t)rng.range(0, 70000);
+  }
+  Workload w = {(uint32_t)s_replies.size(), 0};
+  return w;
+}
+
+static uint32_t passRepliesSnprintf() {
+  // The JsonProtocol formatting before ResponseWriter
+  ReplySink sink;
+  uint32_t h = bench::HASH_SEED;
+  for (size_t i = 0; i < s_replies.size(); i++) {
+    const Reply& r = s_replies[i];
+    char buffer[80];
+    switch (r.kind) {
+      case 0: snprintf(buffer, sizeof(buffer), "{%s_ok}\n", r.H); break;
+      case 1: snprintf(buffer, sizeof(buffer), "{%s_false}\n", r.H); break;
+      case 2: {
+        char valueStr[8];
+        snprintf(valueStr, sizeof(valueStr), "%u", (unsigned)r.value);
+        snprintf(buffer, sizeof(buffer), "{%s_%s}\n", r.H, valueStr);
+        break;
+      }
+      default:
+        snprintf(buffer, sizeof(buffer), "{stats:rx=%u,jd=%u,pe=%u,tx=%u,ms=%lu}\n",
+                 (unsigned)(r.value & 0xFF), 0u, (unsigned)(r.value >> 8), 3u,
+                 (unsigned long)r.value);
+        break;
+    }
+    sink.write(buffer);
+    h = sink.take(h);
+  }
+  return h;
+}
+
+static uint32_t passRepliesWriter() {
+  ReplySink sink;
+  uint32_t h = bench::HASH_SEED;
+  for (size_t i = 0; i < s_replies.size(); i++) {
+    const Reply& r = s_replies[i];
+    ResponseWriter w(sink);
+    switch (r.kind) {
+      case 0: w.begin(r.H).str(F("ok")).end(); break;
+      case 1: w.begin(r.H).str(F("false")).end(); break;
+      case 2: w.begin(r.H).num(r.value).end(); break;
+      default:
+        w.str(F("{stats:rx=")).num((uint16_t)(r.value & 0xFF));
+        w.str(F(",jd=")).num((uint16_t)0);
+        w.str(F(",pe=")).num((uint16_t)(r.value >> 8));
+        w.str(F(",tx=")).num((uint16_t)3);
+        w.str(F(",ms=")).num((uint32_t)r.value);
+        w.end();
+        break;
+    }
+    h = sink.take(h);
+  }
+  return h;
+}
+
+BENCH_CASE(uno_reply_snprintf, setupReplies, passRepliesSnprintf);
+BENCH_CASE(uno_reply_writer, setupReplies, passRepliesWriter);
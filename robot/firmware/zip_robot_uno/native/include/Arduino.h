@@ -0,0 +1,154 @@
+/*
+ * Arduino API Fake (native build)
+ *
+ * Just enough of the AVR Arduino core to compile and run the UNO firmware
+ * on the host. Time is virtual: millis()/micros() only advance through
+ * delay(), delayMicroseconds(), pulseIn(), blocking Serial writes and the
+ * harness (see sim/sim.h). Nothing here is used on-target.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// C headers first - the min/max/abs macros below would break them otherwise
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// UNO analog pins
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define NUM_DIGITAL_PINS 20
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define abs(x) ((x) > 0 ? (x) : -(x))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : -1))
+
+// ---- Time (virtual) ----
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ---- GPIO (recorded) ----
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000L);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void interrupts();
+void noInterrupts();
+
+// ---- Print / Stream / Serial ----
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const __FlashStringHelper* s);
+  size_t print(const char s[]);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println(const __FlashStringHelper* s);
+  size_t println(const char s[]);
+  size_t println(char c);
+  size_t println(unsigned char n, int base = DEC);
+  size_t println(int n, int base = DEC);
+  size_t println(unsigned int n, int base = DEC);
+  size_t println(long n, int base = DEC);
+  size_t println(unsigned long n, int base = DEC);
+  size_t println(double n, int digits = 2);
+  size_t println();
+
+private:
+  size_t printNumber(unsigned long n, uint8_t base);
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// UNO HardwareSerial: RX/TX rings (core default 64, overridable like the
+// real core), TX drains at the configured baud in virtual time; write()
+// blocks (advancing time) when the TX ring is full.
+#ifndef SERIAL_TX_BUFFER_SIZE
+#define SERIAL_TX_BUFFER_SIZE 64
+#endif
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64
+#endif
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  void begin(unsigned long baud, uint8_t config) { (void)config; begin(baud); }
+  void end() {}
+  int available() override;
+  int peek() override;
+  int read() override;
+  int availableForWrite() override;
+  void flush();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_H
@@ -0,0 +1,25 @@
+/*
+ * Servo library fake (native build) - angle is recorded for the harness
+ */
+
+#ifndef SERVO_H_NATIVE
+#define SERVO_H_NATIVE
+
+#include <Arduino.h>
+
+class Servo {
+public:
+  Servo() : pin(0xFF), angle(90) {}
+  uint8_t attach(int p) { pin = (uint8_t)p; return 1; }
+  uint8_t attach(int p, int minUs, int maxUs) { (void)minUs; (void)maxUs; return attach(p); }
+  void detach() { pin = 0xFF; }
+  void write(int value);
+  int read() { return angle; }
+  bool attached() { return pin != 0xFF; }
+
+private:
+  uint8_t pin;
+  int angle;
+};
+
+#endif // SERVO_H_NATIVE
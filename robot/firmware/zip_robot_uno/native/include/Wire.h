@@ -0,0 +1,40 @@
+/*
+ * Wire (TWI) fake (native build)
+ *
+ * Routes register reads/writes to sim::I2cDevice instances attached with
+ * sim::attachI2c(). With nothing attached every transmission NACKs, so
+ * IMU_MPU6050::init() fails fast and the firmware runs with imu=0.
+ */
+
+#ifndef WIRE_H_NATIVE
+#define WIRE_H_NATIVE
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  TwoWire();
+  void begin() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t addr);
+  void beginTransmission(int addr) { beginTransmission((uint8_t)addr); }
+  size_t write(uint8_t value);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t addr, uint8_t len);
+  uint8_t requestFrom(int addr, int len) { return requestFrom((uint8_t)addr, (uint8_t)len); }
+  int available();
+  int read();
+
+private:
+  uint8_t txAddr;
+  uint8_t txBuf[16];
+  uint8_t txLen;
+  uint8_t reg;           // Register pointer left by the last write
+  uint8_t rxBuf[32];
+  uint8_t rxLen;
+  uint8_t rxPos;
+};
+
+extern TwoWire Wire;
+
+#endif // WIRE_H_NATIVE
@@ -0,0 +1,11 @@
+/*
+ * avr/interrupt.h fake (native build) - no interrupts off-target
+ */
+
+#ifndef INTERRUPT_H_NATIVE
+#define INTERRUPT_H_NATIVE
+
+#define sei()
+#define cli()
+
+#endif // INTERRUPT_H_NATIVE
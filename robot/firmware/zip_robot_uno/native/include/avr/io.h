@@ -0,0 +1,17 @@
+/*
+ * avr/io.h fake (native build) - no SFRs off-target
+ *
+ * Code touching registers directly must be guarded (FAST_PIN_ENABLED,
+ * ADC_SAMPLER_ENABLED are 0 in env:native).
+ */
+
+#ifndef IO_H_NATIVE
+#define IO_H_NATIVE
+
+#include <stdint.h>
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+#endif // IO_H_NATIVE
@@ -0,0 +1,30 @@
+/*
+ * avr/pgmspace.h fake (native build) - flash is just RAM off-target
+ */
+
+#ifndef PGMSPACE_H_NATIVE
+#define PGMSPACE_H_NATIVE
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+
+#endif // PGMSPACE_H_NATIVE
@@ -0,0 +1,28 @@
+/*
+ * avr/wdt.h fake (native build)
+ *
+ * wdt_reset() records the virtual time so the harness can report the
+ * longest gap between resets and flag would-be watchdog resets.
+ */
+
+#ifndef WDT_H_NATIVE
+#define WDT_H_NATIVE
+
+#include <stdint.h>
+
+#define WDTO_15MS   0
+#define WDTO_30MS   1
+#define WDTO_60MS   2
+#define WDTO_120MS  3
+#define WDTO_250MS  4
+#define WDTO_500MS  5
+#define WDTO_1S     6
+#define WDTO_2S     7
+#define WDTO_4S     8
+#define WDTO_8S     9
+
+void wdt_reset();
+void wdt_enable(uint8_t timeout);
+void wdt_disable();
+
+#endif // WDT_H_NATIVE
@@ -0,0 +1,131 @@
+/*
+ * Differential-Drive Plant Model (native build)
+ *
+ * Closes the loop around the firmware in the native harness: reads the
+ * TB6612 pins the real MotorDriverTB6612 writes (STBY, PWMA/PWMB,
+ * AIN_1/BIN_1), runs a per-wheel first-order model with stiction/deadband
+ * and battery sag, integrates the chassis pose, and feeds the results back
+ * as sensor inputs:
+ *   - MPU6050 at 0x68 (gyro Z from yaw rate, accel X from wheel accel)
+ *   - Battery divider on A3 (loaded pack voltage)
+ *   - Ultrasonic echo from an optional wall ahead
+ *
+ * Wheel model (per side, v in cm/s, duty in -1..1):
+ *   Vapp = duty * Vbatt
+ *   v_ss = vMax * (|Vapp| - Vfric) / (Vnom - Vfric)   (0 below Vfric)
+ *   dv/dt = (v_ss - v) / tau        driven
+ *   dv/dt = -v / tauCoast - sign(v) * rollDecel   undriven (gearbox drag)
+ * A stopped wheel stays stopped until |Vapp| exceeds the breakaway voltage.
+ *
+ * Pack: Vbatt = Voc - Rint * (Ilogic + sum(|duty| * (Vbatt - Vemf) / Rmotor))
+ */
+
+#ifndef SIM_PLANT_H
+#define SIM_PLANT_H
+
+#include <stdint.h>
+
+namespace sim {
+
+struct PlantConfig {
+  float vMaxCmS;          // Free speed at full duty and nominal voltage
+  float tauMs;            // Driven wheel+chassis time constant
+  float tauCoastMs;       // Undriven spin-down time constant
+  float rollDecelCmS2;    // Undriven rolling/gearbox friction
+  float breakawayPwm;     // PWM (at Vnom) needed to start a stopped wheel
+  float frictionPwm;      // PWM (at Vnom) lost to friction while rolling
+  float leftGain;         // Per-side motor mismatch (1.0 = nominal)
+  float rightGain;
+  float trackCm;          // Wheel separation
+  float vNom;             // Voltage vMaxCmS was measured at
+  float vOpenCircuit;     // Pack open-circuit voltage
+  float rInternalOhm;     // Pack + wiring resistance
+  float rMotorOhm;        // Motor winding resistance
+  float iLogicA;          // UNO + ESP32 + sensors
+  int16_t gyroBiasLsb;    // Constant gyro Z offset (IMU calibration removes it)
+
+  PlantConfig()
+    : vMaxCmS(90.0f)
+    , tauMs(120.0f)
+    , tauCoastMs(90.0f)
+    , rollDecelCmS2(150.0f)
+    , breakawayPwm(60.0f)
+    , frictionPwm(45.0f)
+    , leftGain(1.0f)
+    , rightGain(1.0f)
+    , trackCm(13.5f)
+    , vNom(7.4f)
+    , vOpenCircuit(7.8f)
+    , rInternalOhm(0.35f)
+    , rMotorOhm(2.8f)
+    , iLogicA(0.25f)
+    , gyroBiasLsb(0)
+  {}
+};
+
+// One integration sample, delivered every millisecond of virtual time
+struct PlantSample {
+  uint64_t tUs;
+  float leftCmS;
+  float rightCmS;
+  float leftDuty;         // Signed, as applied (0 when STBY is low)
+  float rightDuty;
+  float batteryV;
+  float xCm;
+  float yCm;
+  float headingDeg;
+  float yawRateDps;
+  float odometerCm;       // Mean wheel path length, always increasing
+};
+
+typedef void (*PlantSampleCallback)(const PlantSample& s);
+
+class Plant {
+public:
+  explicit Plant(const PlantConfig& cfg = PlantConfig());
+
+  // Hook into the virtual clock and attach the fake MPU6050.
+  // Only one plant can be attached at a time.
+  void attach();
+
+  void setSampleCallback(PlantSampleCallback cb) { sampleCb = cb; }
+
+  // Wall <cm> ahead, perpendicular to the current heading (0 = remove).
+  // Drives the echo while the servo and chassis face it (+-15/+-30 deg).
+  void setWallAhead(float cm);
+
+  // Closest approach to the wall since it was placed (cm)
+  float wallMinCm() const { return wallMin; }
+  bool hasWall() const { return wallSet; }
+
+  const PlantSample& state() const { return s; }
+  const PlantConfig& config() const { return cfg; }
+
+  // Advance the model to nowUs (fixed substeps)
+  void advanceTo(uint64_t nowUs);
+
+  // MPU6050 register file (big-endian 16-bit words)
+  uint8_t mpuRegister(uint8_t reg) const;
+  void mpuWrite(uint8_t reg, uint8_t value);
+
+private:
+  void step(float dtS);
+  float wheelTarget(float duty, float gain, float batteryV, float v) const;
+  void publishSensors();
+
+  PlantConfig cfg;
+  PlantSample s;
+  PlantSampleCallback sampleCb;
+  uint64_t lastUs;
+  uint32_t substep;
+  float accelCmS2;
+  bool wallSet;
+  float wallHeadingDeg;   // Wall normal (robot heading when placed)
+  float wallOffsetCm;     // Wall position along that normal
+  float wallMin;
+  uint8_t mpuRegs[128];
+};
+
+}  // namespace sim
+
+#endif // SIM_PLANT_H
@@ -0,0 +1,75 @@
+/*
+ * Scenario Meter (native build)
+ *
+ * Turns the plant's 1ms samples into closed-loop response figures. A
+ * segment starts at a script "!segment <name>" and ends at the next one
+ * (or end of run). Speed is the mean wheel speed magnitude, so straight
+ * runs, spins and macros are all measured the same way.
+ *
+ * Per segment:
+ *   lag       segment start -> speed reaches 10% of steady state
+ *   rise      10% -> 90% of steady state
+ *   steady    mean speed over the last 100ms before the stop point
+ *   overshoot peak speed above steady state (% of steady)
+ *   stop      stop point -> wheels at rest (ms, cm travelled)
+ *   vbat_min  lowest loaded pack voltage
+ *
+ * The stop point is the first sample, after the wheels moved, where both
+ * applied duties are zero - an N=201, TTL expiry, macro end or reflex brake.
+ */
+
+#ifndef SIM_SCENARIO_H
+#define SIM_SCENARIO_H
+
+#include <string>
+#include <vector>
+#include "sim/plant.h"
+
+namespace sim {
+
+struct ScenarioResult {
+  std::string name;
+  bool moved;
+  float lagMs;
+  float riseMs;
+  float steadyCmS;
+  float peakCmS;
+  float overshootPct;
+  bool stopped;
+  float stopMs;
+  float stopCm;
+  float minBatteryV;
+};
+
+class ScenarioMeter {
+public:
+  ScenarioMeter() : startUs(0), open(false) {}
+
+  void begin(const std::string& name, uint64_t tUs);
+  void sample(const PlantSample& s);
+  void end();  // Closes the open segment (if any)
+
+  const std::vector<ScenarioResult>& results() const { return done; }
+  void print() const;
+
+private:
+  struct Point {
+    uint64_t tUs;
+    float speed;
+    float odometer;
+    bool driven;
+    float batteryV;
+  };
+
+  ScenarioResult analyze() const;
+
+  std::string name;
+  uint64_t startUs;
+  bool open;
+  std::vector<Point> trace;
+  std::vector<ScenarioResult> done;
+};
+
+}  // namespace sim
+
+#endif // SIM_SCENARIO_H
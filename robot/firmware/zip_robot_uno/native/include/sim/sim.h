@@ -0,0 +1,96 @@
+/*
+ * Native Simulation Harness API
+ *
+ * Controls the virtual clock and the fake peripherals behind the Arduino
+ * shims. Used by native/src/native_main.cpp (and anything built on top of
+ * env:native) to drive the real setup()/loop() deterministically.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sim {
+
+// ============================================================================
+// Virtual clock
+// ============================================================================
+
+uint64_t nowMicros();
+
+// Advance virtual time; services serial TX drain and RX arrival
+void advanceMicros(uint64_t us);
+
+// Called after every virtual time step (plant models hook in here).
+// Steps can be large (delay(100)); models must substep themselves.
+typedef void (*TickCallback)(uint64_t nowUs);
+void setTickCallback(TickCallback cb);
+
+// ============================================================================
+// Serial link (host side)
+// ============================================================================
+
+// Queue bytes "on the wire" towards the UNO. They arrive at the configured
+// baud rate starting now; bytes hitting a full 64-byte RX ring are dropped.
+void injectRx(const char* data, size_t len);
+
+// Bytes dropped because the RX ring was full
+uint32_t rxOverflows();
+
+// Host-side baud rate (0 = always match the UNO's Serial.begin() rate).
+// On a mismatch RX bytes arrive as 0x00/0xFF garbage and TX lines read as
+// '?'. Bytes already on the wire keep the rate they were sent at.
+void setHostBaud(uint32_t baud);
+uint32_t uartBaud();
+
+// Called for every complete line the UNO transmits (after it left the UART)
+typedef void (*TxLineCallback)(uint64_t tUs, const char* line, size_t len);
+void setTxLineCallback(TxLineCallback cb);
+
+uint32_t txBytes();
+
+// ============================================================================
+// GPIO / sensors
+// ============================================================================
+
+// Called on every digitalWrite/analogWrite (pwm = -1 for digital writes)
+typedef void (*PinWriteCallback)(uint64_t tUs, uint8_t pin, uint8_t level, int16_t pwm);
+void setPinWriteCallback(PinWriteCallback cb);
+
+uint8_t pinLevel(uint8_t pin);
+int16_t pinPwm(uint8_t pin);      // Last analogWrite value (-1 = digital)
+uint8_t pinModeOf(uint8_t pin);
+
+void setAnalog(uint8_t pin, uint16_t value);  // analogRead() result
+void setDigitalInput(uint8_t pin, uint8_t level);
+void setEchoMicros(uint32_t us);              // pulseIn() result (0 = timeout)
+
+int servoAngle();
+
+// ============================================================================
+// I2C bus
+// ============================================================================
+
+// Register-style I2C target behind the Wire fake. Unattached addresses NACK.
+class I2cDevice {
+public:
+  virtual ~I2cDevice() {}
+  virtual void writeRegister(uint8_t reg, uint8_t value) = 0;
+  virtual uint8_t readRegister(uint8_t reg) = 0;  // Auto-increment per byte
+};
+
+void attachI2c(uint8_t addr, I2cDevice* dev);
+
+// ============================================================================
+// Watchdog
+// ============================================================================
+
+// Longest virtual-time gap between wdt_reset() calls once enabled (us)
+uint64_t wdtMaxGapMicros();
+uint64_t wdtTimeoutMicros();  // 0 = not enabled
+
+}  // namespace sim
+
+#endif // SIM_H
@@ -0,0 +1,12 @@
+/*
+ * util/atomic.h fake (native build) - single-threaded, so the block just runs once
+ */
+
+#ifndef ATOMIC_H_NATIVE
+#define ATOMIC_H_NATIVE
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+#define ATOMIC_BLOCK(type) for (int _atomic_once = ((void)(type), 1); _atomic_once; _atomic_once = 0)
+
+#endif // ATOMIC_H_NATIVE
@@ -0,0 +1,494 @@
+/*
+ * Arduino API Fake Implementation (native build)
+ *
+ * Virtual time is kept in nanoseconds so the UART byte time (86.8us at
+ * 115200) does not drift. Costs modelled in virtual time:
+ *   - analogRead(): 112us (13 ADC clocks at /128 + call overhead)
+ *   - pulseIn(): echo width, or the full timeout on no echo
+ *   - Serial.write(): blocks until the 64-byte TX ring has space
+ */
+
+// STL before Arduino.h (its min/max/abs macros break libstdc++)
+#include <deque>
+#include <string>
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Servo.h>
+#include <avr/wdt.h>
+#include "sim/sim.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+// ============================================================================
+// Virtual clock
+// ============================================================================
+
+static uint64_t s_nowNs = 0;
+
+// Serial model
+static uint64_t s_byteTimeNs = 86806;  // 10 bits @ 115200
+static uint32_t s_uartBaud = 115200;
+static uint32_t s_hostBaud = 0;        // 0 = host follows the UNO
+static std::deque<uint8_t> s_txRing;
+static uint64_t s_txHeadDoneNs = 0;    // When the byte at the head finishes
+static std::string s_txLine;
+static uint32_t s_txBytes = 0;
+static sim::TxLineCallback s_txLineCb = nullptr;
+
+struct WireByte {
+  uint64_t arrivalNs;
+  uint32_t baud;  // Rate the host sent it at
+  uint8_t value;
+};
+static std::deque<WireByte> s_rxWire;
+static std::deque<uint8_t> s_rxRing;
+static uint64_t s_rxLastArrivalNs = 0;
+static uint32_t s_rxOverflows = 0;
+
+// GPIO model
+static uint8_t s_level[NUM_DIGITAL_PINS];
+static uint8_t s_mode[NUM_DIGITAL_PINS];
+static int16_t s_pwm[NUM_DIGITAL_PINS];
+static uint8_t s_inputLevel[NUM_DIGITAL_PINS];
+static bool s_inputSet[NUM_DIGITAL_PINS];
+static uint16_t s_analog[NUM_DIGITAL_PINS];
+static uint32_t s_echoUs = 5830;  // ~100cm
+static int s_servoAngle = 90;
+static sim::PinWriteCallback s_pinCb = nullptr;
+
+// Watchdog model
+static uint64_t s_wdtTimeoutUs = 0;
+static uint64_t s_wdtLastResetNs = 0;
+static uint64_t s_wdtMaxGapNs = 0;
+
+// Plant hook and I2C targets
+static sim::TickCallback s_tickCb = nullptr;
+static sim::I2cDevice* s_i2c[128];
+
+static struct PinDefaults {
+  PinDefaults() {
+    for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++) {
+      s_level[i] = LOW;
+      s_mode[i] = INPUT;
+      s_pwm[i] = -1;
+      s_inputLevel[i] = LOW;
+      s_inputSet[i] = false;
+      s_analog[i] = 0;
+    }
+    // Line sensors on a white surface, battery divider at ~7.6V
+    s_analog[A0] = 800;
+    s_analog[A1] = 800;
+    s_analog[A2] = 800;
+    s_analog[A3] = 188;
+  }
+} s_pinDefaults;
+
+static void serviceSerial() {
+  // TX drain
+  while (!s_txRing.empty() && s_txHeadDoneNs <= s_nowNs) {
+    uint8_t c = s_txRing.front();
+    s_txRing.pop_front();
+    s_txBytes++;
+    // Host decoding at another rate sees garbage (line breaks kept so the
+    // log stays readable)
+    if (s_hostBaud != 0 && s_hostBaud != s_uartBaud && c != '\n') {
+      c = '?';
+    }
+    if (c == '\n') {
+      if (!s_txLine.empty() && s_txLine[s_txLine.size() - 1] == '\r') {
+        s_txLine.erase(s_txLine.size() - 1);
+      }
+      if (s_txLineCb) {
+        s_txLineCb(s_txHeadDoneNs / 1000, s_txLine.c_str(), s_txLine.size());
+      }
+      s_txLine.clear();
+    } else {
+      s_txLine.push_back((char)c);
+    }
+    s_txHeadDoneNs += s_byteTimeNs;
+  }
+
+  // RX arrival
+  while (!s_rxWire.empty() && s_rxWire.front().arrivalNs <= s_nowNs) {
+    // Rate mismatch, coarsely: a slower sender's long bit cells read as
+    // 0x00 (break-like), a faster sender's short ones as 0xFF
+    const WireByte& wb = s_rxWire.front();
+    uint8_t value = wb.value;
+    if (wb.baud != s_uartBaud) {
+      value = (wb.baud < s_uartBaud) ? 0x00 : 0xFF;
+    }
+    if (s_rxRing.size() < SERIAL_RX_BUFFER_SIZE - 1) {
+      s_rxRing.push_back(value);
+    } else {
+      s_rxOverflows++;
+    }
+    s_rxWire.pop_front();
+  }
+}
+
+static void advanceNs(uint64_t ns) {
+  s_nowNs += ns;
+  serviceSerial();
+  if (s_tickCb) {
+    s_tickCb(s_nowNs / 1000);
+  }
+}
+
+unsigned long millis() {
+  return (unsigned long)(s_nowNs / 1000000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long)(s_nowNs / 1000ULL);
+}
+
+void delay(unsigned long ms) {
+  advanceNs((uint64_t)ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  advanceNs((uint64_t)us * 1000ULL);
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+static void recordWrite(uint8_t pin) {
+  if (s_pinCb) {
+    s_pinCb(s_nowNs / 1000, pin, s_level[pin], s_pwm[pin]);
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NUM_DIGITAL_PINS) {
+    s_mode[pin] = mode;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= NUM_DIGITAL_PINS) {
+    return;
+  }
+  s_level[pin] = val ? HIGH : LOW;
+  s_pwm[pin] = -1;
+  recordWrite(pin);
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) {
+    return LOW;
+  }
+  if (s_mode[pin] == OUTPUT) {
+    return s_level[pin];
+  }
+  if (s_inputSet[pin]) {
+    return s_inputLevel[pin];
+  }
+  return (s_mode[pin] == INPUT_PULLUP) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin) {
+  advanceNs(112000ULL);
+  if (pin < A0) {
+    pin += A0;  // analogRead(0) == analogRead(A0)
+  }
+  return (pin < NUM_DIGITAL_PINS) ? s_analog[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int val) {
+  if (pin >= NUM_DIGITAL_PINS) {
+    return;
+  }
+  val = constrain(val, 0, 255);
+  s_level[pin] = (val >= 128) ? HIGH : LOW;
+  s_pwm[pin] = (int16_t)val;
+  recordWrite(pin);
+}
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+  (void)pin;
+  (void)state;
+  if (s_echoUs == 0 || s_echoUs > timeout) {
+    advanceNs((uint64_t)timeout * 1000ULL);
+    return 0;
+  }
+  advanceNs((uint64_t)s_echoUs * 1000ULL);
+  return s_echoUs;
+}
+
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+void interrupts() {}
+void noInterrupts() {}
+
+void Servo::write(int value) {
+  angle = constrain(value, 0, 180);
+  s_servoAngle = angle;
+}
+
+// ============================================================================
+// Wire
+// ============================================================================
+
+TwoWire::TwoWire()
+  : txAddr(0), txLen(0), reg(0), rxLen(0), rxPos(0)
+{
+}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+  txAddr = addr & 0x7F;
+  txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t value) {
+  if (txLen >= sizeof(txBuf)) {
+    return 0;
+  }
+  txBuf[txLen++] = value;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  sim::I2cDevice* dev = s_i2c[txAddr];
+  if (!dev) {
+    return 2;  // Address NACK
+  }
+  // ~100kHz bus: 9 bits per byte incl. address
+  advanceNs((uint64_t)(txLen + 1) * 90000ULL);
+  if (txLen > 0) {
+    reg = txBuf[0];
+    for (uint8_t i = 1; i < txLen; i++) {
+      dev->writeRegister((uint8_t)(reg + i - 1), txBuf[i]);
+    }
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len) {
+  rxLen = 0;
+  rxPos = 0;
+  sim::I2cDevice* dev = s_i2c[addr & 0x7F];
+  if (!dev) {
+    return 0;
+  }
+  if (len > sizeof(rxBuf)) {
+    len = sizeof(rxBuf);
+  }
+  advanceNs((uint64_t)(len + 1) * 90000ULL);
+  for (uint8_t i = 0; i < len; i++) {
+    rxBuf[i] = dev->readRegister(reg++);
+  }
+  rxLen = len;
+  return len;
+}
+
+int TwoWire::available() {
+  return rxLen - rxPos;
+}
+
+int TwoWire::read() {
+  return (rxPos < rxLen) ? rxBuf[rxPos++] : -1;
+}
+
+// ============================================================================
+// Watchdog
+// ============================================================================
+
+static const uint16_t WDT_TIMEOUT_MS[] = {15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000};
+
+void wdt_reset() {
+  if (s_wdtTimeoutUs > 0) {
+    uint64_t gap = s_nowNs - s_wdtLastResetNs;
+    if (gap > s_wdtMaxGapNs) {
+      s_wdtMaxGapNs = gap;
+    }
+  }
+  s_wdtLastResetNs = s_nowNs;
+}
+
+void wdt_enable(uint8_t timeout) {
+  s_wdtTimeoutUs = (uint64_t)WDT_TIMEOUT_MS[timeout < 10 ? timeout : 9] * 1000ULL;
+  s_wdtLastResetNs = s_nowNs;
+}
+
+void wdt_disable() {
+  s_wdtTimeoutUs = 0;
+}
+
+// ============================================================================
+// Print
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base) {
+  char buf[8 * sizeof(long) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    char c = (char)(n % base);
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+size_t Print::print(const char s[]) { return write(s); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base) { return print((unsigned long)n, base); }
+size_t Print::print(int n, int base) { return print((long)n, base); }
+size_t Print::print(unsigned int n, int base) { return print((unsigned long)n, base); }
+
+size_t Print::print(long n, int base) {
+  if (base == 10 && n < 0) {
+    size_t t = print('-');
+    return t + printNumber((unsigned long)(-n), 10);
+  }
+  return printNumber((unsigned long)n, (uint8_t)base);
+}
+
+size_t Print::print(unsigned long n, int base) { return printNumber(n, (uint8_t)base); }
+
+size_t Print::print(double n, int digits) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const __FlashStringHelper* s) { return print(s) + println(); }
+size_t Print::println(const char s[]) { return print(s) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char n, int base) { return print(n, base) + println(); }
+size_t Print::println(int n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned int n, int base) { return print(n, base) + println(); }
+size_t Print::println(long n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned long n, int base) { return print(n, base) + println(); }
+size_t Print::println(double n, int digits) { return print(n, digits) + println(); }
+
+// ============================================================================
+// HardwareSerial
+// ============================================================================
+
+void HardwareSerial::begin(unsigned long baud) {
+  if (baud > 0) {
+    s_byteTimeNs = 10000000000ULL / baud;
+    s_uartBaud = (uint32_t)baud;
+  }
+}
+
+int HardwareSerial::available() {
+  return (int)s_rxRing.size();
+}
+
+int HardwareSerial::peek() {
+  return s_rxRing.empty() ? -1 : s_rxRing.front();
+}
+
+int HardwareSerial::read() {
+  if (s_rxRing.empty()) {
+    return -1;
+  }
+  uint8_t c = s_rxRing.front();
+  s_rxRing.pop_front();
+  return c;
+}
+
+int HardwareSerial::availableForWrite() {
+  return (int)(SERIAL_TX_BUFFER_SIZE - 1 - s_txRing.size());
+}
+
+void HardwareSerial::flush() {
+  while (!s_txRing.empty()) {
+    advanceNs(s_txHeadDoneNs - s_nowNs);
+  }
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  // Full ring: the real core spins until the UDRE ISR frees a slot
+  while (s_txRing.size() >= SERIAL_TX_BUFFER_SIZE - 1) {
+    advanceNs(s_txHeadDoneNs - s_nowNs);
+  }
+  if (s_txRing.empty()) {
+    s_txHeadDoneNs = s_nowNs + s_byteTimeNs;
+  }
+  s_txRing.push_back(c);
+  return 1;
+}
+
+// ============================================================================
+// Harness API
+// ============================================================================
+
+namespace sim {
+
+uint64_t nowMicros() { return s_nowNs / 1000; }
+void advanceMicros(uint64_t us) { advanceNs(us * 1000ULL); }
+void setTickCallback(TickCallback cb) { s_tickCb = cb; }
+
+void injectRx(const char* data, size_t len) {
+  uint32_t baud = s_hostBaud ? s_hostBaud : s_uartBaud;
+  uint64_t byteNs = 10000000000ULL / baud;
+  uint64_t t = (s_rxLastArrivalNs > s_nowNs) ? s_rxLastArrivalNs : s_nowNs;
+  for (size_t i = 0; i < len; i++) {
+    t += byteNs;
+    s_rxWire.push_back(WireByte{t, baud, (uint8_t)data[i]});
+  }
+  s_rxLastArrivalNs = t;
+}
+
+uint32_t rxOverflows() { return s_rxOverflows; }
+void setHostBaud(uint32_t baud) { s_hostBaud = baud; }
+uint32_t uartBaud() { return s_uartBaud; }
+void setTxLineCallback(TxLineCallback cb) { s_txLineCb = cb; }
+uint32_t txBytes() { return s_txBytes; }
+
+void setPinWriteCallback(PinWriteCallback cb) { s_pinCb = cb; }
+uint8_t pinLevel(uint8_t pin) { return pin < NUM_DIGITAL_PINS ? s_level[pin] : LOW; }
+int16_t pinPwm(uint8_t pin) { return pin < NUM_DIGITAL_PINS ? s_pwm[pin] : -1; }
+uint8_t pinModeOf(uint8_t pin) { return pin < NUM_DIGITAL_PINS ? s_mode[pin] : INPUT; }
+
+void setAnalog(uint8_t pin, uint16_t value) {
+  if (pin < A0) {
+    pin += A0;
+  }
+  if (pin < NUM_DIGITAL_PINS) {
+    s_analog[pin] = value;
+  }
+}
+
+void setDigitalInput(uint8_t pin, uint8_t level) {
+  if (pin < NUM_DIGITAL_PINS) {
+    s_inputLevel[pin] = level;
+    s_inputSet[pin] = true;
+  }
+}
+
+void setEchoMicros(uint32_t us) { s_echoUs = us; }
+int servoAngle() { return s_servoAngle; }
+
+void attachI2c(uint8_t addr, I2cDevice* dev) { s_i2c[addr & 0x7F] = dev; }
+
+uint64_t wdtMaxGapMicros() {
+  uint64_t gap = s_nowNs - s_wdtLastResetNs;
+  uint64_t maxGap = (gap > s_wdtMaxGapNs) ? gap : s_wdtMaxGapNs;
+  return (s_wdtTimeoutUs > 0) ? maxGap / 1000 : 0;
+}
+
+uint64_t wdtTimeoutMicros() { return s_wdtTimeoutUs; }
+
+}  // namespace sim
@@ -0,0 +1,291 @@
+/*
+ * Native Harness Entry Point
+ *
+ * Runs the real firmware setup()/loop() under virtual time.
+ *
+ * Usage:
+ *   .pio/build/native/program [--ms <duration>] [--script <file>] [--plant]
+ *                             [--voc <volts>] [--pins] [--quiet]
+ *
+ * Script lines (blank lines and # comments ignored):
+ *   <ms> <json>              inject "<json>\n" on the RX wire at <ms>
+ *   <ms> !echo <us>          set ultrasonic echo width (0 = no echo)
+ *   <ms> !analog <pin> <v>   set analogRead() value (pin 0-5 = A0-A5)
+ *   <ms> !input <pin> <0|1>  set digital input level
+ *   <ms> !segment <name>     start a scenario segment (--plant)
+ *   <ms> !wall <cm>          wall <cm> ahead of the robot, 0 = none (--plant)
+ *   <ms> !baud <rate>        host-side baud rate, 0 = follow the UNO (N=124)
+ *
+ * --plant closes the loop through the differential-drive model in
+ * sim/plant.h (wheel dynamics, battery sag, MPU6050 gyro, wall echo) and
+ * reports rise time, overshoot and stop distance per segment. --voc sets the
+ * pack's open-circuit voltage (default 7.8V) to compare charge levels.
+ *
+ * Output: every UNO TX line with its virtual timestamp, the latency from
+ * each injected command to the first line that follows it, and a summary
+ * (response latency, motor PWM write cadence, watchdog margin).
+ */
+
+// STL before Arduino.h (its min/max/abs macros break libstdc++)
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include <Arduino.h>
+#include "sim/sim.h"
+#include "sim/plant.h"
+#include "sim/scenario.h"
+#include "board/board_elegoo_uno_smartcar_shield_v11.h"
+
+void setup();
+void loop();
+
+struct ScriptEvent {
+  uint64_t atUs;
+  std::string text;
+};
+
+struct Stats {
+  uint64_t count;
+  uint64_t minUs;
+  uint64_t maxUs;
+  uint64_t sumUs;
+
+  Stats() : count(0), minUs(UINT64_MAX), maxUs(0), sumUs(0) {}
+
+  void add(uint64_t us) {
+    count++;
+    sumUs += us;
+    if (us < minUs) minUs = us;
+    if (us > maxUs) maxUs = us;
+  }
+
+  void print(const char* label) const {
+    if (count == 0) {
+      printf("%-14s n=0\n", label);
+      return;
+    }
+    printf("%-14s n=%llu min=%lluus avg=%lluus max=%lluus\n", label,
+           (unsigned long long)count, (unsigned long long)minUs,
+           (unsigned long long)(sumUs / count), (unsigned long long)maxUs);
+  }
+};
+
+static bool g_quiet = false;
+static bool g_tracePins = false;
+
+// Latency: injected command -> first TX line after it
+static bool g_awaitingResponse = false;
+static uint64_t g_commandSentUs = 0;
+static Stats g_latency;
+
+// Motor PWM write cadence (PWMA/PWMB)
+static uint64_t g_lastPwmWriteUs[2] = {0, 0};
+static Stats g_pwmCadence[2];
+
+// Closed-loop plant (--plant)
+static sim::Plant* g_plant = nullptr;
+static sim::ScenarioMeter g_scenarios;
+
+static void onPlantSample(const sim::PlantSample& s) {
+  g_scenarios.sample(s);
+}
+
+static void onTxLine(uint64_t tUs, const char* line, size_t len) {
+  if (g_awaitingResponse) {
+    uint64_t lat = tUs - g_commandSentUs;
+    g_latency.add(lat);
+    g_awaitingResponse = false;
+    if (!g_quiet) {
+      printf("[%10.3f] %.*s  (lat=%lluus)\n", tUs / 1000.0, (int)len, line, (unsigned long long)lat);
+    }
+    return;
+  }
+  if (!g_quiet) {
+    printf("[%10.3f] %.*s\n", tUs / 1000.0, (int)len, line);
+  }
+}
+
+static void onPinWrite(uint64_t tUs, uint8_t pin, uint8_t level, int16_t pwm) {
+  int idx = (pin == PIN_MOTOR_PWMA) ? 0 : ((pin == PIN_MOTOR_PWMB) ? 1 : -1);
+  if (idx >= 0) {
+    if (g_lastPwmWriteUs[idx] > 0) {
+      g_pwmCadence[idx].add(tUs - g_lastPwmWriteUs[idx]);
+    }
+    g_lastPwmWriteUs[idx] = tUs;
+  }
+  if (g_tracePins) {
+    printf("[%10.3f] pin %u = %u pwm=%d\n", tUs / 1000.0, pin, level, pwm);
+  }
+}
+
+static bool loadScript(const char* path, std::vector<ScriptEvent>& events) {
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "cannot open script %s\n", path);
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line[line.size() - 1] == '\r') {
+      line.erase(line.size() - 1);
+    }
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#') {
+      continue;
+    }
+    std::istringstream ss(line.substr(start));
+    double ms = 0;
+    ss >> ms;
+    std::string rest;
+    std::getline(ss, rest);
+    size_t textStart = rest.find_first_not_of(" \t");
+    ScriptEvent ev;
+    ev.atUs = (uint64_t)(ms * 1000.0);
+    ev.text = (textStart == std::string::npos) ? std::string() : rest.substr(textStart);
+    events.push_back(ev);
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const ScriptEvent& a, const ScriptEvent& b) { return a.atUs < b.atUs; });
+  return true;
+}
+
+static void applyEvent(const ScriptEvent& ev) {
+  if (!ev.text.empty() && ev.text[0] == '!') {
+    std::istringstream ss(ev.text.substr(1));
+    std::string cmd;
+    ss >> cmd;
+    if (cmd == "echo") {
+      unsigned long us = 0;
+      ss >> us;
+      sim::setEchoMicros((uint32_t)us);
+    } else if (cmd == "analog") {
+      unsigned pin = 0, value = 0;
+      ss >> pin >> value;
+      sim::setAnalog((uint8_t)pin, (uint16_t)value);
+    } else if (cmd == "input") {
+      unsigned pin = 0, level = 0;
+      ss >> pin >> level;
+      sim::setDigitalInput((uint8_t)pin, level ? HIGH : LOW);
+    } else if (cmd == "segment") {
+      std::string name;
+      ss >> name;
+      g_scenarios.begin(name, sim::nowMicros());
+      if (!g_quiet) {
+        printf("[%10.3f] -- segment %s\n", sim::nowMicros() / 1000.0, name.c_str());
+      }
+    } else if (cmd == "wall") {
+      float cm = 0;
+      ss >> cm;
+      if (g_plant) {
+        if (g_plant->hasWall() && !g_quiet) {
+          printf("[%10.3f] -- wall removed, closest approach %.1fcm\n",
+                 sim::nowMicros() / 1000.0, g_plant->wallMinCm());
+        }
+        g_plant->setWallAhead(cm);
+      }
+    } else if (cmd == "baud") {
+      unsigned long baud = 0;
+      ss >> baud;
+      sim::setHostBaud((uint32_t)baud);
+      if (!g_quiet) {
+        printf("[%10.3f] -- host baud %lu (UNO %lu)\n", sim::nowMicros() / 1000.0,
+               baud, (unsigned long)sim::uartBaud());
+      }
+    } else {
+      fprintf(stderr, "unknown directive: %s\n", ev.text.c_str());
+    }
+    return;
+  }
+
+  std::string frame = ev.text + "\n";
+  sim::injectRx(frame.c_str(), frame.size());
+  g_commandSentUs = sim::nowMicros();
+  g_awaitingResponse = true;
+  if (!g_quiet) {
+    printf("[%10.3f] >> %s\n", g_commandSentUs / 1000.0, ev.text.c_str());
+  }
+}
+
+int main(int argc, char** argv) {
+  uint64_t durationMs = 5000;
+  const char* scriptPath = nullptr;
+  bool usePlant = false;
+  sim::PlantConfig plantCfg;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--ms" && i + 1 < argc) {
+      durationMs = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--script" && i + 1 < argc) {
+      scriptPath = argv[++i];
+    } else if (arg == "--plant") {
+      usePlant = true;
+    } else if (arg == "--voc" && i + 1 < argc) {
+      plantCfg.vOpenCircuit = strtof(argv[++i], nullptr);
+    } else if (arg == "--pins") {
+      g_tracePins = true;
+    } else if (arg == "--quiet") {
+      g_quiet = true;
+    } else {
+      fprintf(stderr, "usage: %s [--ms N] [--script FILE] [--plant] [--voc V] [--pins] [--quiet]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<ScriptEvent> events;
+  if (scriptPath && !loadScript(scriptPath, events)) {
+    return 2;
+  }
+
+  sim::setTxLineCallback(onTxLine);
+  sim::setPinWriteCallback(onPinWrite);
+
+  static sim::Plant plant(plantCfg);
+  if (usePlant) {
+    g_plant = &plant;
+    plant.setSampleCallback(onPlantSample);
+    plant.attach();
+  }
+
+  setup();
+
+  size_t nextEvent = 0;
+  uint64_t loops = 0;
+  const uint64_t endUs = durationMs * 1000ULL;
+  while (sim::nowMicros() < endUs) {
+    while (nextEvent < events.size() && events[nextEvent].atUs <= sim::nowMicros()) {
+      applyEvent(events[nextEvent++]);
+    }
+    loop();
+    loops++;
+  }
+
+  g_scenarios.end();
+
+  printf("--- summary @ %.3fms ---\n", sim::nowMicros() / 1000.0);
+  printf("loops=%llu tx_bytes=%u rx_overflows=%u\n",
+         (unsigned long long)loops, sim::txBytes(), sim::rxOverflows());
+  g_latency.print("cmd_latency");
+  g_pwmCadence[0].print("pwma_cadence");
+  g_pwmCadence[1].print("pwmb_cadence");
+  if (g_plant) {
+    const sim::PlantSample& s = g_plant->state();
+    printf("plant x=%.1fcm y=%.1fcm heading=%.1fdeg odo=%.1fcm vbat=%.2fV\n",
+           s.xCm, s.yCm, s.headingDeg, s.odometerCm, s.batteryV);
+    if (g_plant->hasWall()) {
+      printf("plant wall_min=%.1fcm\n", g_plant->wallMinCm());
+    }
+    g_scenarios.print();
+  }
+
+  uint64_t wdtGap = sim::wdtMaxGapMicros();
+  uint64_t wdtTimeout = sim::wdtTimeoutMicros();
+  printf("wdt_max_gap=%lluus timeout=%lluus%s\n",
+         (unsigned long long)wdtGap, (unsigned long long)wdtTimeout,
+         (wdtTimeout > 0 && wdtGap >= wdtTimeout) ? "  ** WOULD RESET **" : "");
+
+  return (wdtTimeout > 0 && wdtGap >= wdtTimeout) ? 1 : 0;
+}
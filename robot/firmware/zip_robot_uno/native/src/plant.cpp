@@ -0,0 +1,241 @@
+/*
+ * Differential-Drive Plant Model Implementation (native build)
+ *
+ * Integrates at a fixed 250us substep regardless of how the firmware
+ * advances time, so a delay(100) and a hundred 1ms loop() passes give the
+ * same trajectory.
+ */
+
+#include <Arduino.h>
+#include "sim/sim.h"
+#include "sim/plant.h"
+#include "board/board_elegoo_uno_smartcar_shield_v11.h"
+
+namespace sim {
+
+static const uint32_t PLANT_STEP_US = 250;
+static const uint32_t PLANT_SAMPLE_STEPS = 4;  // 1ms samples
+static const float MPU_GYRO_LSB_PER_DPS = 131.0f;  // +-250 dps range
+static const float MPU_ACCEL_LSB_PER_G = 16384.0f;  // +-2 g range
+static const float ECHO_US_PER_CM = 58.31f;        // 2 / 0.0343
+static const float RAD_TO_DEG_F = 57.29578f;
+
+static Plant* s_attached = nullptr;
+
+static void plantTick(uint64_t nowUs) {
+  if (s_attached) {
+    s_attached->advanceTo(nowUs);
+  }
+}
+
+// I2C adapter so the plant itself stays free of the sim::I2cDevice vtable
+class Mpu6050Fake : public I2cDevice {
+public:
+  void writeRegister(uint8_t reg, uint8_t value) override {
+    if (s_attached) {
+      s_attached->mpuWrite(reg, value);
+    }
+  }
+  uint8_t readRegister(uint8_t reg) override {
+    return s_attached ? s_attached->mpuRegister(reg) : 0xFF;
+  }
+};
+
+static Mpu6050Fake s_mpu;
+
+Plant::Plant(const PlantConfig& config)
+  : cfg(config)
+  , sampleCb(nullptr)
+  , lastUs(0)
+  , substep(0)
+  , accelCmS2(0)
+  , wallSet(false)
+  , wallHeadingDeg(0)
+  , wallOffsetCm(0)
+  , wallMin(0)
+{
+  s.tUs = 0;
+  s.leftCmS = 0;
+  s.rightCmS = 0;
+  s.leftDuty = 0;
+  s.rightDuty = 0;
+  s.batteryV = cfg.vOpenCircuit - cfg.rInternalOhm * cfg.iLogicA;
+  s.xCm = 0;
+  s.yCm = 0;
+  s.headingDeg = 0;
+  s.yawRateDps = 0;
+  s.odometerCm = 0;
+  for (uint8_t i = 0; i < sizeof(mpuRegs); i++) {
+    mpuRegs[i] = 0;
+  }
+  mpuRegs[0x75] = 0x68;  // WHO_AM_I
+  mpuRegs[0x6B] = 0x40;  // PWR_MGMT_1: SLEEP set at power-up
+}
+
+void Plant::attach() {
+  s_attached = this;
+  lastUs = nowMicros();
+  s.tUs = lastUs;
+  setTickCallback(plantTick);
+  attachI2c(0x68, &s_mpu);
+  publishSensors();
+}
+
+void Plant::setWallAhead(float cm) {
+  float rad = s.headingDeg / RAD_TO_DEG_F;
+  wallSet = cm > 0;
+  wallHeadingDeg = s.headingDeg;
+  wallOffsetCm = s.xCm * cosf(rad) + s.yCm * sinf(rad) + cm;
+  wallMin = cm;
+  publishSensors();
+}
+
+void Plant::advanceTo(uint64_t nowUs) {
+  while (nowUs - lastUs >= PLANT_STEP_US) {
+    lastUs += PLANT_STEP_US;
+    s.tUs = lastUs;
+    step(PLANT_STEP_US / 1000000.0f);
+    if (++substep >= PLANT_SAMPLE_STEPS) {
+      substep = 0;
+      publishSensors();
+      if (sampleCb) {
+        sampleCb(s);
+      }
+    }
+  }
+}
+
+static float pinDuty(uint8_t pwmPin, uint8_t dirPin) {
+  int16_t pwm = pinPwm(pwmPin);
+  if (pwm < 0) {
+    pwm = pinLevel(pwmPin) ? 255 : 0;  // Plain digitalWrite on the PWM pin
+  }
+  float duty = pwm / 255.0f;
+  return pinLevel(dirPin) ? duty : -duty;  // TB6612 on this shield: IN1 HIGH = forward
+}
+
+float Plant::wheelTarget(float duty, float gain, float batteryV, float v) const {
+  float vApp = duty * batteryV;
+  float mag = vApp < 0 ? -vApp : vApp;
+  float vFric = cfg.frictionPwm / 255.0f * cfg.vNom;
+  float vBreak = cfg.breakawayPwm / 255.0f * cfg.vNom;
+  float speed = v < 0 ? -v : v;
+
+  if (speed < 0.5f && mag < vBreak) {
+    return 0;  // Stiction holds a stopped wheel
+  }
+  if (mag <= vFric) {
+    return 0;
+  }
+  float target = cfg.vMaxCmS * gain * (mag - vFric) / (cfg.vNom - vFric);
+  return vApp < 0 ? -target : target;
+}
+
+void Plant::step(float dtS) {
+  bool standby = pinLevel(PIN_MOTOR_STBY) == LOW;
+  s.rightDuty = standby ? 0 : pinDuty(PIN_MOTOR_PWMA, PIN_MOTOR_AIN_1);
+  s.leftDuty = standby ? 0 : pinDuty(PIN_MOTOR_PWMB, PIN_MOTOR_BIN_1);
+
+  // Pack sag from the previous step's speeds (back-EMF limits the current)
+  float current = cfg.iLogicA;
+  const float duties[2] = {s.leftDuty, s.rightDuty};
+  const float speeds[2] = {s.leftCmS, s.rightCmS};
+  for (uint8_t i = 0; i < 2; i++) {
+    float d = duties[i] < 0 ? -duties[i] : duties[i];
+    float vEmf = (speeds[i] < 0 ? -speeds[i] : speeds[i]) / cfg.vMaxCmS * cfg.vNom;
+    float headroom = s.batteryV - vEmf;
+    if (headroom > 0) {
+      current += d * headroom / cfg.rMotorOhm;
+    }
+  }
+  s.batteryV = cfg.vOpenCircuit - cfg.rInternalOhm * current;
+
+  float prevMean = (s.leftCmS + s.rightCmS) * 0.5f;
+  float* wheels[2] = {&s.leftCmS, &s.rightCmS};
+  const float gains[2] = {cfg.leftGain, cfg.rightGain};
+  for (uint8_t i = 0; i < 2; i++) {
+    float v = *wheels[i];
+    float target = wheelTarget(duties[i], gains[i], s.batteryV, v);
+    if (duties[i] == 0) {
+      float drag = cfg.rollDecelCmS2 * dtS;
+      v -= v * (dtS * 1000.0f / cfg.tauCoastMs);
+      v = (v > drag) ? v - drag : ((v < -drag) ? v + drag : 0);
+    } else {
+      v += (target - v) * (dtS * 1000.0f / cfg.tauMs);
+    }
+    if (target == 0 && v > -0.5f && v < 0.5f) {
+      v = 0;
+    }
+    *wheels[i] = v;
+  }
+  accelCmS2 = ((s.leftCmS + s.rightCmS) * 0.5f - prevMean) / dtS;
+
+  // Chassis kinematics (z up: positive yaw = counter-clockwise = right wheel faster)
+  float omega = (s.rightCmS - s.leftCmS) / cfg.trackCm;  // rad/s
+  float v = (s.leftCmS + s.rightCmS) * 0.5f;
+  float headingRad = s.headingDeg / RAD_TO_DEG_F;
+  s.xCm += v * cosf(headingRad) * dtS;
+  s.yCm += v * sinf(headingRad) * dtS;
+  s.headingDeg += omega * RAD_TO_DEG_F * dtS;
+  s.yawRateDps = omega * RAD_TO_DEG_F;
+  float absL = s.leftCmS < 0 ? -s.leftCmS : s.leftCmS;
+  float absR = s.rightCmS < 0 ? -s.rightCmS : s.rightCmS;
+  s.odometerCm += (absL + absR) * 0.5f * dtS;
+}
+
+void Plant::publishSensors() {
+  // Battery divider: inverse of BatteryMonitor's adc * 0.0375 * 1.08
+  float adc = s.batteryV / (0.0375f * 1.08f);
+  setAnalog(PIN_VOLTAGE, (uint16_t)(adc + 0.5f));
+
+  if (wallSet) {
+    float rad = wallHeadingDeg / RAD_TO_DEG_F;
+    float dist = wallOffsetCm - (s.xCm * cosf(rad) + s.yCm * sinf(rad));
+    if (dist < wallMin) {
+      wallMin = dist;
+    }
+    float rel = s.headingDeg - wallHeadingDeg;
+    int servo = servoAngle();
+    bool facingWall = servo > 75 && servo < 105 && rel > -30 && rel < 30;
+    if (!facingWall || dist > 400) {
+      setEchoMicros(0);
+    } else {
+      setEchoMicros((uint32_t)((dist < 2 ? 2 : dist) * ECHO_US_PER_CM));
+    }
+  }
+}
+
+static void putWord(uint8_t* regs, uint8_t reg, int16_t value) {
+  regs[reg] = (uint8_t)((uint16_t)value >> 8);
+  regs[reg + 1] = (uint8_t)(value & 0xFF);
+}
+
+static int16_t clampLsb(float value) {
+  if (value > 32767.0f) return 32767;
+  if (value < -32768.0f) return -32768;
+  return (int16_t)value;
+}
+
+uint8_t Plant::mpuRegister(uint8_t reg) const {
+  reg &= 0x7F;
+  if (reg >= 0x3B && reg <= 0x48) {
+    uint8_t regs[0x49];
+    putWord(regs, 0x3B, clampLsb(accelCmS2 / 981.0f * MPU_ACCEL_LSB_PER_G));  // Forward
+    putWord(regs, 0x3D, 0);
+    putWord(regs, 0x3F, (int16_t)MPU_ACCEL_LSB_PER_G);                       // 1 g down
+    putWord(regs, 0x41, 0);                                                   // Temp
+    putWord(regs, 0x43, 0);
+    putWord(regs, 0x45, 0);
+    putWord(regs, 0x47, clampLsb(s.yawRateDps * MPU_GYRO_LSB_PER_DPS + cfg.gyroBiasLsb));
+    return regs[reg];
+  }
+  return mpuRegs[reg];
+}
+
+void Plant::mpuWrite(uint8_t reg, uint8_t value) {
+  if ((reg & 0x7F) != 0x75) {
+    mpuRegs[reg & 0x7F] = value;
+  }
+}
+
+}  // namespace sim
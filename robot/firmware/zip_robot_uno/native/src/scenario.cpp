@@ -0,0 +1,138 @@
+/*
+ * Scenario Meter Implementation (native build)
+ */
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+#include "sim/scenario.h"
+
+namespace sim {
+
+static const uint64_t STEADY_WINDOW_US = 100000;
+static const float REST_CM_S = 0.5f;
+
+static float absf(float v) { return v < 0 ? -v : v; }
+
+void ScenarioMeter::begin(const std::string& segmentName, uint64_t tUs) {
+  end();
+  name = segmentName;
+  startUs = tUs;
+  trace.clear();
+  open = true;
+}
+
+void ScenarioMeter::sample(const PlantSample& s) {
+  if (!open) {
+    return;
+  }
+  Point p;
+  p.tUs = s.tUs;
+  p.speed = (absf(s.leftCmS) + absf(s.rightCmS)) * 0.5f;
+  p.odometer = s.odometerCm;
+  p.driven = s.leftDuty != 0 || s.rightDuty != 0;
+  p.batteryV = s.batteryV;
+  trace.push_back(p);
+}
+
+void ScenarioMeter::end() {
+  if (!open) {
+    return;
+  }
+  done.push_back(analyze());
+  open = false;
+  trace.clear();
+}
+
+ScenarioResult ScenarioMeter::analyze() const {
+  ScenarioResult r;
+  r.name = name;
+  r.moved = false;
+  r.lagMs = r.riseMs = r.steadyCmS = r.peakCmS = r.overshootPct = 0;
+  r.stopped = false;
+  r.stopMs = r.stopCm = 0;
+  r.minBatteryV = trace.empty() ? 0 : trace[0].batteryV;
+
+  // Stop point: first undriven sample after motion
+  size_t stopIdx = trace.size();
+  bool moving = false;
+  for (size_t i = 0; i < trace.size(); i++) {
+    if (trace[i].batteryV < r.minBatteryV) {
+      r.minBatteryV = trace[i].batteryV;
+    }
+    if (trace[i].speed > REST_CM_S) {
+      moving = true;
+      r.moved = true;
+    }
+    if (moving && stopIdx == trace.size() && !trace[i].driven) {
+      stopIdx = i;
+    }
+  }
+  if (!r.moved) {
+    return r;
+  }
+
+  // Steady state: mean over the last window before the stop point
+  uint64_t driveEndUs = (stopIdx < trace.size()) ? trace[stopIdx].tUs : trace.back().tUs;
+  float sum = 0;
+  uint32_t n = 0;
+  for (size_t i = 0; i < stopIdx; i++) {
+    if (trace[i].tUs + STEADY_WINDOW_US >= driveEndUs) {
+      sum += trace[i].speed;
+      n++;
+    }
+    if (trace[i].speed > r.peakCmS) {
+      r.peakCmS = trace[i].speed;
+    }
+  }
+  r.steadyCmS = n ? sum / n : 0;
+
+  if (r.steadyCmS > REST_CM_S) {
+    uint64_t t10 = 0, t90 = 0;
+    for (size_t i = 0; i < stopIdx; i++) {
+      if (!t10 && trace[i].speed >= 0.1f * r.steadyCmS) {
+        t10 = trace[i].tUs;
+      }
+      if (!t90 && trace[i].speed >= 0.9f * r.steadyCmS) {
+        t90 = trace[i].tUs;
+        break;
+      }
+    }
+    r.lagMs = t10 ? (t10 - startUs) / 1000.0f : 0;
+    r.riseMs = (t10 && t90) ? (t90 - t10) / 1000.0f : 0;
+    r.overshootPct = (r.peakCmS - r.steadyCmS) / r.steadyCmS * 100.0f;
+  }
+
+  if (stopIdx < trace.size()) {
+    for (size_t i = stopIdx; i < trace.size(); i++) {
+      if (trace[i].speed <= REST_CM_S) {
+        r.stopped = true;
+        r.stopMs = (trace[i].tUs - trace[stopIdx].tUs) / 1000.0f;
+        r.stopCm = trace[i].odometer - trace[stopIdx].odometer;
+        break;
+      }
+    }
+  }
+  return r;
+}
+
+void ScenarioMeter::print() const {
+  for (size_t i = 0; i < done.size(); i++) {
+    const ScenarioResult& r = done[i];
+    if (!r.moved) {
+      printf("SCENARIO %s no_motion vbat_min=%.2fV\n", r.name.c_str(), r.minBatteryV);
+      continue;
+    }
+    printf("SCENARIO %s lag=%.0fms rise=%.0fms steady=%.1fcm/s overshoot=%.1f%%",
+           r.name.c_str(), r.lagMs, r.riseMs, r.steadyCmS, r.overshootPct);
+    if (r.stopped) {
+      printf(" stop=%.0fms/%.1fcm", r.stopMs, r.stopCm);
+    } else {
+      printf(" stop=none");
+    }
+    printf(" vbat_min=%.2fV\n", r.minBatteryV);
+  }
+}
+
+}  // namespace sim
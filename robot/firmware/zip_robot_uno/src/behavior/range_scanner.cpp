@@ -0,0 +1,164 @@
+/*
+ * Range Scanner Implementation
+ *
+ * Per-stop cost = servo travel (SERVO_MS_PER_DEG * step) + SCAN_SETTLE_MS
+ * + echo time (<= SCAN_ECHO_TIMEOUT_US). A 0..180 sweep at 5 degrees takes
+ * ~1.5s instead of ~20s of N=5/N=21 round trips.
+ */
+
+#include "behavior/range_scanner.h"
+#include "hal/servo_pan.h"
+#include "hal/ultrasonic.h"
+#include "motion/collision_reflex.h"
+#include "../serial/response_writer.h"
+#include <string.h>
+
+RangeScanner rangeScanner;
+
+RangeScanner::RangeScanner()
+  : servo(nullptr)
+  , sonar(nullptr)
+  , state(SCAN_IDLE)
+  , startAngle(0)
+  , step(0)
+  , count(0)
+  , index(0)
+  , headerSent(false)
+  , restoreAngle(SERVO_ANGLE_CENTER)
+  , readyAtMs(0)
+  , scansCompleted(0)
+{
+  tag[0] = '\0';
+}
+
+void RangeScanner::init(ServoPan* servoPtr, UltrasonicHC_SR04* sonarPtr) {
+  servo = servoPtr;
+  sonar = sonarPtr;
+  state = SCAN_IDLE;
+}
+
+bool RangeScanner::start(int16_t startDeg, int16_t endDeg, int16_t stepDeg, const char* tagStr) {
+  if (state != SCAN_IDLE || !servo || !sonar || stepDeg == 0) {
+    return false;
+  }
+  if (startDeg < SERVO_ANGLE_MIN || startDeg > SERVO_ANGLE_MAX ||
+      endDeg < SERVO_ANGLE_MIN || endDeg > SERVO_ANGLE_MAX) {
+    return false;
+  }
+
+  // Step sign follows sweep direction
+  int16_t span = endDeg - startDeg;
+  int16_t absStep = abs(stepDeg);
+  if (absStep > 90) {
+    return false;
+  }
+  int16_t points = abs(span) / absStep + 1;
+  if (points > SCAN_MAX_POINTS) {
+    return false;
+  }
+
+  startAngle = (uint8_t)startDeg;
+  step = (int8_t)((span < 0) ? -absStep : absStep);
+  count = (uint8_t)points;
+  index = 0;
+  restoreAngle = servo->getAngle();
+
+  strncpy(tag, tagStr ? tagStr : "", sizeof(tag) - 1);
+  tag[sizeof(tag) - 1] = '\0';
+
+  servo->attachHold();
+  moveTo(startAngle);
+  state = SCAN_MOVING;
+  return true;
+}
+
+void RangeScanner::cancel() {
+  if (state != SCAN_MOVING) {
+    return;  // Idle, or already on the way back
+  }
+  moveTo(restoreAngle);
+  state = SCAN_RETURNING;
+}
+
+void RangeScanner::moveTo(uint8_t angle) {
+  uint16_t travelMs = servo->moveNoWait(angle);
+  readyAtMs = millis() + travelMs + SCAN_SETTLE_MS;
+}
+
+void RangeScanner::update() {
+  if (state == SCAN_IDLE) {
+    return;
+  }
+  if (state == SCAN_SENDING) {
+    // Servo is already heading back; write as much as fits, never block
+    while (Serial.availableForWrite() >= SCAN_TX_CHUNK_MAX) {
+      if (sendChunk()) {
+        scansCompleted++;
+        state = SCAN_RETURNING;
+        break;
+      }
+    }
+    return;
+  }
+  if ((long)(millis() - readyAtMs) < 0) {
+    return;  // Servo still travelling
+  }
+
+  if (state == SCAN_RETURNING) {
+    servo->release();
+    state = SCAN_IDLE;
+    return;
+  }
+
+  // SCAN_MOVING: servo settled at current stop - ping
+  uint16_t d = sonar->measure(SCAN_ECHO_TIMEOUT_US);
+  distances[index] = (d > 255) ? 255 : (uint8_t)d;
+
+#if COLLISION_REFLEX_ENABLED
+  // Forward-facing samples are still valid obstacle data for the reflex
+  uint8_t angle = servo->getAngle();
+  if (abs((int16_t)angle - SERVO_ANGLE_CENTER) <= SCAN_REFLEX_CONE_DEG) {
+    collisionReflex.updateDistance(d, sonar->getLastReadTime());
+  }
+#endif
+
+  index++;
+  if (index < count) {
+    moveTo((uint8_t)(startAngle + (int16_t)step * index));
+    return;
+  }
+
+  // Put the head back where N=5 left it while the result goes out
+  moveTo(restoreAngle);
+  index = 0;
+  headerSent = false;
+  state = SCAN_SENDING;
+}
+
+bool RangeScanner::sendChunk() {
+  // Format: {<H>_<start>,<step>,<n>:<d0>,<d1>,...}
+  // Up to ~150 bytes - as one write it blocked ~13ms on a full TX ring, so
+  // it goes out in SCAN_TX_CHUNK_MAX pieces across loop passes instead.
+  // Returns true once the closing brace is written.
+  ResponseWriter w;
+  if (!headerSent) {
+    w.begin(tag).num((uint16_t)startAngle);
+    w.ch(',').num((int16_t)step);
+    w.ch(',').num((uint16_t)count).ch(':');
+    headerSent = true;
+    return false;
+  }
+
+  uint8_t last = (uint8_t)min((uint16_t)index + SCAN_TX_POINTS, (uint16_t)count);
+  for (; index < last; index++) {
+    if (index > 0) {
+      w.ch(',');
+    }
+    w.num((uint16_t)distances[index]);
+  }
+  if (index < count) {
+    return false;
+  }
+  w.end();
+  return true;
+}
@@ -0,0 +1,172 @@
+/*
+ * Black-Box Flight Recorder Implementation
+ */
+
+#include "core/black_box.h"
+
+BlackBox blackBox;
+
+#if BLACK_BOX_ENABLED
+
+struct BlackBoxStore {
+  uint16_t magic;
+  uint8_t head;        // Next slot to write
+  uint8_t count;       // Valid records (<= BLACK_BOX_RECORDS)
+  uint8_t boots;       // Boots since the ring was frozen
+  uint8_t cause;       // MCUSR at the freezing boot
+  uint8_t frozen;
+  uint8_t check;       // Over the header bytes above
+  uint32_t lastMs;     // millis() of the newest record
+  BlackBoxRecord rec[BLACK_BOX_RECORDS];
+};
+
+// .noinit: left alone by the C runtime, so it outlives a reset. The native
+// build has no such section - the ring simply starts zeroed (invalid).
+#if defined(__AVR__)
+static BlackBoxStore store __attribute__((section(".noinit")));
+#else
+static BlackBoxStore store;
+#endif
+
+static_assert(BLACK_BOX_RECORDS > 0 && BLACK_BOX_RECORDS < 256, "black box ring size");
+
+static uint8_t headerCheck() {
+  return (uint8_t)(0xA5 ^ (store.magic >> 8) ^ store.magic ^ store.head ^
+                   store.count ^ store.boots ^ store.cause ^ store.frozen);
+}
+
+static bool headerValid() {
+  return store.magic == BLACK_BOX_MAGIC &&
+         store.head < BLACK_BOX_RECORDS &&
+         store.count <= BLACK_BOX_RECORDS &&
+         store.check == headerCheck();
+}
+
+static int8_t half(int16_t x) {
+  return (int8_t)(constrain(x, -255, 255) / 2);
+}
+
+void BlackBox::rearm() {
+  store.magic = BLACK_BOX_MAGIC;
+  store.head = 0;
+  store.count = 0;
+  store.boots = 0;
+  store.cause = 0;
+  store.frozen = 0;
+  store.lastMs = 0;
+  store.check = headerCheck();
+}
+
+void BlackBox::boot() {
+  uint8_t cause = 0;
+#ifdef MCUSR
+  cause = MCUSR;
+  MCUSR = 0;
+#endif
+
+  if (!headerValid()) {
+    rearm();
+    return;
+  }
+
+  if (store.frozen) {
+    if (store.boots < 255) {
+      store.boots++;
+    }
+    store.check = headerCheck();
+    return;
+  }
+
+  // Was the loop driving when the reset hit?
+  bool active = false;
+  if (store.count > 0) {
+    const BlackBoxRecord& last =
+        store.rec[(store.head + BLACK_BOX_RECORDS - 1) % BLACK_BOX_RECORDS];
+    active = last.pwmL2 != 0 || last.pwmR2 != 0 ||
+             (last.state & (BB_STATE_MOTION_MASK | BB_STATE_INIT)) != 0;
+  }
+#if defined(WDRF) && defined(BORF)
+  if (cause & (_BV(WDRF) | _BV(BORF))) {
+    active = true;
+  }
+#endif
+
+  if (!active) {
+    rearm();
+    return;
+  }
+  store.frozen = 1;
+  store.boots = 1;
+  store.cause = cause;
+  store.check = headerCheck();
+}
+
+void BlackBox::record(int16_t v, int16_t w, int16_t pwmL, int16_t pwmR,
+                      int16_t yawX10, uint8_t state) {
+  if (store.frozen || ++skip < BLACK_BOX_EVERY) {
+    return;
+  }
+  skip = 0;
+  uint32_t now = millis();
+  uint32_t dt = (store.count > 0) ? now - store.lastMs : 0;
+
+  BlackBoxRecord& r = store.rec[store.head];
+  r.v2 = half(v);
+  r.w2 = half(w);
+  r.pwmL2 = half(pwmL);
+  r.pwmR2 = half(pwmR);
+  r.battMv40 = (uint8_t)min((uint16_t)(battMv / 40), (uint16_t)255);
+  r.yaw = (int8_t)constrain((int32_t)yawX10 * 128 / 1800, (int32_t)-128, (int32_t)127);
+  r.state = state;
+  r.dtMs = (uint8_t)min(dt, (uint32_t)255);
+
+  store.head = (uint8_t)((store.head + 1) % BLACK_BOX_RECORDS);
+  if (store.count < BLACK_BOX_RECORDS) {
+    store.count++;
+  }
+  store.lastMs = now;
+  store.check = headerCheck();
+}
+
+void BlackBox::dump(const char* tag) const {
+  Serial.print('{');
+  Serial.print(tag);
+  Serial.print(F("_bb:"));
+  Serial.print(store.count);
+  Serial.print(',');
+  Serial.print(store.boots);
+  Serial.print(',');
+  Serial.print(store.cause);
+  Serial.print(',');
+  Serial.print(store.lastMs);
+  Serial.print(',');
+  Serial.print(store.frozen);
+  Serial.print(F("}\n"));
+
+  // Oldest first; blocks on the TX ring (~25ms for a full ring at 115200)
+  uint8_t i = (uint8_t)((store.head + BLACK_BOX_RECORDS - store.count) % BLACK_BOX_RECORDS);
+  for (uint8_t n = 0; n < store.count; n++) {
+    Serial.write((const uint8_t*)&store.rec[i], sizeof(BlackBoxRecord));
+    i = (uint8_t)((i + 1) % BLACK_BOX_RECORDS);
+  }
+  Serial.write('\n');  // Lets line-based readers resync
+}
+
+bool BlackBox::isFrozen() const {
+  return store.frozen != 0;
+}
+
+uint8_t BlackBox::getCount() const {
+  return store.count;
+}
+
+#else
+
+void BlackBox::boot() {}
+void BlackBox::record(int16_t, int16_t, int16_t, int16_t, int16_t, uint8_t) {}
+void BlackBox::rearm() {}
+void BlackBox::dump(const char*) const {}
+bool BlackBox::isFrozen() const { return false; }
+uint8_t BlackBox::getCount() const { return 0; }
+
+#endif // BLACK_BOX_ENABLED
@@ -12,6 +12,7 @@
 #include "../../include/hal/line_sensor.h"
 #include "../../include/hal/imu_mpu6050.h"
 #include "../../include/hal/servo_pan.h"
+#include "../../include/hal/fast_pin.h"
 
 // External HAL instances (from main.cpp)
 extern BatteryMonitor batteryMonitor;
@@ -34,7 +35,27 @@ InitSequence::InitSequence()
   , yawDelta(0)
   , initBatteryMv(0)
   , initUltrasonicCm(0)
+  , calRequested(false)
+  , calStatus(CAL_STATUS_NONE)
+  , calRun(0)
+  , calPhase(CAL_SETTLE_RAMP)
+  , calPwm(0)
+  , calAbove(0)
+  , calSamples(0)
+  , calBase(0)
+  , calThresh(0)
+  , calMin(0)
+  , calMax(0)
+  , calSum(0)
+  , calPrevDev(0)
+  , calPrevUs(0)
+  , calStepUs(0)
 {
+  for (uint8_t i = 0; i < 4; i++) {
+    calOnset[i] = INIT_CAL_NONE;
+    calBreakaway[i] = INIT_CAL_NONE;
+    calDeadMs[i] = INIT_CAL_NONE;
+  }
 }
 
 void InitSequence::init() {
@@ -47,6 +68,8 @@ void InitSequence::init() {
   yawDelta = 0;
   initBatteryMv = 0;
   initUltrasonicCm = 0;
+  // Last calibration results are kept for N=130 D1=2
+  calRequested = (INIT_CAL_ENABLED && INIT_CAL_AT_BOOT);
 }
 
 void InitSequence::start() {
@@ -70,8 +93,18 @@ void InitSequence::requestRerun() {
   start();
 }
 
+void InitSequence::requestCalibration() {
+  requestRerun();
+  calRequested = true;
+}
+
 void InitSequence::abort() {
   stopMotors();
+  
+  // Interrupted calibration leaves the previous deadband/kick untouched
+  if (currentStep == STEP_CALIBRATE) {
+    calStatus = CAL_STATUS_FAIL;
+  }
   currentStep = STEP_IDLE;
   
   // Keep current state/warnings if we completed, otherwise mark as pending
@@ -159,10 +192,23 @@ bool InitSequence::update() {
     case STEP_SPIN_R:
       handleSpinR();
       if (elapsed >= INIT_STEP_SPIN_MS) {
-        enterStep(STEP_COMPLETE);
+        // Calibration needs the gyro; without it handleComplete reports fail
+        if (calRequested && g_imuInitialized) {
+          stopMotors();
+          enterStep(STEP_CALIBRATE);
+          calRun = 0;
+          calStatus = CAL_STATUS_NONE;
+          calEnterPhase(CAL_SETTLE_RAMP);
+        } else {
+          enterStep(STEP_COMPLETE);
+        }
       }
       break;
       
+    case STEP_CALIBRATE:
+      handleCalibrate();  // Moves on to STEP_COMPLETE after the last run
+      break;
+      
     case STEP_COMPLETE:
       handleComplete();
       currentStep = STEP_IDLE;
@@ -189,9 +235,9 @@ void InitSequence::handleStbySetup() {
   uint32_t elapsed = millis() - stepStartTime;
   
   if (!stbyToggled && elapsed < 10) {
-    digitalWrite(PIN_MOTOR_STBY, LOW);
+    FastPin<PIN_MOTOR_STBY>::low();
   } else if (!stbyToggled && elapsed >= 10) {
-    digitalWrite(PIN_MOTOR_STBY, HIGH);
+    FastPin<PIN_MOTOR_STBY>::high();
     stbyToggled = true;
   }
 }
@@ -301,10 +347,183 @@ void InitSequence::handleSpinR() {
   setMotors(pwm, -pwm);
 }
 
+void InitSequence::handleCalibrate() {
+  int16_t gyro = imu.readGyroZ();
+  uint32_t nowUs = micros();
+  uint32_t elapsed = millis() - stepStartTime;
+  int32_t dev32 = (int32_t)gyro - calBase;
+  if (dev32 < 0) dev32 = -dev32;
+  int16_t dev = (dev32 > 32767) ? 32767 : (int16_t)dev32;
+  
+  switch (calPhase) {
+    case CAL_SETTLE_RAMP:
+    case CAL_SETTLE_STEP:
+      // First half lets the chassis come to rest, second half is the baseline
+      if (elapsed >= INIT_CAL_SETTLE_MS / 2) {
+        calSampleBaseline(gyro);
+      }
+      if (calSamples >= INIT_CAL_SETTLE_MS / 2 / INIT_CAL_TICK_MS) {
+        if (calMax - calMin > INIT_CAL_GYRO_MIN_LSB && elapsed < 3 * INIT_CAL_SETTLE_MS) {
+          // Still coasting (e.g. after the spin test) - start the baseline over
+          calResetBaseline();
+          break;
+        }
+        calBase = (int16_t)(calSum / calSamples);
+        int16_t noise = calMax - calMin;
+        calThresh = (noise * 3 > INIT_CAL_GYRO_MIN_LSB) ? noise * 3 : INIT_CAL_GYRO_MIN_LSB;
+        
+        if (calPhase == CAL_SETTLE_RAMP) {
+          calPwm = INIT_CAL_PWM_START;
+          calEnterPhase(CAL_RAMP);
+        } else {
+          uint16_t pwm = calOnset[calRun] + INIT_CAL_STEP_MARGIN;
+          calPwm = (pwm > INIT_CAL_PWM_MAX) ? INIT_CAL_PWM_MAX : (uint8_t)pwm;
+          calEnterPhase(CAL_STEP);
+          calStepUs = micros();
+          calPrevUs = calStepUs;
+          calPrevDev = 0;
+        }
+        calWriteRun(calPwm);
+      }
+      break;
+      
+    case CAL_RAMP:
+      calAbove = (dev > calThresh) ? calAbove + 1 : 0;
+      if (calAbove >= 2) {
+        // The first sample over threshold saw the PWM written one tick earlier
+        calOnset[calRun] = calPwm - INIT_CAL_RAMP_STEP;
+        stopMotors();
+        calEnterPhase(CAL_SETTLE_STEP);
+      } else if (calPwm >= INIT_CAL_PWM_MAX) {
+        if (calAbove == 0) {
+          calFinishRun(INIT_CAL_NONE, INIT_CAL_NONE);
+        }
+      } else {
+        calPwm += INIT_CAL_RAMP_STEP;
+        calWriteRun(calPwm);
+      }
+      break;
+      
+    case CAL_STEP:
+      if (dev > calThresh) {
+        // Threshold crossing, interpolated between the last two samples
+        uint32_t dt = nowUs - calPrevUs;
+        uint32_t crossUs = calPrevUs + dt * (uint32_t)(calThresh - calPrevDev) /
+                                       (uint32_t)(dev - calPrevDev);
+        uint32_t deadMs = (crossUs - calStepUs + 500) / 1000;
+        if (deadMs >= INIT_CAL_NONE) {
+          deadMs = INIT_CAL_NONE - 1;
+        }
+        // During the ramp the PWM kept rising for deadMs before the gyro
+        // could see motion - the wheel actually broke away that much lower
+        int16_t breakaway = (int16_t)calOnset[calRun] -
+                            (int16_t)(deadMs * INIT_CAL_RAMP_STEP / INIT_CAL_TICK_MS);
+        if (breakaway < INIT_CAL_PWM_START) {
+          breakaway = INIT_CAL_PWM_START;
+        }
+        calFinishRun((uint8_t)breakaway, (uint8_t)deadMs);
+      } else if (elapsed >= INIT_CAL_STEP_TIMEOUT_MS) {
+        calFinishRun(calOnset[calRun], INIT_CAL_NONE);
+      } else {
+        calPrevUs = nowUs;
+        calPrevDev = dev;
+      }
+      break;
+  }
+}
+
+void InitSequence::calEnterPhase(CalPhase phase) {
+  calPhase = phase;
+  stepStartTime = millis();
+  calAbove = 0;
+  calResetBaseline();
+}
+
+void InitSequence::calResetBaseline() {
+  calSamples = 0;
+  calSum = 0;
+  calMin = 32767;
+  calMax = -32768;
+}
+
+void InitSequence::calSampleBaseline(int16_t gyro) {
+  if (calSamples == 255) {
+    return;
+  }
+  calSum += gyro;
+  calSamples++;
+  if (gyro < calMin) calMin = gyro;
+  if (gyro > calMax) calMax = gyro;
+}
+
+void InitSequence::calWriteRun(uint8_t pwm) {
+  // One wheel at a time: the car pivots about the other, gyro Z sees it
+  int16_t signedPwm = (calRun & 1) ? -(int16_t)pwm : (int16_t)pwm;
+  if (calRun < 2) {
+    writeMotorsRaw(signedPwm, 0);
+  } else {
+    writeMotorsRaw(0, signedPwm);
+  }
+}
+
+void InitSequence::calFinishRun(uint8_t breakaway, uint8_t deadMs) {
+  stopMotors();
+  calBreakaway[calRun] = breakaway;
+  calDeadMs[calRun] = deadMs;
+  calRun++;
+  if (calRun < 4) {
+    calEnterPhase(CAL_SETTLE_RAMP);
+  } else {
+    calApply();
+    enterStep(STEP_COMPLETE);
+  }
+}
+
+void InitSequence::calApply() {
+  // Deadband must move the wheel in both directions -> larger breakaway.
+  // A wheel with a failed run keeps its current deadband.
+  bool ok = true;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (calBreakaway[i] == INIT_CAL_NONE || calDeadMs[i] == INIT_CAL_NONE) {
+      ok = false;
+    }
+  }
+  if (calBreakaway[0] != INIT_CAL_NONE && calBreakaway[1] != INIT_CAL_NONE) {
+    driveSafety.setDeadbandL(max(calBreakaway[0], calBreakaway[1]));
+  }
+  if (calBreakaway[2] != INIT_CAL_NONE && calBreakaway[3] != INIT_CAL_NONE) {
+    driveSafety.setDeadbandR(max(calBreakaway[2], calBreakaway[3]));
+  }
+  
+  // Kick covers the slowest measured dead time plus one tick to build speed
+  uint8_t maxDead = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (calDeadMs[i] != INIT_CAL_NONE && calDeadMs[i] > maxDead) {
+      maxDead = calDeadMs[i];
+    }
+  }
+  if (maxDead > 0) {
+    uint8_t ticks = (maxDead + INIT_CAL_TICK_MS - 1) / INIT_CAL_TICK_MS + 1;
+    if (ticks < INIT_CAL_KICK_MIN_TICKS) ticks = INIT_CAL_KICK_MIN_TICKS;
+    if (ticks > INIT_CAL_KICK_MAX_TICKS) ticks = INIT_CAL_KICK_MAX_TICKS;
+    driveSafety.setKickTicks(ticks);
+  }
+  
+  calStatus = ok ? CAL_STATUS_DONE : CAL_STATUS_FAIL;
+}
+
 void InitSequence::handleComplete() {
   // Stop motors FIRST
   stopMotors();
   
+  // Calibration was asked for but could not run (no IMU, battery critical)
+  if (calRequested && calStatus == CAL_STATUS_NONE) {
+    calStatus = CAL_STATUS_FAIL;
+  }
+  if (calRequested && calStatus == CAL_STATUS_FAIL) {
+    warnBits |= WARN_CAL_FAIL;
+  }
+  
   // Set final state
   state = INIT_DONE;
   
@@ -313,42 +532,49 @@ void InitSequence::handleComplete() {
   
   // Print status
   printInitStatus();
+  if (calRequested) {
+    printCalReport();
+    calRequested = false;
+  }
 }
 
 void InitSequence::setMotors(int16_t left, int16_t right) {
   // Apply safety layer limits
   driveSafety.applyLimits(&left, &right);
-  
+  writeMotorsRaw(left, right);
+}
+
+void InitSequence::writeMotorsRaw(int16_t left, int16_t right) {
   // Enable motor driver
-  digitalWrite(PIN_MOTOR_STBY, HIGH);
+  FastPin<PIN_MOTOR_STBY>::high();
   
   // Apply to motors using TB6612 direction logic
   // Left motor (Motor B)
   if (left > 0) {
-    digitalWrite(PIN_MOTOR_BIN_1, HIGH);
-    analogWrite(PIN_MOTOR_PWMB, left);
+    FastPin<PIN_MOTOR_BIN_1>::high();
+    FastPwm<PIN_MOTOR_PWMB>::write(left);
   } else if (left < 0) {
-    digitalWrite(PIN_MOTOR_BIN_1, LOW);
-    analogWrite(PIN_MOTOR_PWMB, -left);
+    FastPin<PIN_MOTOR_BIN_1>::low();
+    FastPwm<PIN_MOTOR_PWMB>::write(-left);
   } else {
-    analogWrite(PIN_MOTOR_PWMB, 0);
+    FastPwm<PIN_MOTOR_PWMB>::write(0);
   }
   
   // Right motor (Motor A)
   if (right > 0) {
-    digitalWrite(PIN_MOTOR_AIN_1, HIGH);
-    analogWrite(PIN_MOTOR_PWMA, right);
+    FastPin<PIN_MOTOR_AIN_1>::high();
+    FastPwm<PIN_MOTOR_PWMA>::write(right);
   } else if (right < 0) {
-    digitalWrite(PIN_MOTOR_AIN_1, LOW);
-    analogWrite(PIN_MOTOR_PWMA, -right);
+    FastPin<PIN_MOTOR_AIN_1>::low();
+    FastPwm<PIN_MOTOR_PWMA>::write(-right);
   } else {
-    analogWrite(PIN_MOTOR_PWMA, 0);
+    FastPwm<PIN_MOTOR_PWMA>::write(0);
   }
 }
 
 void InitSequence::stopMotors() {
-  analogWrite(PIN_MOTOR_PWMA, 0);
-  analogWrite(PIN_MOTOR_PWMB, 0);
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
   driveSafety.resetSlew();
 }
 
@@ -387,7 +613,48 @@ void InitSequence::printInitStatus() {
   if (warnBits & WARN_IMU_NO_MOTION) Serial.print(F(" !imu_motion"));
   if (warnBits & WARN_ULTRA_MISSING) Serial.print(F(" !ultra"));
   if (warnBits & WARN_SERVO_SKIP) Serial.print(F(" !servo"));
+  if (warnBits & WARN_CAL_FAIL) Serial.print(F(" !cal"));
   
   Serial.println();
 }
 
+static void printCalRun(const __FlashStringHelper* label, uint8_t breakaway, uint8_t deadMs) {
+  Serial.print(label);
+  if (breakaway == INIT_CAL_NONE) {
+    Serial.print('-');
+  } else {
+    Serial.print(breakaway);
+  }
+  Serial.print('/');
+  if (deadMs == INIT_CAL_NONE) {
+    Serial.print('-');
+  } else {
+    Serial.print(deadMs);
+  }
+}
+
+void InitSequence::printCalReport() {
+  // Format: CAL:<none|done|fail> lf=<pwm>/<ms> lr=.. rf=.. rr=.. db=<L>/<R> kick=<ticks>
+  // '-' = not measured. Not gated on TX space like INIT: - a one-off line
+  // that is worth the few ms of blocking.
+  Serial.print(F("CAL:"));
+  if (calStatus == CAL_STATUS_DONE) {
+    Serial.print(F("done"));
+  } else if (calStatus == CAL_STATUS_FAIL) {
+    Serial.print(F("fail"));
+  } else {
+    Serial.println(F("none"));
+    return;
+  }
+  printCalRun(F(" lf="), calBreakaway[0], calDeadMs[0]);
+  printCalRun(F(" lr="), calBreakaway[1], calDeadMs[1]);
+  printCalRun(F(" rf="), calBreakaway[2], calDeadMs[2]);
+  printCalRun(F(" rr="), calBreakaway[3], calDeadMs[3]);
+  Serial.print(F(" db="));
+  Serial.print(driveSafety.getDeadbandL());
+  Serial.print('/');
+  Serial.print(driveSafety.getDeadbandR());
+  Serial.print(F(" kick="));
+  Serial.println(driveSafety.getKickTicks());
+}
+
@@ -0,0 +1,54 @@
+/*
+ * Link Baud Implementation
+ */
+
+#include "core/link_baud.h"
+
+LinkBaud linkBaud;
+
+LinkBaud::LinkBaud()
+  : baud(SERIAL_BAUD)
+  , switchMs(0)
+  , pending(false)
+  , garbage(0)
+  , fallbackCount(0)
+{
+}
+
+bool LinkBaud::supported(uint16_t kbaud) {
+  return kbaud == 115 || kbaud == 250 || kbaud == 500 || kbaud == 1000;
+}
+
+void LinkBaud::begin(uint32_t rate) {
+  Serial.flush();  // Let the last reply leave at the old rate
+  Serial.begin(rate);
+  while (Serial.available() > 0) {
+    Serial.read();  // Bytes that straddled the switch are garbage
+  }
+  baud = rate;
+  garbage = 0;
+}
+
+void LinkBaud::switchTo(uint16_t kbaud) {
+  uint32_t rate = (kbaud == 115) ? (uint32_t)SERIAL_BAUD : (uint32_t)kbaud * 1000UL;
+  begin(rate);
+  // Going back to the default needs no confirmation
+  pending = (rate != SERIAL_BAUD);
+  switchMs = millis();
+}
+
+bool LinkBaud::update() {
+  if (!pending || millis() - switchMs < LINK_BAUD_CONFIRM_MS) {
+    return false;
+  }
+  fallback();
+  return true;
+}
+
+void LinkBaud::fallback() {
+  begin(SERIAL_BAUD);
+  pending = false;
+  if (fallbackCount < 255) {
+    fallbackCount++;
+  }
+}
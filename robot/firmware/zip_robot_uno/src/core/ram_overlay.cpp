@@ -0,0 +1,24 @@
+/*
+ * RAM Overlay Arena Implementation
+ */
+
+#include "core/ram_overlay.h"
+
+RamOverlay ramOverlay;
+
+RamOverlayStorage* RamOverlay::acquire(OverlayOwner who) {
+  if (current != OVERLAY_FREE && current != who) {
+    if (conflicts < 255) {
+      conflicts++;
+    }
+    return nullptr;
+  }
+  current = who;
+  return &storage;
+}
+
+void RamOverlay::release(OverlayOwner who) {
+  if (current == who) {
+    current = OVERLAY_FREE;
+  }
+}
@@ -3,11 +3,14 @@
  */
 
 #include "core/scheduler.h"
+#include "core/stack_monitor.h"
 #include <avr/wdt.h>
 
 Scheduler::Scheduler()
   : taskCount(0)
   , lastWatchdogReset(0)
+  , stackSampleTask(0)
+  , lastStackSampleMs(0)
 {
   // Initialize task array
   for (uint8_t i = 0; i < MAX_TASKS; i++) {
@@ -16,6 +19,7 @@ Scheduler::Scheduler()
     tasks[i].lastRunTime = 0;
     tasks[i].enabled = false;
     tasks[i].name = nullptr;
+    tasks[i].stackPeak = 0;
   }
 }
 
@@ -34,6 +38,7 @@ bool Scheduler::registerTask(TaskFunction func, unsigned long intervalMs, const
   tasks[taskCount].lastRunTime = 0;
   tasks[taskCount].enabled = true;
   tasks[taskCount].name = name;
+  tasks[taskCount].stackPeak = 0;
   
   taskCount++;
   return true;
@@ -64,6 +69,10 @@ void Scheduler::run() {
   // Run all enabled tasks
   for (uint8_t i = 0; i < taskCount; i++) {
     if (!tasks[i].enabled || tasks[i].func == nullptr) {
+      if (i == stackSampleTask) {
+        // Don't let a disabled task stall the sampling rotation
+        stackSampleTask = (stackSampleTask + 1 < taskCount) ? stackSampleTask + 1 : 0;
+      }
       continue;
     }
     
@@ -74,8 +83,25 @@ void Scheduler::run() {
       wdt_reset();
       lastWatchdogReset = now;
       
-      // Run task
+      // Run task (sampling its stack depth if it is this interval's pick)
+#if STACK_MONITOR_ENABLED
+      bool sampleStack = (i == stackSampleTask) &&
+                         (now - lastStackSampleMs >= STACK_SAMPLE_INTERVAL_MS);
+      if (sampleStack) {
+        stackMonitor.beginSample();
+      }
       tasks[i].func();
+      if (sampleStack) {
+        uint16_t used = stackMonitor.endSample();
+        if (used > tasks[i].stackPeak) {
+          tasks[i].stackPeak = used;
+        }
+        lastStackSampleMs = now;
+        stackSampleTask = (stackSampleTask + 1 < taskCount) ? stackSampleTask + 1 : 0;
+      }
+#else
+      tasks[i].func();
+#endif
       tasks[i].lastRunTime = now;
       
       // Reset watchdog after running task
@@ -0,0 +1,106 @@
+/*
+ * Stack Monitor Implementation
+ */
+
+#include "core/stack_monitor.h"
+
+StackMonitor stackMonitor;
+
+#if STACK_MONITOR_ENABLED
+
+extern uint8_t _end;      // First byte after .bss (heap start)
+extern uint8_t __stack;   // RAMEND
+extern void* __brkval;    // malloc() heap top (0 = heap unused)
+
+#define STACK_STR2(x) #x
+#define STACK_STR(x) STACK_STR2(x)
+
+// Paint everything above .bss before main(). Runs from .init3, before the C
+// runtime: a naked function has no frame, so C locals could be spilled to a
+// stack that was never set up (-O0 does exactly that). Hence basic asm only:
+// X walks from _end up to and including __stack (Z), storing the canary.
+void stackMonitorPaint() __attribute__((naked, used, section(".init3")));
+void stackMonitorPaint() {
+  __asm__ __volatile__ (
+    "ldi r26, lo8(_end)\n\t"
+    "ldi r27, hi8(_end)\n\t"
+    "ldi r30, lo8(__stack)\n\t"
+    "ldi r31, hi8(__stack)\n\t"
+    "ldi r24, " STACK_STR(STACK_CANARY) "\n\t"
+    "1:\n\t"
+    "st X+, r24\n\t"
+    "cp r30, r26\n\t"
+    "cpc r31, r27\n\t"
+    "brsh 1b\n\t"
+  );
+}
+
+static inline uint8_t* heapTop() {
+  return __brkval ? (uint8_t*)__brkval : &_end;
+}
+
+StackMonitor::StackMonitor()
+  : lowWater(&__stack)
+  , sampleBase(&__stack)
+{
+}
+
+uint8_t* StackMonitor::scanDeepest() {
+  uint8_t* p = heapTop();
+  uint8_t* sp = (uint8_t*)SP;
+  while (p < sp && *p == STACK_CANARY) {
+    p++;
+  }
+  if (p < lowWater) {
+    lowWater = p;
+  }
+  return p;
+}
+
+uint16_t StackMonitor::unusedBytes() {
+  scanDeepest();
+  uint8_t* top = heapTop();
+  return (lowWater > top) ? (uint16_t)(lowWater - top) : 0;
+}
+
+void StackMonitor::beginSample() {
+  uint8_t* deepest = scanDeepest();
+  uint8_t* sp = (uint8_t*)SP;
+  sampleBase = sp;
+
+  // Repaint what earlier calls dirtied; lowWater keeps the all-time minimum
+  uint8_t* end = sp - STACK_PAINT_GUARD;
+  for (uint8_t* p = deepest; p < end; p++) {
+    *p = STACK_CANARY;
+  }
+}
+
+uint16_t StackMonitor::endSample() {
+  uint8_t* deepest = scanDeepest();
+  return (deepest < sampleBase) ? (uint16_t)(sampleBase - deepest) : 0;
+}
+
+#else
+
+StackMonitor::StackMonitor()
+  : lowWater(nullptr)
+  , sampleBase(nullptr)
+{
+}
+
+uint8_t* StackMonitor::scanDeepest() {
+  return nullptr;
+}
+
+uint16_t StackMonitor::unusedBytes() {
+  return 0;
+}
+
+void StackMonitor::beginSample() {
+}
+
+uint16_t StackMonitor::endSample() {
+  return 0;
+}
+
+#endif
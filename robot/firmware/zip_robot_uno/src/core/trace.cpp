@@ -0,0 +1,127 @@
+/*
+ * Hot-Path Trace Implementation
+ */
+
+#include "core/trace.h"
+
+#if TRACE_ENABLED
+
+TraceHistograms traceHist;
+
+static const char TRACE_NAME_RX[] PROGMEM = "rx";
+static const char TRACE_NAME_PARSE[] PROGMEM = "parse";
+static const char TRACE_NAME_LIMITS[] PROGMEM = "limits";
+static const char TRACE_NAME_LOOKUP[] PROGMEM = "lookup";
+static const char TRACE_NAME_SYS[] PROGMEM = "n_sys";
+static const char TRACE_NAME_LEGACY[] PROGMEM = "n_leg";
+static const char TRACE_NAME_MOTION[] PROGMEM = "n_mot";
+static const char TRACE_NAME_CTRL[] PROGMEM = "ctrl";
+static const char TRACE_NAME_SENS_S[] PROGMEM = "sens_s";
+
+static const char* const TRACE_NAMES[TRACE_POINT_COUNT] PROGMEM = {
+  TRACE_NAME_RX,
+  TRACE_NAME_PARSE,
+  TRACE_NAME_LIMITS,
+  TRACE_NAME_LOOKUP,
+  TRACE_NAME_SYS,
+  TRACE_NAME_LEGACY,
+  TRACE_NAME_MOTION,
+  TRACE_NAME_CTRL,
+  TRACE_NAME_SENS_S,
+};
+
+TraceHistograms::TraceHistograms() {
+  reset();
+}
+
+void TraceHistograms::init() {
+#if defined(__AVR__)
+  // Normal mode, clk/8: identical to Servo::attach()'s Timer1 setup
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11);
+#endif
+  reset();
+}
+
+void TraceHistograms::reset() {
+  for (uint8_t i = 0; i < TRACE_POINT_COUNT; i++) {
+    points[i].count = 0;
+    points[i].maxTicks = 0;
+    for (uint8_t b = 0; b < TRACE_BUCKETS; b++) {
+      points[i].bins[b] = 0;
+    }
+  }
+}
+
+void TraceHistograms::record(uint8_t point, uint16_t ticks) {
+  if (point >= TRACE_POINT_COUNT) {
+    return;
+  }
+  PointStats& p = points[point];
+
+  // floor(log2(ticks)), 0 and 1 both land in bucket 0
+  uint8_t bucket = 0;
+  uint16_t t = ticks;
+  while (t >>= 1) {
+    bucket++;
+  }
+
+  if (p.bins[bucket] != 0xFF) {
+    p.bins[bucket]++;
+  }
+  if (p.count != 0xFFFF) {
+    p.count++;
+  }
+  if (ticks > p.maxTicks) {
+    p.maxTicks = ticks;
+  }
+}
+
+void TraceHistograms::dump(const char* tag, bool resetAfter) {
+  // ~15-25 bytes per active point; Serial.print blocks on a full TX buffer
+  Serial.print('{');
+  Serial.print(tag);
+  Serial.print('_');
+  bool first = true;
+  for (uint8_t i = 0; i < TRACE_POINT_COUNT; i++) {
+    const PointStats& p = points[i];
+    if (p.count == 0) {
+      continue;
+    }
+
+    uint8_t lo = 0;
+    uint8_t hi = TRACE_BUCKETS - 1;
+    while (lo < hi && p.bins[lo] == 0) {
+      lo++;
+    }
+    while (hi > lo && p.bins[hi] == 0) {
+      hi--;
+    }
+
+    if (!first) {
+      Serial.print(';');
+    }
+    first = false;
+    Serial.print((const __FlashStringHelper*)pgm_read_ptr(&TRACE_NAMES[i]));
+    Serial.print(':');
+    Serial.print(p.count);
+    Serial.print(',');
+    Serial.print((p.maxTicks + 1) / 2);  // us, rounded up
+    Serial.print(',');
+    Serial.print(lo);
+    Serial.print(':');
+    for (uint8_t b = lo; b <= hi; b++) {
+      if (b != lo) {
+        Serial.print('.');
+      }
+      Serial.print(p.bins[b]);
+    }
+  }
+  Serial.print(F("}\n"));
+
+  if (resetAfter) {
+    reset();
+  }
+}
+
+#endif // TRACE_ENABLED
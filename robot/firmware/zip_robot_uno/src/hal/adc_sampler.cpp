@@ -0,0 +1,159 @@
+/*
+ * ADC Sampler Implementation
+ *
+ * Conversion chaining: each ADC_vect restarts the next conversion, so the
+ * ADC runs back-to-back without CPU polling. Mux changes are done between
+ * conversions and the first result after a switch is thrown away to let
+ * the sample-and-hold settle (matters for the high-impedance battery divider).
+ */
+
+#include "hal/adc_sampler.h"
+#include <util/atomic.h>
+
+AdcSampler adcSampler;
+
+#if ADC_SAMPLER_ENABLED
+ISR(ADC_vect) {
+  adcSampler.onConversion(ADC);
+}
+#endif
+
+AdcSampler::AdcSampler()
+  : front(0)
+  , sampleTime(0)
+  , sweepCount(0)
+  , running(false)
+  , accum(0)
+  , channel(0)
+  , conversion(0)
+{
+  for (uint8_t b = 0; b < 2; b++) {
+    for (uint8_t ch = 0; ch < ADC_SAMPLER_CHANNELS; ch++) {
+      samples[b][ch] = 0;
+    }
+  }
+}
+
+void AdcSampler::start() {
+#if ADC_SAMPLER_ENABLED
+  if (running) {
+    return;
+  }
+
+  accum = 0;
+  channel = 0;
+  conversion = 0;
+  selectChannel(0);
+
+  // Enable ADC + conversion-complete interrupt, prescaler /128 (125kHz @ 16MHz)
+  ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+  running = true;
+  ADCSRA |= _BV(ADSC);
+
+  // Wait for the first full sweep so callers never see zeros (~2ms, bounded)
+  unsigned long startMs = millis();
+  while (getSweepCount() == 0 && (millis() - startMs) < 10) {
+    // spin
+  }
+#endif
+}
+
+void AdcSampler::stop() {
+#if ADC_SAMPLER_ENABLED
+  // Leave ADEN set so analogRead() keeps working afterwards
+  ADCSRA &= ~_BV(ADIE);
+  while (ADCSRA & _BV(ADSC)) {
+    // let an in-flight conversion finish
+  }
+  running = false;
+#endif
+}
+
+void AdcSampler::selectChannel(uint8_t ch) {
+#if ADC_SAMPLER_ENABLED
+  // AVcc reference (Arduino DEFAULT), right-adjusted result
+  ADMUX = _BV(REFS0) | (ch & 0x07);
+#else
+  (void)ch;
+#endif
+}
+
+void AdcSampler::onConversion(uint16_t value) {
+  if (conversion > 0) {
+    accum += value;
+  }
+
+  if (conversion < ADC_SAMPLER_OVERSAMPLE) {
+    conversion++;
+  } else {
+    // Channel complete - store into back buffer
+    uint8_t back = front ^ 1;
+    samples[back][channel] = accum / ADC_SAMPLER_OVERSAMPLE;
+    accum = 0;
+    conversion = 0;
+
+    channel++;
+    if (channel >= ADC_SAMPLER_CHANNELS) {
+      channel = 0;
+      front = back;
+      sampleTime = millis();
+      sweepCount++;
+    }
+    selectChannel(channel);
+  }
+
+#if ADC_SAMPLER_ENABLED
+  if (running) {
+    ADCSRA |= _BV(ADSC);
+  }
+#endif
+}
+
+uint16_t AdcSampler::get(uint8_t pin) const {
+  uint8_t ch = (pin >= A0) ? (pin - A0) : pin;
+  if (!running || ch >= ADC_SAMPLER_CHANNELS) {
+    return analogRead(pin);
+  }
+
+  uint16_t value;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    value = samples[front][ch];
+  }
+  return value;
+}
+
+void AdcSampler::snapshot(uint16_t* out) const {
+  if (!out) {
+    return;
+  }
+
+  if (!running) {
+    for (uint8_t ch = 0; ch < ADC_SAMPLER_CHANNELS; ch++) {
+      out[ch] = analogRead(A0 + ch);
+    }
+    return;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    uint8_t f = front;
+    for (uint8_t ch = 0; ch < ADC_SAMPLER_CHANNELS; ch++) {
+      out[ch] = samples[f][ch];
+    }
+  }
+}
+
+unsigned long AdcSampler::getSampleTime() const {
+  unsigned long t;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    t = sampleTime;
+  }
+  return t;
+}
+
+uint16_t AdcSampler::getSweepCount() const {
+  uint16_t n;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    n = sweepCount;
+  }
+  return n;
+}
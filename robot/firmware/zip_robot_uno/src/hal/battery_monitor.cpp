@@ -3,6 +3,7 @@
  */
 
 #include "hal/battery_monitor.h"
+#include "hal/adc_sampler.h"
 
 const float BatteryMonitor::LOW_THRESHOLD = BATTERY_VOLTAGE_LOW;
 const float BatteryMonitor::LOW_THRESHOLD_HYST = BATTERY_VOLTAGE_LOW + LOW_BATTERY_HYSTERESIS_V;
@@ -25,8 +26,8 @@ float BatteryMonitor::readVoltage() {
 }
 
 void BatteryMonitor::update() {
-  // Read ADC
-  uint16_t adc = analogRead(PIN_VOLTAGE);
+  // Read ADC (cached by AdcSampler)
+  uint16_t adc = adcSampler.get(PIN_VOLTAGE);
   
   // Convert to voltage (in millivolts)
   float voltage = adcToVoltage(adc);
@@ -0,0 +1,88 @@
+/*
+ * Fast Pin Benchmark
+ *
+ * Times digitalWrite/analogWrite against FastPin/FastPwm on the real motor
+ * pins. Runs once from setup() when built with env:uno_pin_bench, while
+ * STBY is still LOW so the motors never see the toggling.
+ *
+ * Output (ns per call, loop overhead subtracted):
+ *   BENCH dw=<ns> fp=<ns> aw=<ns> fpwm=<ns>
+ */
+
+#include "hal/fast_pin.h"
+#include "board/board_elegoo_uno_smartcar_shield_v11.h"
+#include <avr/wdt.h>
+
+#if FAST_PIN_BENCHMARK
+
+static const uint16_t BENCH_ITERATIONS = 2000;
+
+// Convert total micros for BENCH_ITERATIONS*2 calls to ns per call
+static long benchNsPerCall(unsigned long us, unsigned long overheadUs) {
+  long net = (long)us - (long)overheadUs;
+  if (net < 0) {
+    net = 0;
+  }
+  return (net * 1000L) / (BENCH_ITERATIONS * 2L);
+}
+
+void runFastPinBenchmark() {
+  wdt_reset();
+
+  // Empty loop for overhead baseline
+  unsigned long t0 = micros();
+  for (volatile uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+  }
+  unsigned long overhead = micros() - t0;
+
+  t0 = micros();
+  for (volatile uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    digitalWrite(PIN_MOTOR_AIN_1, HIGH);
+    digitalWrite(PIN_MOTOR_AIN_1, LOW);
+  }
+  unsigned long dwUs = micros() - t0;
+
+  t0 = micros();
+  for (volatile uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    FastPin<PIN_MOTOR_AIN_1>::high();
+    FastPin<PIN_MOTOR_AIN_1>::low();
+  }
+  unsigned long fpUs = micros() - t0;
+  wdt_reset();
+
+  t0 = micros();
+  for (volatile uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    analogWrite(PIN_MOTOR_PWMA, 100);
+    analogWrite(PIN_MOTOR_PWMA, 0);
+  }
+  unsigned long awUs = micros() - t0;
+
+  t0 = micros();
+  for (volatile uint16_t i = 0; i < BENCH_ITERATIONS; i++) {
+    FastPwm<PIN_MOTOR_PWMA>::write(100);
+    FastPwm<PIN_MOTOR_PWMA>::write(0);
+  }
+  unsigned long fpwmUs = micros() - t0;
+  wdt_reset();
+
+  // Leave pins in the motor driver's safe state
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPin<PIN_MOTOR_AIN_1>::high();
+
+  Serial.print(F("BENCH dw="));
+  Serial.print(benchNsPerCall(dwUs, overhead));
+  Serial.print(F(" fp="));
+  Serial.print(benchNsPerCall(fpUs, overhead));
+  Serial.print(F(" aw="));
+  Serial.print(benchNsPerCall(awUs, overhead));
+  Serial.print(F(" fpwm="));
+  Serial.println(benchNsPerCall(fpwmUs, overhead));
+  Serial.flush();
+}
+
+#else
+
+void runFastPinBenchmark() {
+}
+
+#endif
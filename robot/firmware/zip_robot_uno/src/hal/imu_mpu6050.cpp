@@ -111,6 +111,15 @@ void IMU_MPU6050::readRaw(int16_t* ax, int16_t* ay, int16_t* az,
   *gz = (int16_t)((data[12] << 8) | data[13]) - gyroOffsetZ;
 }
 
+int16_t IMU_MPU6050::readGyroZ() {
+  if (!initialized) {
+    return 0;
+  }
+  uint8_t data[2];
+  readRegisters(MPU6050_REG_GYRO_XOUT_H + 4, data, 2);
+  return (int16_t)((data[0] << 8) | data[1]) - gyroOffsetZ;
+}
+
 void IMU_MPU6050::calibrate() {
   // Calibrate gyro offset (assume robot is stationary)
   // Reduced samples from 100 to 50 to save RAM
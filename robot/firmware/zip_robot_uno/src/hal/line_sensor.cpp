@@ -1,8 +1,11 @@
 /*
  * Line Sensor Implementation - ITR20001
+ *
+ * Reads come from the background ADC sampler (cached, O(1)).
  */
 
 #include "hal/line_sensor.h"
+#include "hal/adc_sampler.h"
 
 LineSensorITR20001::LineSensorITR20001()
   : threshold(LINE_SENSOR_THRESHOLD_DEFAULT)
@@ -23,21 +26,24 @@ void LineSensorITR20001::init() {
 }
 
 uint16_t LineSensorITR20001::readLeft() const {
-  return analogRead(PIN_LINE_L);
+  return adcSampler.get(PIN_LINE_L);
 }
 
 uint16_t LineSensorITR20001::readMiddle() const {
-  return analogRead(PIN_LINE_M);
+  return adcSampler.get(PIN_LINE_M);
 }
 
 uint16_t LineSensorITR20001::readRight() const {
-  return analogRead(PIN_LINE_R);
+  return adcSampler.get(PIN_LINE_R);
 }
 
 void LineSensorITR20001::readAll(uint16_t* left, uint16_t* middle, uint16_t* right) const {
-  if (left) *left = readLeft();
-  if (middle) *middle = readMiddle();
-  if (right) *right = readRight();
+  // Single snapshot so all three values come from the same sweep
+  uint16_t raw[ADC_SAMPLER_CHANNELS];
+  adcSampler.snapshot(raw);
+  if (left) *left = raw[PIN_LINE_L - A0];
+  if (middle) *middle = raw[PIN_LINE_M - A0];
+  if (right) *right = raw[PIN_LINE_R - A0];
 }
 
 void LineSensorITR20001::calibrate() {
@@ -52,9 +58,9 @@ void LineSensorITR20001::readBaseline() {
   const uint8_t samples = 10;
   
   for (uint8_t i = 0; i < samples; i++) {
-    sumL += analogRead(PIN_LINE_L);
-    sumM += analogRead(PIN_LINE_M);
-    sumR += analogRead(PIN_LINE_R);
+    sumL += readLeft();
+    sumM += readMiddle();
+    sumR += readRight();
     delay(10);
   }
   
@@ -63,6 +69,10 @@ void LineSensorITR20001::readBaseline() {
   baselineRight = sumR / samples;
 }
 
+unsigned long LineSensorITR20001::getSampleTime() const {
+  return adcSampler.getSampleTime();
+}
+
 void LineSensorITR20001::setThreshold(uint16_t thresh) {
   threshold = thresh;
 }
@@ -12,6 +12,7 @@
  */
 
 #include "hal/motor_tb6612.h"
+#include "hal/fast_pin.h"
 
 MotorDriverTB6612::MotorDriverTB6612()
   : targetLeftPWM(0)
@@ -39,13 +40,13 @@ void MotorDriverTB6612::init() {
   
   // Configure STANDBY pin (TB6612FNG specific)
   pinMode(PIN_MOTOR_STBY, OUTPUT);
-  digitalWrite(PIN_MOTOR_STBY, LOW);  // Start disabled for safety
+  FastPin<PIN_MOTOR_STBY>::low();  // Start disabled for safety
   
   // Set safe initial state: PWM = 0, direction = forward
-  analogWrite(PIN_MOTOR_PWMA, 0);
-  analogWrite(PIN_MOTOR_PWMB, 0);
-  digitalWrite(PIN_MOTOR_AIN_1, HIGH);  // Right motor forward direction (TB6612: HIGH=forward)
-  digitalWrite(PIN_MOTOR_BIN_1, HIGH);  // Left motor forward direction (TB6612: HIGH=forward)
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
+  FastPin<PIN_MOTOR_AIN_1>::high();  // Right motor forward direction (TB6612: HIGH=forward)
+  FastPin<PIN_MOTOR_BIN_1>::high();  // Left motor forward direction (TB6612: HIGH=forward)
   
   enabled = false;
   currentLeftPWM = 0;
@@ -56,16 +57,16 @@ void MotorDriverTB6612::init() {
 
 void MotorDriverTB6612::enable() {
   // TB6612FNG: Set STBY HIGH to enable motor output
-  digitalWrite(PIN_MOTOR_STBY, HIGH);
+  FastPin<PIN_MOTOR_STBY>::high();
   enabled = true;
 }
 
 void MotorDriverTB6612::disable() {
   // TB6612FNG: Set STBY LOW to disable motor output
-  digitalWrite(PIN_MOTOR_STBY, LOW);
+  FastPin<PIN_MOTOR_STBY>::low();
   enabled = false;
-  analogWrite(PIN_MOTOR_PWMA, 0);
-  analogWrite(PIN_MOTOR_PWMB, 0);
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
   currentLeftPWM = 0;
   currentRightPWM = 0;
   targetLeftPWM = 0;
@@ -137,8 +138,8 @@ void MotorDriverTB6612::stop() {
   currentRightPWM = 0;
   
   // Apply to hardware
-  analogWrite(PIN_MOTOR_PWMA, 0);
-  analogWrite(PIN_MOTOR_PWMB, 0);
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
   
   enabled = false;
 }
@@ -188,7 +189,7 @@ void MotorDriverTB6612::applyMotorA(int16_t pwm) {
   //   Stop:                     PWM = 0
   
   if (pwm == 0) {
-    analogWrite(PIN_MOTOR_PWMA, 0);
+    FastPwm<PIN_MOTOR_PWMA>::write(0);
     return;
   }
   
@@ -197,13 +198,13 @@ void MotorDriverTB6612::applyMotorA(int16_t pwm) {
   
   // Set direction FIRST (matching official ELEGOO code order)
   if (effectivePWM > 0) {
-    digitalWrite(PIN_MOTOR_AIN_1, HIGH);  // Forward (TB6612: HIGH)
+    FastPin<PIN_MOTOR_AIN_1>::high();  // Forward (TB6612: HIGH)
   } else {
-    digitalWrite(PIN_MOTOR_AIN_1, LOW);   // Reverse (TB6612: LOW)
+    FastPin<PIN_MOTOR_AIN_1>::low();   // Reverse (TB6612: LOW)
   }
   
   // Then set PWM magnitude
-  analogWrite(PIN_MOTOR_PWMA, abs(effectivePWM));
+  FastPwm<PIN_MOTOR_PWMA>::write(abs(effectivePWM));
 }
 
 void MotorDriverTB6612::applyMotorB(int16_t pwm) {
@@ -214,7 +215,7 @@ void MotorDriverTB6612::applyMotorB(int16_t pwm) {
   //   Stop:                     PWM = 0
   
   if (pwm == 0) {
-    analogWrite(PIN_MOTOR_PWMB, 0);
+    FastPwm<PIN_MOTOR_PWMB>::write(0);
     return;
   }
   
@@ -223,13 +224,13 @@ void MotorDriverTB6612::applyMotorB(int16_t pwm) {
   
   // Set direction FIRST (matching official ELEGOO code order)
   if (effectivePWM > 0) {
-    digitalWrite(PIN_MOTOR_BIN_1, HIGH);  // Forward (TB6612: HIGH)
+    FastPin<PIN_MOTOR_BIN_1>::high();  // Forward (TB6612: HIGH)
   } else {
-    digitalWrite(PIN_MOTOR_BIN_1, LOW);   // Reverse (TB6612: LOW)
+    FastPin<PIN_MOTOR_BIN_1>::low();   // Reverse (TB6612: LOW)
   }
   
   // Then set PWM magnitude
-  analogWrite(PIN_MOTOR_PWMB, abs(effectivePWM));
+  FastPwm<PIN_MOTOR_PWMB>::write(abs(effectivePWM));
 }
 
 int16_t MotorDriverTB6612::applyDeadband(int16_t pwm) {
@@ -286,17 +287,17 @@ bool MotorDriverTB6612::test() {
   delay(10);
   
   // Test direction pins can be written
-  digitalWrite(PIN_MOTOR_AIN_1, LOW);
-  digitalWrite(PIN_MOTOR_BIN_1, HIGH);
+  FastPin<PIN_MOTOR_AIN_1>::low();
+  FastPin<PIN_MOTOR_BIN_1>::high();
   
   // Test PWM pins with brief pulse
-  analogWrite(PIN_MOTOR_PWMA, 50);
+  FastPwm<PIN_MOTOR_PWMA>::write(50);
   delay(10);
-  analogWrite(PIN_MOTOR_PWMA, 0);
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
   
-  analogWrite(PIN_MOTOR_PWMB, 50);
+  FastPwm<PIN_MOTOR_PWMB>::write(50);
   delay(10);
-  analogWrite(PIN_MOTOR_PWMB, 0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
   
   // Disable motors
   disable();
@@ -16,6 +16,7 @@ ServoPan::ServoPan()
   : currentAngle(90)
   , minAngle(SERVO_ANGLE_MIN)
   , maxAngle(SERVO_ANGLE_MAX)
+  , held(false)
 {
 }
 
@@ -40,3 +41,30 @@ void ServoPan::setAngle(uint8_t angle) {
   delay(450);                  // Official ELEGOO delay for movement
   servo.detach();              // Release Timer1
 }
+
+void ServoPan::attachHold() {
+  if (!held) {
+    servo.attach(PIN_SERVO_Z);
+    held = true;
+  }
+}
+
+uint16_t ServoPan::moveNoWait(uint8_t angle) {
+  angle = constrain(angle, SERVO_ANGLE_MIN, SERVO_ANGLE_MAX);
+  uint8_t travel = (angle > currentAngle) ? (angle - currentAngle) : (currentAngle - angle);
+  currentAngle = angle;
+  
+  if (!held) {
+    attachHold();
+  }
+  servo.write(angle);
+  
+  return (uint16_t)travel * SERVO_MS_PER_DEG;
+}
+
+void ServoPan::release() {
+  if (held) {
+    servo.detach();  // Release Timer1
+    held = false;
+  }
+}
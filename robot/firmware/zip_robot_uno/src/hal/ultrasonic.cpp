@@ -3,6 +3,7 @@
  */
 
 #include "hal/ultrasonic.h"
+#include "hal/fast_pin.h"
 
 UltrasonicHC_SR04::UltrasonicHC_SR04()
   : lastReadTime(0)
@@ -15,7 +16,7 @@ void UltrasonicHC_SR04::init() {
   pinMode(PIN_ULTRASONIC_TRIG, OUTPUT);
   pinMode(PIN_ULTRASONIC_ECHO, INPUT);
   
-  digitalWrite(PIN_ULTRASONIC_TRIG, LOW);
+  FastPin<PIN_ULTRASONIC_TRIG>::low();
   lastReadTime = 0;
 }
 
@@ -40,21 +41,27 @@ uint16_t UltrasonicHC_SR04::getDistance() {
   return lastDistance;
 }
 
+uint16_t UltrasonicHC_SR04::measure(unsigned long timeout_us) {
+  lastDistance = readBlocking(timeout_us);
+  lastReadTime = millis();
+  return lastDistance;
+}
+
 bool UltrasonicHC_SR04::isReadingAvailable() const {
   unsigned long now = millis();
   return (now - lastReadTime) >= minIntervalMs;
 }
 
-uint16_t UltrasonicHC_SR04::readBlocking() {
+uint16_t UltrasonicHC_SR04::readBlocking(unsigned long timeout_us) {
   // Trigger pulse
-  digitalWrite(PIN_ULTRASONIC_TRIG, LOW);
+  FastPin<PIN_ULTRASONIC_TRIG>::low();
   delayMicroseconds(2);
-  digitalWrite(PIN_ULTRASONIC_TRIG, HIGH);
+  FastPin<PIN_ULTRASONIC_TRIG>::high();
   delayMicroseconds(10);
-  digitalWrite(PIN_ULTRASONIC_TRIG, LOW);
+  FastPin<PIN_ULTRASONIC_TRIG>::low();
   
   // Read echo pulse
-  unsigned long duration = pulseIn(PIN_ULTRASONIC_ECHO, HIGH, ULTRASONIC_TIMEOUT_US);
+  unsigned long duration = pulseIn(PIN_ULTRASONIC_ECHO, HIGH, timeout_us);
   
   if (duration == 0) {
     return 0;  // Timeout
@@ -14,6 +14,7 @@
  * 
  * ENABLED SUBSYSTEMS:
  *   ✅ motorDriver      - TB6612FNG motor control (STBY on D3)
+ *   ✅ adcSampler       - ISR-driven ADC sweep (A0-A3, ~500Hz, cached)
  *   ✅ batteryMonitor   - ADC battery voltage (10Hz read)
  *   ✅ servoPan         - Pan servo (Servo library)
  *   ✅ ultrasonic       - HC-SR04 distance (10Hz read)
@@ -41,7 +42,10 @@
  *   N=22    Line sensor read
  *   N=23    Battery voltage
  *   N=120   Diagnostics (includes IMU status, HW profile)
- *   N=200   Setpoint streaming (fire-and-forget)
+ *   N=123   Time probe (host/UNO clock sync)
+ *   N=124   Link baud switch (negotiated, falls back to SERIAL_BAUD)
+ *   N=150   Servo-swept ultrasonic range scan
+ *   N=200   Setpoint streaming (fire-and-forget, optional seq/stamp)
  *   N=201   Stop (immediate)
  *   N=210   Macro start
  *   N=211   Macro cancel
@@ -61,6 +65,8 @@
 #include "hal/servo_pan.h"
 #include "hal/ultrasonic.h"
 #include "hal/line_sensor.h"
+#include "hal/adc_sampler.h"
+#include "hal/fast_pin.h"
 #include "hal/imu_mpu6050.h"
 #include "hal/battery_monitor.h"
 #include "hal/status_led.h"
@@ -68,6 +74,12 @@
 
 // Core
 #include "core/scheduler.h"
+#include "core/coroutine.h"
+#include "core/stack_monitor.h"
+#include "core/trace.h"
+#include "core/link_baud.h"
+#include "core/command_table.h"
+#include "core/black_box.h"
 
 // Motion Control
 #include "motion_types.h"
@@ -75,12 +87,17 @@
 #include "motion/macro_engine.h"
 #include "motion/safety.h"
 #include "motion/drive_safety_layer.h"
+#include "motion/collision_reflex.h"
 #include "serial/frame_parser.h"
 #include "serial/json_protocol.h"
+#include "serial/response_writer.h"
 
 // Core
 #include "core/init_sequence.h"
 
+// Behaviors
+#include "behavior/range_scanner.h"
+
 // Self-test
 #include "self_test.h"
 
@@ -103,8 +120,8 @@ SafetyLayer safetyLayer;
 FrameParser jsonFrameParser;
 
 // Forward declarations
-void handleMotionCommand(const ParsedCommand& cmd);
 void handleLegacyCommand(const ParsedCommand& cmd);
+static void diagReplyStep();
 void hardwareValidation();
 
 // Store direct motor values for continuous re-application in DIRECT mode
@@ -129,9 +146,17 @@ extern void *__brkval;
 
 static int16_t g_minFreeRam = 32767;  // Track minimum observed free RAM
 
+// micros() when the current command's frame completed (N=123 time probe)
+static uint32_t g_cmdRxUs = 0;
+
 int freeRam() {
+#if defined(ZIP_NATIVE)
+  // No AVR heap/stack layout on the host; report a fixed nominal value
+  return 1024;
+#else
   int v;
   return (int)&v - (__brkval == 0 ? (int)&__heap_start : (int)__brkval);
+#endif
 }
 
 // Call this at critical points to track minimum headroom
@@ -185,14 +210,45 @@ void hardwareValidation() {
   wdt_reset();
 }
 
+#if BLACK_BOX_ENABLED
+// Feeds the black box each control tick: what the previous tick left applied
+static void recordBlackBox() {
+  int16_t v, w;
+  motionController.getCurrentSetpoint(v, w);
+  MotionState state = motionController.getState();
+  bool direct = (state == MOTION_STATE_DIRECT);
+  uint8_t bits = (uint8_t)state | (uint8_t)(driveSafety.getBatteryState() << BB_STATE_BATT_SHIFT);
+  if (initSequence.isRunning()) {
+    bits |= BB_STATE_INIT;
+  }
+  blackBox.record(v, w,
+                  direct ? directLeftPWM : motorDriver.getLeftPWM(),
+                  direct ? directRightPWM : motorDriver.getRightPWM(),
+                  imu.getYawX10(), bits);
+}
+#endif
+
 // Task: Control loop (50Hz)
 void task_control_loop() {
+  TRACE_SCOPE(TRACE_TASK_CTRL);
+  
+#if BLACK_BOX_ENABLED
+  recordBlackBox();
+#endif
+  
   // Run init sequence state machine if active
   if (initSequence.isRunning()) {
     initSequence.update();
     return;  // Don't run normal motion control during init
   }
   
+#if SELF_TEST_ENABLED
+  // Motor self-test coroutine owns the motors until it finishes
+  if (selfTestUpdate()) {
+    return;
+  }
+#endif
+  
   // Only update motion controller for N=200 commands (but skip if DIRECT mode)
   if (motionController.getState() != MOTION_STATE_DIRECT) {
     motionController.update();
@@ -209,14 +265,20 @@ void task_sensors_fast() {
 
 // Task: Slow sensors (10Hz)
 void task_sensors_slow() {
+  TRACE_SCOPE(TRACE_TASK_SENS_S);
+  
   // Read sensors (results cached in drivers)
-  ultrasonic.getDistance();
+  // During a range scan the scanner owns the sonar (and feeds the reflex itself)
+  if (!rangeScanner.isActive()) {
+    uint16_t distance = ultrasonic.getDistance();
+    collisionReflex.updateDistance(distance, ultrasonic.getLastReadTime());
+  }
   batteryMonitor.update();
-  lineSensor.readAll(nullptr, nullptr, nullptr);  // Cache line sensor values
   
   // Update drive safety layer with current battery voltage
   uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
   driveSafety.updateBatteryState(voltage_mv);
+  blackBox.setBatteryMv(voltage_mv);
   
   // Update IMU at 10Hz (non-blocking I2C read)
   if (g_imuInitialized) {
@@ -224,6 +286,67 @@ void task_sensors_slow() {
   }
 }
 
+#if SAFETY_STATS_ENABLED
+// Safety layer telemetry, once a second while setpoints stream:
+//   {sl:<calls>,<ff>,<cap>,<slew>,<kick>,<db>,<lagLast>,<lagPeak>}
+// Counters as in N=120 sl:/lag: (free-running, in applyLimits() calls)
+static void sendLimitStats() {
+  if (Serial.availableForWrite() < 56) {
+    return;
+  }
+  const DriveLimitStats& ls = driveSafety.getLimitStats();
+  ResponseWriter w;
+  w.str(F("{sl:")).num(ls.calls);
+  w.ch(',').num(ls.feedforward);
+  w.ch(',').num(ls.cap);
+  w.ch(',').num(ls.slew);
+  w.ch(',').num(ls.kick);
+  w.ch(',').num(ls.deadband);
+  w.ch(',').num((uint16_t)ls.lagLastCalls);
+  w.ch(',').num((uint16_t)ls.lagPeakCalls);
+  w.end();
+}
+#endif
+
+// Task: Setpoint ack (5Hz)
+// Cumulative ack while sequenced setpoints flow, so the host can see what was
+// applied and what was lost without a reply per frame:
+//   {sq:<lastSeq>,<applied>,<stale>,<reordered>,<rxOverflow>,<jsonLong>}
+// Skipped rather than blocking when the TX ring is busy - the next one
+// carries the same totals.
+void task_setpoint_ack() {
+  const SetpointSeqStats& sq = motionController.getSeqStats();
+  if (sq.lastRxMs == 0 || millis() - sq.lastRxMs > MOTION_SEQ_ACK_HOLD_MS) {
+    return;
+  }
+#if SAFETY_STATS_ENABLED
+  // Every SETPOINT_SL_EVERY-th slot carries the safety layer telemetry
+  // instead; the ack is cumulative, so skipping one loses nothing
+  static uint8_t slot = 0;
+  if (++slot >= SETPOINT_SL_EVERY) {
+    slot = 0;
+    sendLimitStats();
+    return;
+  }
+#endif
+  if (Serial.availableForWrite() < 40) {
+    return;
+  }
+  Serial.print(F("{sq:"));
+  Serial.print(sq.lastSeq);
+  Serial.print(',');
+  Serial.print(sq.applied);
+  Serial.print(',');
+  Serial.print(sq.stale);
+  Serial.print(',');
+  Serial.print(sq.reordered);
+  Serial.print(',');
+  Serial.print(g_parseStats.rx_overflow);
+  Serial.print(',');
+  Serial.print(g_parseStats.json_dropped_long);
+  Serial.print(F("}\n"));
+}
+
 // Task: Protocol RX (continuous, 1ms interval)
 // Single RX pipeline with deterministic parsing
 void task_protocol_rx() {
@@ -231,6 +354,14 @@ void task_protocol_rx() {
   
   // Flush any pending TX response
   JsonProtocol::flushPending();
+  diagReplyStep();  // Next line of an N=120 reply, if one is going out
+
+#if LINK_BAUD_ENABLED
+  // Unconfirmed rate switch timed out: back at SERIAL_BAUD
+  if (linkBaud.update()) {
+    jsonFrameParser.reset();
+  }
+#endif
   
   // Limit bytes per call to prevent blocking
   uint8_t bytesProcessed = 0;
@@ -258,144 +389,54 @@ void task_protocol_rx() {
     if (byte == 0xAA || byte == 0x55) {
       continue;  // Ignore legacy binary protocol bytes
     }
+
+#if LINK_BAUD_ENABLED
+    // Framing garbage at a switched rate: peer is at another baud
+    if (linkBaud.onByte(byte)) {
+      jsonFrameParser.reset();
+      break;
+    }
+#endif
     
     // JSON protocol - use frame parser
     if (jsonFrameParser.processByte(byte)) {
+      g_cmdRxUs = micros();  // Frame complete ('}' consumed) - N=123 receive stamp
       ParsedCommand cmd;
       if (jsonFrameParser.getCommand(cmd)) {
         // Reset parser after getting command
         jsonFrameParser.reset();
         wdt_reset();
+#if LINK_BAUD_ENABLED
+        linkBaud.onFrame();  // Valid frame: the current rate works
+#endif
         
-        // Route command based on N value
-        if (cmd.N == 0) {
-          // N=0: Hello handshake
-          JsonProtocol::sendHelloOk();
-        } else if (cmd.N == 5) {
-          // N=5: Servo control - D1 is angle (0-180)
-          // Probe RAM before servo.attach() - known stack-heavy path
-          updateMinFreeRam();
-          uint8_t angle = constrain(cmd.D1, 0, 180);
-          servoPan.setAngle(angle);
-          updateMinFreeRam();  // Probe after servo path
-          JsonProtocol::sendOk(cmd.H);
-        } else if (cmd.N == 120) {
-          // N=120: Diagnostics - compact debug state + HW + RAM + IMU + safety layer + init
-          // Format: {owner,lpwm,rpwm,mstate,reset,hw:<hash>,imu:<0/1>,ram:<free>,min:<min>,
-          //          batt:<mV>,b:<state>,cap:<max>,db:<L>/<R>,ramp:<a>/<d>,kick:<0/1>,init:<state>}
-          updateMinFreeRam();  // Probe at diagnostics path
-          if (Serial.availableForWrite() >= 100) {
-            uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
-            Serial.print(F("{"));
-            Serial.print(g_lastOwner);
-            Serial.print(directLeftPWM);
-            Serial.print(',');
-            Serial.print(directRightPWM);
-            Serial.print(',');
-            Serial.print((uint8_t)motionController.getState());
-            Serial.print(',');
-            Serial.print(g_resetCounter);
-            Serial.print(F(",hw:"));
-            Serial.print(F(HARDWARE_PROFILE_HASH));
-            Serial.print(F(",imu:"));
-            Serial.print(g_imuInitialized ? 1 : 0);
-            Serial.print(F(",ram:"));
-            Serial.print(freeRam());
-            Serial.print(F(",min:"));
-            Serial.print(g_minFreeRam);
-            // Safety layer fields
-            Serial.print(F(",batt:"));
-            Serial.print(voltage_mv);
-            Serial.print(F(",b:"));
-            Serial.print((uint8_t)driveSafety.getBatteryState());
-            Serial.print(F(",cap:"));
-            Serial.print(driveSafety.getEffectiveMaxPwm());
-            Serial.print(F(",db:"));
-            Serial.print(driveSafety.getDeadbandL());
-            Serial.print('/');
-            Serial.print(driveSafety.getDeadbandR());
-            Serial.print(F(",ramp:"));
-            Serial.print(driveSafety.getEffectiveAccelStep());
-            Serial.print('/');
-            Serial.print(driveSafety.getEffectiveDecelStep());
-            Serial.print(F(",kick:"));
-            Serial.print(driveSafety.isKickEnabled() ? 1 : 0);
-            // Init sequence state
-            Serial.print(F(",init:"));
-            Serial.print((uint8_t)initSequence.getState());
-            Serial.println('}');
-          }
-          JsonProtocol::sendStats(g_parseStats);
-        } else if (cmd.N == 130) {
-          // N=130: Re-run Init Sequence
-          // Stops motors, resets state, runs init sequence again
-          motionController.stop();
-          macroEngine.cancel();
-          driveSafety.resetSlew();
-          initSequence.requestRerun();
-          JsonProtocol::sendOk(cmd.H);
-        } else if (cmd.N == 140) {
-          // N=140: Set Drive Config
-          // D1: parameter selector, D2: value
-          // 1=deadband (high=L, low=R), 2=accel step, 3=decel step, 4=kick enable, 5=max PWM cap
-          switch (cmd.D1) {
-            case 1: {
-              // Deadband: D2 high byte = L, low byte = R
-              uint8_t dbL = (cmd.D2 >> 8) & 0xFF;
-              uint8_t dbR = cmd.D2 & 0xFF;
-              if (dbL == 0) dbL = PWM_DEADBAND_L_DEFAULT;
-              if (dbR == 0) dbR = PWM_DEADBAND_R_DEFAULT;
-              driveSafety.setDeadbandL(dbL);
-              driveSafety.setDeadbandR(dbR);
-              break;
-            }
-            case 2:
-              // Accel step (0 = use battery-based default)
-              if (cmd.D2 == 0) {
-                driveSafety.clearAccelOverride();
-              } else {
-                driveSafety.setAccelStep(constrain(cmd.D2, 1, 50));
-              }
-              break;
-            case 3:
-              // Decel step (0 = use battery-based default)
-              if (cmd.D2 == 0) {
-                driveSafety.clearDecelOverride();
-              } else {
-                driveSafety.setDecelStep(constrain(cmd.D2, 1, 50));
-              }
-              break;
-            case 4:
-              // Kick enable (0/1, 0xFF = use default)
-              if (cmd.D2 == 0xFF || cmd.D2 > 1) {
-                driveSafety.clearKickOverride();
-              } else {
-                driveSafety.setKickEnabled(cmd.D2 == 1);
-              }
-              break;
-            case 5:
-              // Max PWM cap (0 = use battery-based default)
-              if (cmd.D2 == 0) {
-                driveSafety.clearMaxPwmOverride();
-              } else {
-                driveSafety.setMaxPwmCap(constrain(cmd.D2, 50, 255));
-              }
-              break;
-            default:
-              break;
+        // Route through the PROGMEM dispatch table (constant-cost lookup)
+        const CommandEntry* entry;
+        {
+          TRACE_SCOPE(TRACE_CMD_LOOKUP);
+          entry = commandLookup(cmd.N);
+        }
+        TRACE_SCOPE(traceCommandPoint(cmd.N));
+        bool admitted = true;
+#if SAFETY_ADMISSION_ENABLED
+        // Class token bucket: a flood costs a lookup and a {H_false}, not
+        // its handler. maxRateHz 0 rows (N=201) are never refused.
+        if (entry) {
+          admitted = safetyLayer.admit(commandClass(entry), commandMaxRateHz(entry));
+        }
+#endif
+        if (entry && admitted) {
+          commandHandler(entry)(cmd);
+        } else if (entry) {
+          // Refused by admission control
+          if (commandFlags(entry) & CMD_ACK) {
+            JsonProtocol::sendFalse(cmd.H);
           }
-          JsonProtocol::sendOk(cmd.H);
         } else if (cmd.N >= 200) {
-          // N=200+: Motion commands
-          handleMotionCommand(cmd);
-        } else if (cmd.N == 100 || cmd.N == 110) {
-          // N=100/110: Legacy stop commands - override motion
-          motionController.stop();
-          macroEngine.cancel();
-          motorDriver.stop();
-          JsonProtocol::sendOk();
+          // Unknown motion command
+          JsonProtocol::sendFalse(cmd.H);
         } else {
-          // N=1-199: Legacy ELEGOO commands
+          // Other N=1-199: legacy ELEGOO commands, acknowledged only
           handleLegacyCommand(cmd);
         }
         
@@ -408,272 +449,707 @@ void task_protocol_rx() {
   wdt_reset();
 }
 
-// Handle legacy ELEGOO commands (N=1-199)
-void handleLegacyCommand(const ParsedCommand& cmd) {
+// ============================================================================
+// Command handlers (dispatched through COMMAND_TABLE)
+// ============================================================================
+
+// N=0: Hello handshake
+static void handleHello(const ParsedCommand& cmd) {
+  (void)cmd;
+  JsonProtocol::sendHelloOk();
+}
+
+// N=5: Servo control - D1 is angle (0-180)
+static void handleServo(const ParsedCommand& cmd) {
+  // Probe RAM before servo.attach() - known stack-heavy path
+  updateMinFreeRam();
+  if (rangeScanner.isActive()) {
+    // Scanner owns the servo until the sweep finishes
+    JsonProtocol::sendFalse(cmd.H);
+  } else {
+    uint8_t angle = constrain(cmd.D1, 0, 180);
+    servoPan.setAngle(angle);
+    updateMinFreeRam();  // Probe after servo path
+    JsonProtocol::sendOk(cmd.H);
+  }
+}
+
+// N=21: Ultrasonic sensor
+// D1=1: Return obstacle detection (true/false)
+// D1=2: Return distance in cm
+static void handleUltrasonic(const ParsedCommand& cmd) {
   wdt_reset();
+  uint16_t distance = ultrasonic.getDistance();
   
-  // Handle sensor commands with actual data
-  switch (cmd.N) {
-    case 21: {
-      // N=21: Ultrasonic sensor
-      // D1=1: Return obstacle detection (true/false)
-      // D1=2: Return distance in cm
-      uint16_t distance = ultrasonic.getDistance();
-      
-      if (cmd.D1 == 1) {
-        // Obstacle detection mode (within 20cm)
-        if (distance > 0 && distance <= 20) {
-          JsonProtocol::sendTrue(cmd.H);
-        } else {
-          JsonProtocol::sendFalse(cmd.H);
-        }
-      } else if (cmd.D1 == 2) {
-        // Distance mode - return actual cm value
-        char valueStr[8];
-        snprintf(valueStr, sizeof(valueStr), "%u", distance);
-        JsonProtocol::sendValue(cmd.H, valueStr);
-      } else {
-        JsonProtocol::sendOk(cmd.H);
-      }
-      return;
-    }
-    
-    case 22: {
-      // N=22: Line sensor (tracking module)
-      // D1=0: Left sensor value
-      // D1=1: Middle sensor value
-      // D1=2: Right sensor value
-      uint16_t value = 0;
-      
-      if (cmd.D1 == 0) {
-        value = lineSensor.readLeft();
-      } else if (cmd.D1 == 1) {
-        value = lineSensor.readMiddle();
-      } else if (cmd.D1 == 2) {
-        value = lineSensor.readRight();
-      }
-      
-      char valueStr[8];
-      snprintf(valueStr, sizeof(valueStr), "%u", value);
-      JsonProtocol::sendValue(cmd.H, valueStr);
-      return;
+  if (cmd.D1 == 1) {
+    // Obstacle detection mode (within 20cm)
+    if (distance > 0 && distance <= 20) {
+      JsonProtocol::sendTrue(cmd.H);
+    } else {
+      JsonProtocol::sendFalse(cmd.H);
     }
-    
-    case 23: {
-      // N=23: Battery voltage (ZIP extension)
-      // D1=0 (default): Returns voltage in millivolts
-      // D1=1: Returns raw ADC value and voltage for diagnostics
-      if (cmd.D1 == 1) {
-        // Diagnostic mode: show raw ADC + calculated voltage
-        uint16_t adc = analogRead(PIN_VOLTAGE);
-        uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
-        // Calculate expected A3 pin voltage (mV) = adc / 1023 * 5000
-        uint16_t a3_mv = (uint16_t)((adc * 5000UL) / 1023);
-        Serial.print(F("{"));
-        Serial.print(cmd.H);
-        Serial.print(F("_adc:"));
-        Serial.print(adc);
-        Serial.print(F(",a3_mv:"));
-        Serial.print(a3_mv);
-        Serial.print(F(",batt_mv:"));
-        Serial.print(voltage_mv);
-        Serial.println(F("}"));
-      } else {
-        // Normal mode: just voltage in millivolts
-        uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
-        char valueStr[8];
-        snprintf(valueStr, sizeof(valueStr), "%u", voltage_mv);
-        JsonProtocol::sendValue(cmd.H, valueStr);
+  } else if (cmd.D1 == 2) {
+    // Distance mode - return actual cm value
+    JsonProtocol::sendNumber(cmd.H, distance);
+  } else {
+    JsonProtocol::sendOk(cmd.H);
+  }
+}
+
+// N=22: Line sensor (tracking module)
+// D1=0: Left sensor value
+// D1=1: Middle sensor value
+// D1=2: Right sensor value
+static void handleLineSensor(const ParsedCommand& cmd) {
+  wdt_reset();
+  uint16_t value = 0;
+  
+  if (cmd.D1 == 0) {
+    value = lineSensor.readLeft();
+  } else if (cmd.D1 == 1) {
+    value = lineSensor.readMiddle();
+  } else if (cmd.D1 == 2) {
+    value = lineSensor.readRight();
+  }
+  
+  JsonProtocol::sendNumber(cmd.H, value);
+}
+
+// N=23: Battery voltage (ZIP extension)
+// D1=0 (default): Returns voltage in millivolts
+// D1=1: Returns raw ADC value and voltage for diagnostics
+static void handleBattery(const ParsedCommand& cmd) {
+  wdt_reset();
+  if (cmd.D1 == 1) {
+    // Diagnostic mode: show raw ADC + calculated voltage
+    uint16_t adc = adcSampler.get(PIN_VOLTAGE);
+    uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
+    // Calculate expected A3 pin voltage (mV) = adc / 1023 * 5000
+    uint16_t a3_mv = (uint16_t)((adc * 5000UL) / 1023);
+    ResponseWriter w;
+    w.begin(cmd.H).str(F("adc:")).num(adc);
+    w.str(F(",a3_mv:")).num(a3_mv);
+    w.str(F(",batt_mv:")).num(voltage_mv);
+    w.end();
+  } else {
+    // Normal mode: just voltage in millivolts
+    uint16_t voltage_mv = (uint16_t)(batteryMonitor.readVoltage() * 1000);
+    JsonProtocol::sendNumber(cmd.H, voltage_mv);
+  }
+}
+
+// N=100/110: Legacy stop commands - override motion
+static void handleLegacyStop(const ParsedCommand& cmd) {
+  (void)cmd;
+  selfTestAbort();
+  rangeScanner.cancel();
+  motionController.stop();
+  macroEngine.cancel();
+  motorDriver.stop();
+  JsonProtocol::sendOk();
+}
+
+// N=120: Diagnostics - compact debug state + HW + RAM + IMU + safety layer + init
+// Format: one short line per group, then the parser stats line:
+//   {<owner><L>,<R>,<state>,<resets>,hw:<hash>,imu:<0/1>,ram:<free>,min:<min>}
+//   {stk:<unused>,batt:<mV>,b:<state>}
+//   {cap:<max>,db:<L>/<R>,ramp:<a>/<d>,kick:<0/1>}
+//   {ff:<gain%>/<voc mV>/<sag mV>,init:<state>,ttc:<interventions>/<brakes>}
+//   {ttl:<period ms>/<jitter ms>/<ttl ms>,bb:<n>/<frozen>}
+//   {rl:<motion>/<sensor>/<config>/<diag>}
+//   {sl:<calls>/<ff>/<cap>/<slew>/<kick>/<db>}
+//   {lag:<run>/<last>/<peak>/<gap pwm>}
+//   {stats:rx=<rx>,jd=<jd>,pe=<pe>,tx=<tx>,ms=<ms>}
+// As one ~300-byte line it was nearly five 64-byte TX rings and held the
+// loop ~26ms at 115200. Each line now waits for a loop pass with room for
+// all of it (DIAG_LINE_MAX), so the reply never blocks; lines are read when
+// written, a few ms apart.
+#define DIAG_LINE_MAX 58  // Longest line ({stats:...} at its widest) + newline
+
+static Coroutine s_diagCo;
+static bool s_diagActive = false;
+
+#define DIAG_NEXT_LINE() \
+  CO_YIELD_UNTIL(s_diagCo, Serial.availableForWrite() >= DIAG_LINE_MAX)
+
+static CoStatus diagReplyRun() {
+  CO_BEGIN(s_diagCo);
+
+  DIAG_NEXT_LINE();
+  {
+    ResponseWriter w;
+    w.ch('{').ch(g_lastOwner).num(directLeftPWM);
+    w.ch(',').num(directRightPWM);
+    w.ch(',').num((uint16_t)motionController.getState());
+    w.ch(',').num((uint16_t)g_resetCounter);
+    w.str(F(",hw:")).str(F(HARDWARE_PROFILE_HASH));
+    w.str(F(",imu:")).ch(g_imuInitialized ? '1' : '0');
+    // ram:/min: stay on the hw: line, where hardware_smoke.js checks them
+    w.str(F(",ram:")).num((uint16_t)freeRam());
+    w.str(F(",min:")).num((uint16_t)g_minFreeRam);
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    ResponseWriter w;
+    w.str(F("{stk:")).num((uint16_t)stackMonitor.unusedBytes());
+    w.str(F(",batt:")).num((uint16_t)(batteryMonitor.readVoltage() * 1000));
+    w.str(F(",b:")).num((uint16_t)driveSafety.getBatteryState());
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    ResponseWriter w;
+    w.str(F("{cap:")).num((uint16_t)driveSafety.getEffectiveMaxPwm());
+    w.str(F(",db:")).num((uint16_t)driveSafety.getDeadbandL());
+    w.ch('/').num((uint16_t)driveSafety.getDeadbandR());
+    w.str(F(",ramp:")).num((uint16_t)driveSafety.getEffectiveAccelStep());
+    w.ch('/').num((uint16_t)driveSafety.getEffectiveDecelStep());
+    w.str(F(",kick:")).ch(driveSafety.isKickEnabled() ? '1' : '0');
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    ResponseWriter w;
+    w.str(F("{ff:")).num((uint16_t)driveSafety.getFeedforwardGainPct());
+    w.ch('/').num((uint16_t)driveSafety.getOpenCircuitMv());
+    w.ch('/').num((uint16_t)driveSafety.getSagMv());
+    w.str(F(",init:")).num((uint16_t)initSequence.getState());
+    w.str(F(",ttc:")).num((uint16_t)collisionReflex.getInterventions());
+    w.ch('/').num((uint16_t)collisionReflex.getBrakeEvents());
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    // Setpoint arrival estimate and the TTL it produced
+    const SetpointArrivalStats& arrival = motionController.getArrivalStats();
+    ResponseWriter w;
+    w.str(F("{ttl:")).num((uint16_t)(arrival.meanX8 >> 3));
+    w.ch('/').num((uint16_t)(arrival.jitterX4 >> 2));
+    w.ch('/').num((uint16_t)arrival.ttlMs);
+#if BLACK_BOX_ENABLED
+    // Black-box records held and whether they are frozen (N=125 dumps them)
+    w.str(F(",bb:")).num((uint16_t)blackBox.getCount());
+    w.ch('/').ch(blackBox.isFrozen() ? '1' : '0');
+#endif
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    // Commands refused by admission control, per class
+    ResponseWriter w;
+    w.str(F("{rl:"));
+    for (uint8_t i = 0; i < SAFETY_CLASS_COUNT; i++) {
+      if (i) {
+        w.ch('/');
       }
-      return;
+      w.num((uint16_t)safetyLayer.getRejected(i));
     }
-    
-    default:
-      break;
+    w.end();
   }
-  
-  // Commands 2 and 7 have delayed response in official firmware
-  // (they respond after timer expires)
-  if (cmd.N == 2 || cmd.N == 7) {
+
+#if SAFETY_STATS_ENABLED
+  DIAG_NEXT_LINE();
+  {
+    // Safety layer interventions per stage (applyLimits() calls)
+    const DriveLimitStats& ls = driveSafety.getLimitStats();
+    ResponseWriter w;
+    w.str(F("{sl:")).num(ls.calls);
+    w.ch('/').num(ls.feedforward);
+    w.ch('/').num(ls.cap);
+    w.ch('/').num(ls.slew);
+    w.ch('/').num(ls.kick);
+    w.ch('/').num(ls.deadband);
+    w.end();
+  }
+
+  DIAG_NEXT_LINE();
+  {
+    // Slew lag (applyLimits() calls) and this call's PWM gap
+    const DriveLimitStats& ls = driveSafety.getLimitStats();
+    ResponseWriter w;
+    w.str(F("{lag:")).num((uint16_t)ls.lagRunCalls);
+    w.ch('/').num((uint16_t)ls.lagLastCalls);
+    w.ch('/').num((uint16_t)ls.lagPeakCalls);
+    w.ch('/').num((uint16_t)ls.gapPwm);
+    w.end();
+  }
+#endif
+
+  DIAG_NEXT_LINE();
+  JsonProtocol::sendStats(g_parseStats);
+
+  CO_END(s_diagCo);
+}
+
+static void diagReplyStep() {
+  if (s_diagActive && diagReplyRun() == CO_DONE) {
+    s_diagActive = false;
+  }
+}
+
+static void handleDiagnostics(const ParsedCommand& cmd) {
+  (void)cmd;
+  updateMinFreeRam();  // Probe at diagnostics path
+  // A repeat while a reply is still going out is answered by that reply
+  if (!s_diagActive) {
+    CO_RESET(s_diagCo);
+    s_diagActive = true;
+  }
+}
+
+// N=121: Stack profile - painted-stack watermark + sampled per-task peaks
+// Format: {<H>_stk:<unused>,<task>:<peak>,...} (bytes; 0 = not sampled yet)
+static void handleStackProfile(const ParsedCommand& cmd) {
+  Serial.print('{');
+  Serial.print(cmd.H);
+  Serial.print(F("_stk:"));
+  Serial.print(stackMonitor.unusedBytes());
+  for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+    Serial.print(',');
+    Serial.print(scheduler.getTaskName(i));
+    Serial.print(':');
+    Serial.print(scheduler.getTaskStackPeak(i));
+  }
+  Serial.print(F("}\n"));
+}
+
+// N=122: Trace histograms dump + reset (D1=1: keep counting)
+// Format: {<H>_<point>:<n>,<max_us>,<first_bucket>:<c>.<c>...;...}
+static void handleTraceDump(const ParsedCommand& cmd) {
+#if TRACE_ENABLED
+  traceHist.dump(cmd.H, cmd.D1 != 1);
+#else
+  JsonProtocol::sendFalse(cmd.H);  // Built without TRACE_ENABLED
+#endif
+}
+
+// N=123: Time probe - echoes host timestamp T with the UNO's micros() at
+// frame receive and at reply, plus bytes already queued ahead in the TX ring
+// (the host adds their wire time). Format: {<H>_<T>,<rx_us>,<tx_us>,<txq>}
+static void handleTimeProbe(const ParsedCommand& cmd) {
+  uint8_t txQueued = (uint8_t)(SERIAL_TX_BUFFER_SIZE - 1 - Serial.availableForWrite());
+  uint32_t txUs = micros();
+  Serial.print('{');
+  Serial.print(cmd.H);
+  Serial.print('_');
+  Serial.print(cmd.T);
+  Serial.print(',');
+  Serial.print(g_cmdRxUs);
+  Serial.print(',');
+  Serial.print(txUs);
+  Serial.print(',');
+  Serial.print(txQueued);
+  Serial.print(F("}\n"));
+}
+
+// N=124: Link baud switch - D1 = kbaud (115/250/500/1000), 0 = query.
+// {H_ok} goes out at the old rate, then the UART switches; the first valid
+// frame at the new rate confirms it (see core/link_baud.h for the fallbacks).
+// Query format: {<H>_<kbaud>}
+static void handleLinkBaud(const ParsedCommand& cmd) {
+#if LINK_BAUD_ENABLED
+  if (cmd.D1 == 0) {
+    Serial.print('{');
+    Serial.print(cmd.H);
+    Serial.print('_');
+    Serial.print(linkBaud.currentKbaud());
+    Serial.print(F("}\n"));
     return;
   }
-  
-  // All other legacy commands respond with {H_ok}
-  if (strlen(cmd.H) > 0) {
+  if (!LinkBaud::supported((uint16_t)cmd.D1)) {
+    JsonProtocol::sendFalse(cmd.H);
+    return;
+  }
+  // Printed directly: the pending-TX path would send it after the switch
+  Serial.print('{');
+  Serial.print(cmd.H);
+  Serial.print(F("_ok}\n"));
+  linkBaud.switchTo((uint16_t)cmd.D1);
+  jsonFrameParser.reset();
+#else
+  JsonProtocol::sendFalse(cmd.H);  // Built without LINK_BAUD_ENABLED
+#endif
+}
+
+// N=125: Black-box dump (D1=1: clear and record again)
+// Format: {<H>_bb:<count>,<boots>,<cause>,<lastMs>,<frozen>}\n followed by
+// count * 8 raw record bytes, oldest first, then '\n' (core/black_box.h)
+static void handleBlackBox(const ParsedCommand& cmd) {
+#if BLACK_BOX_ENABLED
+  if (cmd.D1 == 1) {
+    blackBox.rearm();
+    JsonProtocol::sendOk(cmd.H);
+    return;
+  }
+  blackBox.dump(cmd.H);
+#else
+  JsonProtocol::sendFalse(cmd.H);  // Built without BLACK_BOX_ENABLED
+#endif
+}
+
+// N=130: Re-run Init Sequence
+// Stops motors, resets state, runs init sequence again
+// D1=1: also calibrate deadband/kick from the gyro (CAL: line when done)
+// D1=2: reprint the last CAL: line, no motion
+static void handleInitRerun(const ParsedCommand& cmd) {
+  if (cmd.D1 == 2) {
     JsonProtocol::sendOk(cmd.H);
+    initSequence.printCalReport();
+    return;
+  }
+  selfTestAbort();
+  motionController.stop();
+  macroEngine.cancel();
+  driveSafety.resetSlew();
+  if (cmd.D1 == 1) {
+#if INIT_CAL_ENABLED
+    initSequence.requestCalibration();
+#else
+    JsonProtocol::sendFalse(cmd.H);
+    return;
+#endif
   } else {
-    JsonProtocol::sendOk();
+    initSequence.requestRerun();
   }
+  JsonProtocol::sendOk(cmd.H);
 }
 
-// Handle motion commands (N=200+)
-void handleMotionCommand(const ParsedCommand& cmd) {
-  wdt_reset();
-  
-  switch (cmd.N) {
-    case 200: {
-      // N=200: Drive Setpoint (fire-and-forget, NO RESPONSE)
-      // D1: v (forward command -255..255)
-      // D2: w (yaw command -255..255)
-      // T: TTL (150-300ms)
-      
-      g_lastOwner = 'M';  // Track motion mode for diagnostics
-      
-      // Cancel any active macro
-      if (macroEngine.isActive()) {
-        macroEngine.cancel();
-      }
-      
-      // Enable motors (TB6612FNG requires STBY=HIGH)
-      motorDriver.enable();
-      
-      // Apply setpoint
-      motionController.setSetpoint(cmd.D1, cmd.D2, cmd.T);
-      wdt_reset();
-      
-      // NO RESPONSE - fire and forget for streaming
+// N=140: Set Drive Config
+// D1: parameter selector, D2: value
+// 1=deadband (high=L, low=R), 2=accel step, 3=decel step, 4=kick enable, 5=max PWM cap,
+// 6=TTC reflex brake threshold ms (0 = disable), 7=feedforward nominal mV (0 = off)
+static void handleDriveConfig(const ParsedCommand& cmd) {
+  switch (cmd.D1) {
+    case 1: {
+      // Deadband: D2 high byte = L, low byte = R
+      uint8_t dbL = (cmd.D2 >> 8) & 0xFF;
+      uint8_t dbR = cmd.D2 & 0xFF;
+      if (dbL == 0) dbL = PWM_DEADBAND_L_DEFAULT;
+      if (dbR == 0) dbR = PWM_DEADBAND_R_DEFAULT;
+      driveSafety.setDeadbandL(dbL);
+      driveSafety.setDeadbandR(dbR);
       break;
     }
-    
-    case 201: {
-      // N=201: Stop Now (MUST RESPOND)
-      // ABSOLUTE STOP - highest priority, preempts everything
-      
-      g_lastOwner = 'X';  // Track stopped state for diagnostics
-      
-      // Clear DIRECT mode values FIRST (prevents control loop re-apply)
-      directLeftPWM = 0;
-      directRightPWM = 0;
-      
-      // Update state machines (these no longer touch motor pins)
-      motionController.stop();  // Sets state to IDLE
-      macroEngine.cancel();     // Sets active to false
-      initSequence.abort();     // Abort init if running
-      driveSafety.resetSlew();  // Reset safety layer slew state
-      
-      // SINGLE MOTOR WRITE POINT - only here we touch motor pins for stop
-      // TB6612FNG: Set PWM to 0 AND disable STBY
-      analogWrite(PIN_MOTOR_PWMA, 0);
-      analogWrite(PIN_MOTOR_PWMB, 0);
-      digitalWrite(PIN_MOTOR_STBY, LOW);  // Disable motor driver
-      
-      JsonProtocol::sendOk(cmd.H);
-      wdt_reset();
+    case 2:
+      // Accel step (0 = use battery-based default)
+      if (cmd.D2 == 0) {
+        driveSafety.clearAccelOverride();
+      } else {
+        driveSafety.setAccelStep(constrain(cmd.D2, 1, 50));
+      }
       break;
-    }
-    
-    case 999: {
-      // N=999: Direct Motor Test (bypasses motion controller)
-      // D1: left PWM (-255..255)
-      // D2: right PWM (-255..255)
-      // DIRECT MODE - single owner model
-      
-      g_lastOwner = 'D';  // Track direct mode for diagnostics
-      
-      // Set motion controller to DIRECT mode so update loop doesn't interfere
-      motionController.setDirectMode();
-      macroEngine.cancel();  // Safe: no longer touches motor pins
-      
-      // Apply PWM directly to pins using TB6612FNG direction logic
-      int16_t left = constrain(cmd.D1, -255, 255);
-      int16_t right = constrain(cmd.D2, -255, 255);
-      
-#if SAFETY_LAYER_ENABLED && !SAFETY_LAYER_BYPASS_DIRECT
-      // Apply safety layer limits (battery-aware cap, ramping, deadband)
-      driveSafety.applyLimits(&left, &right);
-#endif
-      
-      // CRITICAL: Enable motor driver (TB6612FNG requires STBY=HIGH)
-      digitalWrite(PIN_MOTOR_STBY, HIGH);
-      
-      // TB6612FNG Direction Logic (from official ELEGOO code V1_20230201):
-      // Motor A (Right): Forward = AIN_1 HIGH, Reverse = AIN_1 LOW
-      // Motor B (Left):  Forward = BIN_1 HIGH, Reverse = BIN_1 LOW
-      
-      // Right motor (Motor A: PWMA=5, AIN_1=7)
-      if (right > 0) {
-        digitalWrite(PIN_MOTOR_AIN_1, HIGH);  // Forward (TB6612: HIGH)
-        analogWrite(PIN_MOTOR_PWMA, right);
-      } else if (right < 0) {
-        digitalWrite(PIN_MOTOR_AIN_1, LOW);   // Reverse (TB6612: LOW)
-        analogWrite(PIN_MOTOR_PWMA, -right);
+    case 3:
+      // Decel step (0 = use battery-based default)
+      if (cmd.D2 == 0) {
+        driveSafety.clearDecelOverride();
       } else {
-        analogWrite(PIN_MOTOR_PWMA, 0);
+        driveSafety.setDecelStep(constrain(cmd.D2, 1, 50));
       }
-      
-      // Left motor (Motor B: PWMB=6, BIN_1=8)
-      if (left > 0) {
-        digitalWrite(PIN_MOTOR_BIN_1, HIGH);  // Forward (TB6612: HIGH)
-        analogWrite(PIN_MOTOR_PWMB, left);
-      } else if (left < 0) {
-        digitalWrite(PIN_MOTOR_BIN_1, LOW);   // Reverse (TB6612: LOW)
-        analogWrite(PIN_MOTOR_PWMB, -left);
+      break;
+    case 4:
+      // Kick enable (0/1, 0xFF = use default)
+      if (cmd.D2 == 0xFF || cmd.D2 > 1) {
+        driveSafety.clearKickOverride();
       } else {
-        analogWrite(PIN_MOTOR_PWMB, 0);
+        driveSafety.setKickEnabled(cmd.D2 == 1);
       }
-      
-      // Store values for diagnostics (after safety layer applied)
-      directLeftPWM = left;
-      directRightPWM = right;
-      
-      JsonProtocol::sendOk(cmd.H);
-      wdt_reset();
       break;
-    }
-    
-    case 210: {
-      // N=210: Macro Execute (MUST RESPOND)
-      // D1: macro_id (1=FIGURE_8, 2=SPIN_360, 3=WIGGLE, 4=FORWARD_THEN_STOP)
-      // D2: intensity (0-255)
-      // T: TTL (1000-10000ms)
-      
-      // Probe RAM at macro transition
-      updateMinFreeRam();
-      
-      // Stop any active setpoint
-      motionController.stop();
-      
-      // Enable motors (TB6612FNG requires STBY=HIGH)
-      motorDriver.enable();
-      
-      // Start macro
-      MacroID macroId = (MacroID)cmd.D1;
-      bool started = macroEngine.startMacro(macroId, cmd.D2, cmd.T);
-      
-      if (started) {
-        JsonProtocol::sendOk(cmd.H);
+    case 5:
+      // Max PWM cap (0 = use battery-based default)
+      if (cmd.D2 == 0) {
+        driveSafety.clearMaxPwmOverride();
       } else {
-        JsonProtocol::sendFalse(cmd.H);
+        driveSafety.setMaxPwmCap(constrain(cmd.D2, 50, 255));
       }
-      wdt_reset();
       break;
-    }
-    
-    case 211: {
-      // N=211: Macro Cancel (MUST RESPOND)
-      macroEngine.cancel();
-      JsonProtocol::sendOk(cmd.H);
-      wdt_reset();
+    case 6:
+      // TTC reflex brake threshold (0 = disable reflex)
+      if (cmd.D2 <= 0) {
+        collisionReflex.setBrakeTtcMs(0);
+      } else {
+        collisionReflex.setBrakeTtcMs(constrain(cmd.D2, 100, 3000));
+      }
+      break;
+    case 7:
+      // Battery sag feedforward nominal voltage (0 = disable scaling)
+      if (cmd.D2 <= 0) {
+        driveSafety.setFeedforwardNominal(0);
+      } else {
+        driveSafety.setFeedforwardNominal(constrain(cmd.D2, 6000, 8400));
+      }
+      break;
+    case 8:
+      // Zero the intervention counters and lag peak (start of a tuning run)
+      driveSafety.resetLimitStats();
       break;
-    }
-    
     default:
-      // Unknown motion command
-      JsonProtocol::sendFalse(cmd.H);
-      wdt_reset();
       break;
   }
+  JsonProtocol::sendOk(cmd.H);
+}
+
+// N=150: Range scan - D1=start deg, D2=end deg, D3=step deg
+// Defaults: D1=D2=0 -> full 0..180 sweep, D3=0 -> 10 degree step
+// Responds once with the full profile, or {H_false} if rejected
+static void handleRangeScan(const ParsedCommand& cmd) {
+  int16_t startDeg = cmd.D1;
+  int16_t endDeg = cmd.D2;
+  if (startDeg == 0 && endDeg == 0) {
+    endDeg = SERVO_ANGLE_MAX;
+  }
+  int16_t stepDeg = (cmd.D3 == 0) ? 10 : cmd.D3;
+  if (!rangeScanner.start(startDeg, endDeg, stepDeg, cmd.H)) {
+    JsonProtocol::sendFalse(cmd.H);
+  }
+}
+
+// N=200: Drive Setpoint (fire-and-forget, NO RESPONSE)
+// D1: v (forward command -255..255)
+// D2: w (yaw command -255..255)
+// T: TTL (150-300ms)
+// D3: seq 1..32767 (optional) - duplicates/out-of-order frames are dropped
+// D4: host send time in UNO millis(), low 15 bits (optional) - frames older
+//     than their TTL are dropped. Outcomes go out in the {sq:...} ack.
+static void handleSetpoint(const ParsedCommand& cmd) {
+  wdt_reset();
+  
+  if (selfTestActive()) {
+    return;  // Self-test owns the motors; N=201 aborts it
+  }
+  
+  if (motionController.admitSetpoint((uint16_t)cmd.D3, (uint16_t)cmd.D4, cmd.T) != SETPOINT_ADMIT_OK) {
+    return;  // Leave macros, motors and TTL untouched
+  }
+  g_lastOwner = 'M';  // Track motion mode for diagnostics
+  
+  // Cancel any active macro
+  if (macroEngine.isActive()) {
+    macroEngine.cancel();
+  }
+  
+  // Enable motors (TB6612FNG requires STBY=HIGH)
+  motorDriver.enable();
+  
+  // Reflex is mostly blind while the head sweeps - creep forward only
+  int16_t v = cmd.D1;
+  if (rangeScanner.isActive() && v > SCAN_FORWARD_V_MAX) {
+    v = SCAN_FORWARD_V_MAX;
+  }
+  
+  // Apply setpoint
+  motionController.setSetpoint(v, cmd.D2, cmd.T);
+  wdt_reset();
+  
+  // NO RESPONSE - fire and forget for streaming
+}
+
+// N=201: Stop Now (MUST RESPOND)
+// ABSOLUTE STOP - highest priority, preempts everything
+static void handleStopNow(const ParsedCommand& cmd) {
+  wdt_reset();
+  g_lastOwner = 'X';  // Track stopped state for diagnostics
+  
+  // Clear DIRECT mode values FIRST (prevents control loop re-apply)
+  directLeftPWM = 0;
+  directRightPWM = 0;
+  
+  // Update state machines (these no longer touch motor pins)
+  motionController.stop();  // Sets state to IDLE
+  macroEngine.cancel();     // Sets active to false
+  initSequence.abort();     // Abort init if running
+  selfTestAbort();          // Abort motor self-test if running
+  rangeScanner.cancel();    // Stop the sweep, head back to its angle
+  driveSafety.resetSlew();  // Reset safety layer slew state
+  
+  // SINGLE MOTOR WRITE POINT - only here we touch motor pins for stop
+  // TB6612FNG: Set PWM to 0 AND disable STBY
+  FastPwm<PIN_MOTOR_PWMA>::write(0);
+  FastPwm<PIN_MOTOR_PWMB>::write(0);
+  FastPin<PIN_MOTOR_STBY>::low();  // Disable motor driver
+  
+  JsonProtocol::sendOk(cmd.H);
+  wdt_reset();
+}
+
+// N=210: Macro Execute (MUST RESPOND)
+// D1: macro_id (1=FIGURE_8, 2=SPIN_360, 3=WIGGLE, 4=FORWARD_THEN_STOP)
+// D2: intensity (0-255)
+// T: TTL (1000-10000ms)
+static void handleMacroStart(const ParsedCommand& cmd) {
+  wdt_reset();
+  
+  // Probe RAM at macro transition
+  updateMinFreeRam();
+  
+  if (selfTestActive()) {
+    JsonProtocol::sendFalse(cmd.H);  // Self-test owns the motors
+    return;
+  }
+  
+  // Stop any active setpoint
+  motionController.stop();
+  
+  // Enable motors (TB6612FNG requires STBY=HIGH)
+  motorDriver.enable();
+  
+  // Start macro
+  MacroID macroId = (MacroID)cmd.D1;
+  bool started = macroEngine.startMacro(macroId, cmd.D2, cmd.T);
+  
+  if (started) {
+    JsonProtocol::sendOk(cmd.H);
+  } else {
+    JsonProtocol::sendFalse(cmd.H);
+  }
+  wdt_reset();
+}
+
+// N=211: Macro Cancel (MUST RESPOND)
+static void handleMacroCancel(const ParsedCommand& cmd) {
+  wdt_reset();
+  selfTestAbort();
+  macroEngine.cancel();
+  JsonProtocol::sendOk(cmd.H);
+  wdt_reset();
+}
+
+// N=999: Direct Motor Test (bypasses motion controller)
+// D1: left PWM (-255..255)
+// D2: right PWM (-255..255)
+// DIRECT MODE - single owner model
+static void handleDirectMotor(const ParsedCommand& cmd) {
+  wdt_reset();
+  if (selfTestActive()) {
+    JsonProtocol::sendFalse(cmd.H);  // Self-test owns the motors; N=201 aborts it
+    return;
+  }
+  g_lastOwner = 'D';  // Track direct mode for diagnostics
+  
+  // Set motion controller to DIRECT mode so update loop doesn't interfere
+  motionController.setDirectMode();
+  macroEngine.cancel();  // Safe: no longer touches motor pins
+  
+  // Apply PWM directly to pins using TB6612FNG direction logic
+  int16_t left = constrain(cmd.D1, -255, 255);
+  int16_t right = constrain(cmd.D2, -255, 255);
+  
+#if SAFETY_LAYER_ENABLED && !SAFETY_LAYER_BYPASS_DIRECT
+  // Apply safety layer limits (battery-aware cap, ramping, deadband)
+  driveSafety.applyLimits(&left, &right);
+#endif
+  
+  // CRITICAL: Enable motor driver (TB6612FNG requires STBY=HIGH)
+  FastPin<PIN_MOTOR_STBY>::high();
+  
+  // TB6612FNG Direction Logic (from official ELEGOO code V1_20230201):
+  // Motor A (Right): Forward = AIN_1 HIGH, Reverse = AIN_1 LOW
+  // Motor B (Left):  Forward = BIN_1 HIGH, Reverse = BIN_1 LOW
+  
+  // Right motor (Motor A: PWMA=5, AIN_1=7)
+  if (right > 0) {
+    FastPin<PIN_MOTOR_AIN_1>::high();  // Forward (TB6612: HIGH)
+    FastPwm<PIN_MOTOR_PWMA>::write(right);
+  } else if (right < 0) {
+    FastPin<PIN_MOTOR_AIN_1>::low();   // Reverse (TB6612: LOW)
+    FastPwm<PIN_MOTOR_PWMA>::write(-right);
+  } else {
+    FastPwm<PIN_MOTOR_PWMA>::write(0);
+  }
+  
+  // Left motor (Motor B: PWMB=6, BIN_1=8)
+  if (left > 0) {
+    FastPin<PIN_MOTOR_BIN_1>::high();  // Forward (TB6612: HIGH)
+    FastPwm<PIN_MOTOR_PWMB>::write(left);
+  } else if (left < 0) {
+    FastPin<PIN_MOTOR_BIN_1>::low();   // Reverse (TB6612: LOW)
+    FastPwm<PIN_MOTOR_PWMB>::write(-left);
+  } else {
+    FastPwm<PIN_MOTOR_PWMB>::write(0);
+  }
+  
+  // Store values for diagnostics (after safety layer applied)
+  directLeftPWM = left;
+  directRightPWM = right;
+  
+  JsonProtocol::sendOk(cmd.H);
+  wdt_reset();
+}
+
+// Remaining legacy ELEGOO commands (N=1-199 not in the table)
+void handleLegacyCommand(const ParsedCommand& cmd) {
+  wdt_reset();
+  
+  // Commands 2 and 7 have delayed response in official firmware
+  // (they respond after timer expires)
+  if (cmd.N == 2 || cmd.N == 7) {
+    return;
+  }
+  
+  // All other legacy commands respond with {H_ok}
+  if (strlen(cmd.H) > 0) {
+    JsonProtocol::sendOk(cmd.H);
+  } else {
+    JsonProtocol::sendOk();
+  }
+}
+
+// Dispatch table - MUST stay sorted by N (static_assert below).
+// maxRateHz: 0 = unlimited; N=201 must never be limited.
+static constexpr CommandEntry COMMAND_TABLE[] PROGMEM = {
+  //  N    handler              flags                                    maxRateHz
+  {   0,   handleHello,         CMD_ACK | CMD_CLASS_DIAG,                0 },
+  {   5,   handleServo,         CMD_ACK | CMD_CLASS_SENSOR,              20 },
+  {  21,   handleUltrasonic,    CMD_ACK | CMD_CLASS_SENSOR,              20 },
+  {  22,   handleLineSensor,    CMD_ACK | CMD_CLASS_SENSOR,              20 },
+  {  23,   handleBattery,       CMD_ACK | CMD_CLASS_SENSOR,              10 },
+  { 100,   handleLegacyStop,    CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 0 },
+  { 110,   handleLegacyStop,    CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 0 },
+  { 120,   handleDiagnostics,   CMD_ACK | CMD_CLASS_DIAG,                5 },
+  { 121,   handleStackProfile,  CMD_ACK | CMD_CLASS_DIAG,                2 },
+  { 122,   handleTraceDump,     CMD_ACK | CMD_CLASS_DIAG,                2 },
+  { 123,   handleTimeProbe,     CMD_ACK | CMD_CLASS_DIAG,                20 },
+  { 124,   handleLinkBaud,      CMD_ACK | CMD_CLASS_CONFIG,              1 },
+  { 125,   handleBlackBox,      CMD_ACK | CMD_CLASS_DIAG,                2 },
+  { 130,   handleInitRerun,     CMD_ACK | CMD_MOTION | CMD_CLASS_CONFIG, 1 },
+  { 140,   handleDriveConfig,   CMD_ACK | CMD_CLASS_CONFIG,              10 },
+  { 150,   handleRangeScan,     CMD_ACK | CMD_CLASS_SENSOR,              1 },
+  { 200,   handleSetpoint,      CMD_MOTION | CMD_CLASS_MOTION,           50 },
+  { 201,   handleStopNow,       CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 0 },
+  { 210,   handleMacroStart,    CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 2 },
+  { 211,   handleMacroCancel,   CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 0 },
+  { 999,   handleDirectMotor,   CMD_ACK | CMD_MOTION | CMD_CLASS_MOTION, 50 },
+};
+
+static_assert(commandTableSorted(COMMAND_TABLE, sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0])),
+              "COMMAND_TABLE must be sorted by N with no duplicates");
+
+const CommandEntry* commandLookup(int16_t n) {
+  return commandTableFind(COMMAND_TABLE, n);
 }
 
 void setup() {
   g_resetCounter++;  // Track resets for debugging
+  blackBox.boot();   // Freeze the previous run's records if it ended in a fault
   
   // Initialize serial communication
   // NOTE: Using 115200 (not official 9600) for better motion control throughput
   Serial.begin(SERIAL_BAUD);
   
+  // Start background ADC sampling first so sensor init reads cached values
+  adcSampler.start();
+  
   // Initialize hardware
   motorDriver.init();
+  runFastPinBenchmark();  // No-op unless FAST_PIN_BENCHMARK (STBY is still LOW)
+#if TRACE_ENABLED
+  traceHist.init();  // Timer1 free-running /8 (before Servo takes it)
+#endif
   batteryMonitor.init();
   servoPan.init();  // Uses exact ELEGOO pattern with attach/delay/detach
   ultrasonic.init();
@@ -697,6 +1173,8 @@ void setup() {
   macroEngine.init(&motorDriver);
   safetyLayer.init();
   driveSafety.init();
+  collisionReflex.init();
+  rangeScanner.init(&servoPan, &ultrasonic);
   initSequence.init();
   
   // Initialize scheduler
@@ -707,6 +1185,7 @@ void setup() {
   scheduler.registerTask(task_sensors_fast, 1000 / TASK_SENSORS_FAST_HZ, "sens_f");
   scheduler.registerTask(task_sensors_slow, 1000 / TASK_SENSORS_SLOW_HZ, "sens_s");
   scheduler.registerTask(task_protocol_rx, 1, "rx");
+  scheduler.registerTask(task_setpoint_ack, 1000 / TASK_SETPOINT_ACK_HZ, "ack");
   
   // Enable watchdog (8 seconds)
   wdt_enable(WDTO_8S);
@@ -714,6 +1193,9 @@ void setup() {
   
   // Start init sequence (runs in task_control_loop, non-blocking)
   initSequence.start();
+#if SELF_TEST_ENABLED
+  selfTestStart();  // Runs once the init sequence is done
+#endif
   
   // Send ready marker: "R\n"
   // Host waits for this after DTR reset
@@ -734,6 +1216,9 @@ void loop() {
   // Run scheduler
   scheduler.run();
   
+  // Range scan runs outside the scheduler for 1ms step resolution
+  rangeScanner.update();
+  
   // DISABLED: LED animations use too much stack
   // statusLED.update();
   
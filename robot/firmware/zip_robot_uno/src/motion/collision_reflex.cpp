@@ -0,0 +1,139 @@
+/*
+ * Collision Reflex Implementation
+ *
+ * TTC = (predicted distance - stop margin) / closing speed, where closing
+ * speed is the larger of the commanded-speed model and the filtered
+ * measured approach rate (covers moving obstacles). Distance is dead-
+ * reckoned forward from the last echo since samples only arrive at 10Hz.
+ */
+
+#include "../../include/motion/collision_reflex.h"
+
+// Global instance
+CollisionReflex collisionReflex;
+
+CollisionReflex::CollisionReflex()
+  : brakeTtcMs(REFLEX_TTC_BRAKE_MS_DEFAULT)
+  , lastDistance(0)
+  , lastSampleMs(0)
+  , closingCmS(0)
+  , lastInstCmS(0)
+  , interventions(0)
+  , brakeEvents(0)
+  , lastTtcMs(0xFFFF)
+  , braking(false)
+{
+}
+
+void CollisionReflex::init() {
+  brakeTtcMs = REFLEX_TTC_BRAKE_MS_DEFAULT;
+  lastDistance = 0;
+  lastSampleMs = 0;
+  closingCmS = 0;
+  lastInstCmS = 0;
+  interventions = 0;
+  brakeEvents = 0;
+  lastTtcMs = 0xFFFF;
+  braking = false;
+}
+
+void CollisionReflex::updateDistance(uint16_t distance_cm, unsigned long sample_ms) {
+  // Same sample seen twice (cached getDistance) - nothing new
+  if (sample_ms == lastSampleMs) {
+    return;
+  }
+
+  if (distance_cm == 0) {
+    // No echo - treat as clear and drop velocity history
+    lastDistance = 0;
+    closingCmS = 0;
+    lastInstCmS = 0;
+    lastSampleMs = sample_ms;
+    return;
+  }
+
+  unsigned long dt = sample_ms - lastSampleMs;
+  if (lastDistance > 0 && dt > 0 && dt <= REFLEX_SAMPLE_MAX_AGE_MS) {
+    int32_t inst = ((int32_t)lastDistance - (int32_t)distance_cm) * 1000L / (int32_t)dt;
+    inst = constrain(inst, -500, 500);
+    // One jumpy echo (multipath, a hand through the beam) is not an
+    // approach: filter the slower of the last two rates, so the measured
+    // speed only rises once two consecutive deltas agree
+    int16_t rate = (int16_t)min(inst, (int32_t)lastInstCmS);
+    lastInstCmS = (int16_t)inst;
+    // EWMA alpha=0.5 - HC-SR04 jitter is ~1cm, which is 10cm/s at 10Hz
+    closingCmS = (int16_t)((closingCmS + rate) / 2);
+  } else {
+    closingCmS = 0;
+    lastInstCmS = 0;
+  }
+
+  lastDistance = distance_cm;
+  lastSampleMs = sample_ms;
+}
+
+int16_t CollisionReflex::limitForward(int16_t v) {
+#if COLLISION_REFLEX_ENABLED
+  if (brakeTtcMs == 0 || v <= 0) {
+    braking = false;
+    return v;
+  }
+
+  unsigned long now = millis();
+  unsigned long age = now - lastSampleMs;
+  if (lastDistance == 0 || age > REFLEX_SAMPLE_MAX_AGE_MS) {
+    braking = false;
+    lastTtcMs = 0xFFFF;
+    return v;
+  }
+
+  int16_t commandedCmS = (int16_t)(((int32_t)v * REFLEX_CM_S_PER_PWM_X100) / 100);
+  int16_t closing = max(commandedCmS, closingCmS);
+  if (closing <= 0) {
+    braking = false;
+    lastTtcMs = 0xFFFF;
+    return v;
+  }
+
+  // Dead-reckon distance to now
+  int32_t predicted = (int32_t)lastDistance - ((int32_t)closing * (int32_t)age) / 1000L;
+  int32_t margin = predicted - REFLEX_STOP_DISTANCE_CM;
+  uint32_t ttc = (margin <= 0) ? 0 : ((uint32_t)margin * 1000UL) / (uint32_t)closing;
+  lastTtcMs = (ttc > 0xFFFF) ? 0xFFFF : (uint16_t)ttc;
+
+  int16_t out = v;
+  if (ttc < brakeTtcMs) {
+    out = 0;
+    if (!braking) {
+      braking = true;
+      brakeEvents++;
+      emitEvent(lastDistance, lastTtcMs);
+    }
+  } else {
+    braking = false;
+    if (ttc < 2UL * brakeTtcMs) {
+      // Linear taper from full v at 2x brake TTC to 0 at brake TTC
+      out = (int16_t)(((int32_t)v * (int32_t)(ttc - brakeTtcMs)) / (int32_t)brakeTtcMs);
+    }
+  }
+
+  if (out < v) {
+    interventions++;
+  }
+  return out;
+#else
+  return v;
+#endif
+}
+
+void CollisionReflex::emitEvent(uint16_t distance_cm, uint16_t ttc_ms) {
+  // Format: {reflex:d=<cm>,ttc=<ms>}
+  // Best effort - dropped if TX buffer is busy (counters still record it)
+  if (Serial.availableForWrite() >= 24) {
+    Serial.print(F("{reflex:d="));
+    Serial.print(distance_cm);
+    Serial.print(F(",ttc="));
+    Serial.print(ttc_ms);
+    Serial.println('}');
+  }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "../../include/motion/drive_safety_layer.h"
+#include "../../include/core/trace.h"
 
 // Global instance
 DriveSafetyLayer driveSafety;
@@ -19,16 +20,26 @@ DriveSafetyLayer::DriveSafetyLayer()
   , kickLeftEndTick(0)
   , kickRightEndTick(0)
   , tickCounter(0)
+  , kickTicks(KICKSTART_DURATION_TICKS)
   , accelStepOverride(0)
   , decelStepOverride(0)
   , maxPwmOverride(0)
   , kickEnabledOverride(0xFF)
+  , ffMeanX(0)
+  , ffMeanV(0)
+  , ffVarX(0)
+  , ffCovXV(0)
+  , ffVocMv(0)
+  , ffSagMv(0)
+  , ffNominalMv(BATT_FF_NOMINAL_MV)
+  , ffGainQ8(256)
 #if STALL_DETECT_ENABLED
   , stallSuspected(false)
   , highPwmStartTick(0)
   , lastBatteryMv(7400)
 #endif
 {
+  memset(&limitStats, 0, sizeof(limitStats));
 }
 
 void DriveSafetyLayer::init() {
@@ -40,10 +51,20 @@ void DriveSafetyLayer::init() {
   kickLeftEndTick = 0;
   kickRightEndTick = 0;
   tickCounter = 0;
+  kickTicks = KICKSTART_DURATION_TICKS;
   accelStepOverride = 0;
   decelStepOverride = 0;
   maxPwmOverride = 0;
   kickEnabledOverride = 0xFF;
+  ffMeanX = 0;
+  ffMeanV = 0;
+  ffVarX = 0;
+  ffCovXV = 0;
+  ffVocMv = 0;
+  ffSagMv = 0;
+  ffNominalMv = BATT_FF_NOMINAL_MV;
+  ffGainQ8 = 256;
+  resetLimitStats();
   
 #if STALL_DETECT_ENABLED
   stallSuspected = false;
@@ -65,6 +86,69 @@ void DriveSafetyLayer::updateBatteryState(uint16_t voltage_mv) {
   } else {
     batteryState = BATT_CRIT;
   }
+  
+#if BATT_FF_ENABLED
+  updateSagEstimate(voltage_mv);
+#endif
+}
+
+void DriveSafetyLayer::updateSagEstimate(uint16_t voltage_mv) {
+  // Load while the sample was taken: duty last applied to both wheels
+  float x = (abs(currentLimitedL) + abs(currentLimitedR)) / 510.0f;
+  float v = voltage_mv;
+  
+  if (ffVocMv == 0) {
+    // First sample seeds the means
+    ffMeanX = x;
+    ffMeanV = v;
+    ffVarX = 0;
+    ffCovXV = 0;
+  } else {
+    float dx = x - ffMeanX;
+    float dv = v - ffMeanV;
+    ffMeanX += BATT_FF_ALPHA * dx;
+    ffMeanV += BATT_FF_ALPHA * dv;
+    ffVarX = (1.0f - BATT_FF_ALPHA) * (ffVarX + BATT_FF_ALPHA * dx * dx);
+    ffCovXV = (1.0f - BATT_FF_ALPHA) * (ffCovXV + BATT_FF_ALPHA * dx * dv);
+  }
+  
+  // Slope only when the load actually varied lately (spread > ~0.05 duty);
+  // otherwise keep the last sag and let the mean carry Voc
+  if (ffVarX > 0.0025f) {
+    float sag = -ffCovXV / ffVarX;
+    if (sag <= 0) {
+      ffSagMv = 0;
+    } else if (sag >= BATT_FF_SAG_MAX_MV) {
+      ffSagMv = BATT_FF_SAG_MAX_MV;
+    } else {
+      ffSagMv = (uint16_t)sag;
+    }
+  }
+  
+  float voc = ffMeanV + ffSagMv * ffMeanX;
+  ffVocMv = (voc < 1) ? 1 : (uint16_t)voc;  // Stays non-zero once seeded
+}
+
+uint16_t DriveSafetyLayer::feedforwardGain(uint16_t loadPwm) const {
+  if (ffNominalMv == 0 || ffVocMv < BATT_FF_MIN_MV) {
+    return 256;
+  }
+  
+  // Loaded voltage expected at the commanded duty
+  int32_t vPred = (int32_t)ffVocMv - (int32_t)(((uint32_t)ffSagMv * loadPwm) / 510);
+  if (vPred < BATT_FF_MIN_MV) {
+    vPred = BATT_FF_MIN_MV;
+  }
+  
+  uint32_t gain = ((uint32_t)ffNominalMv << 8) / (uint32_t)vPred;
+  const uint32_t gainMin = (BATT_FF_GAIN_MIN_PCT * 256UL) / 100;
+  const uint32_t gainMax = (BATT_FF_GAIN_MAX_PCT * 256UL) / 100;
+  if (gain < gainMin) {
+    gain = gainMin;
+  } else if (gain > gainMax) {
+    gain = gainMax;
+  }
+  return (uint16_t)gain;
 }
 
 uint8_t DriveSafetyLayer::getEffectiveAccelStep() const {
@@ -120,6 +204,10 @@ bool DriveSafetyLayer::isKickEnabled() const {
 #endif
 }
 
+void DriveSafetyLayer::resetLimitStats() {
+  memset(&limitStats, 0, sizeof(limitStats));
+}
+
 void DriveSafetyLayer::resetSlew() {
   currentLimitedL = 0;
   currentLimitedR = 0;
@@ -132,6 +220,7 @@ void DriveSafetyLayer::applyLimits(int16_t* left, int16_t* right) {
   // Safety layer disabled - pass through unchanged
   return;
 #endif
+  TRACE_SCOPE(TRACE_SAFETY_LIMITS);
 
   // Increment tick counter (wraps at 255)
   tickCounter++;
@@ -144,26 +233,105 @@ void DriveSafetyLayer::applyLimits(int16_t* left, int16_t* right) {
   // Store targets before modification
   int16_t targetL = *left;
   int16_t targetR = *right;
+#if SAFETY_STATS_ENABLED
+  int16_t stageL, stageR;  // Previous stage's output, for the counters
+  limitStats.calls++;
+#endif
+  
+#if BATT_FF_ENABLED
+  // Step 0: Battery sag feedforward (nominal-voltage equivalent duty)
+  ffGainQ8 = feedforwardGain(abs(targetL) + abs(targetR));
+  targetL = (int16_t)(((int32_t)targetL * ffGainQ8) / 256);
+  targetR = (int16_t)(((int32_t)targetR * ffGainQ8) / 256);
+#if SAFETY_STATS_ENABLED
+  if (targetL != *left || targetR != *right) {
+    limitStats.feedforward++;
+  }
+#endif
+#endif
   
   // Step 1: Apply PWM cap
+#if SAFETY_STATS_ENABLED
+  stageL = targetL;
+  stageR = targetR;
+#endif
   targetL = applyCap(targetL, maxPwm);
   targetR = applyCap(targetR, maxPwm);
+#if SAFETY_STATS_ENABLED
+  if (targetL != stageL || targetR != stageR) {
+    limitStats.cap++;
+  }
+#endif
   
   // Step 2: Apply slew rate limiting
   int16_t limitedL = applySlewLimit(currentLimitedL, targetL, accelStep, decelStep);
   int16_t limitedR = applySlewLimit(currentLimitedR, targetR, accelStep, decelStep);
+#if SAFETY_STATS_ENABLED
+  {
+    uint16_t gapL = abs(targetL - limitedL);
+    uint16_t gapR = abs(targetR - limitedR);
+    uint16_t gap = (gapL > gapR) ? gapL : gapR;
+    limitStats.gapPwm = (gap > 255) ? 255 : (uint8_t)gap;
+    if (gap > 0) {
+      limitStats.slew++;
+      if (limitStats.lagRunCalls < 255) {
+        limitStats.lagRunCalls++;
+      }
+    } else if (limitStats.lagRunCalls > 0) {
+      // Output reached the target: close the run
+      limitStats.lagLastCalls = limitStats.lagRunCalls;
+      if (limitStats.lagRunCalls > limitStats.lagPeakCalls) {
+        limitStats.lagPeakCalls = limitStats.lagRunCalls;
+      }
+      limitStats.lagRunCalls = 0;
+    }
+  }
+#endif
   
   // Step 3: Apply kickstart if enabled (before deadband, after slew)
 #if KICKSTART_ENABLED
   if (isKickEnabled()) {
+#if SAFETY_STATS_ENABLED
+    stageL = limitedL;
+    stageR = limitedR;
+#endif
     limitedL = applyKickstart(limitedL, currentLimitedL, deadbandL, &kickLeftEndTick);
     limitedR = applyKickstart(limitedR, currentLimitedR, deadbandR, &kickRightEndTick);
+#if SAFETY_STATS_ENABLED
+    if (limitedL != stageL || limitedR != stageR) {
+      limitStats.kick++;
+    }
+#endif
   }
 #endif
+#if SAFETY_STATS_ENABLED
+  stageL = limitedL;
+  stageR = limitedR;
+#endif
   
   // Step 4: Apply deadband compensation
+  // A ramp-down that lands inside the deadband snaps to its target. Bumping
+  // it back up would feed the bumped value into the next slew step and latch
+  // the wheel at the deadband PWM (e.g. 55 -> 35 -> 55 ...), never stopping.
+  // A reversal latches the same way on its way through zero, so it snaps to
+  // 0 and ramps up from rest in the new direction on the next tick.
+  if (abs(limitedL) < deadbandL && abs(targetL) < abs(limitedL)) {
+    limitedL = targetL;
+  } else if (abs(limitedL) < deadbandL && (int32_t)targetL * limitedL < 0) {
+    limitedL = 0;
+  }
+  if (abs(limitedR) < deadbandR && abs(targetR) < abs(limitedR)) {
+    limitedR = targetR;
+  } else if (abs(limitedR) < deadbandR && (int32_t)targetR * limitedR < 0) {
+    limitedR = 0;
+  }
   limitedL = applyDeadband(limitedL, deadbandL);
   limitedR = applyDeadband(limitedR, deadbandR);
+#if SAFETY_STATS_ENABLED
+  if (limitedL != stageL || limitedR != stageR) {
+    limitStats.deadband++;
+  }
+#endif
   
   // Update tracked current values
   currentLimitedL = limitedL;
@@ -246,8 +414,8 @@ int16_t DriveSafetyLayer::applyKickstart(int16_t pwm, int16_t currentPwm,
   // Check if kickstart is currently active
   if (*kickEndTick != 0) {
     // Check if kick period has ended (handle wraparound)
-    uint8_t elapsed = tickCounter - *kickEndTick + KICKSTART_DURATION_TICKS;
-    if (elapsed >= KICKSTART_DURATION_TICKS) {
+    uint8_t elapsed = tickCounter - *kickEndTick + kickTicks;
+    if (elapsed >= kickTicks) {
       // Kick period ended
       *kickEndTick = 0;
     } else {
@@ -265,7 +433,7 @@ int16_t DriveSafetyLayer::applyKickstart(int16_t pwm, int16_t currentPwm,
   // Trigger: transitioning from 0 to non-zero
   if (currentPwm == 0 && pwm != 0 && *kickEndTick == 0) {
     // Start kickstart
-    *kickEndTick = tickCounter + KICKSTART_DURATION_TICKS;
+    *kickEndTick = tickCounter + kickTicks;
     
     // Apply boosted PWM
     int16_t kickPwm = deadband + KICKSTART_BOOST;
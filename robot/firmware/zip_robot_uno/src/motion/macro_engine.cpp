@@ -4,6 +4,7 @@
 
 #include "macro_engine.h"
 #include "../../include/motion/drive_safety_layer.h"
+#include "../../include/motion/collision_reflex.h"
 
 // FIGURE_8 macro steps (using official ELEGOO obstacle avoidance speed ~150)
 const MacroEngine::MacroStep MacroEngine::figure8_steps[] = {
@@ -146,8 +147,10 @@ void MacroEngine::update() {
   
   // Apply current step target to motors with differential mixing
   // Official ELEGOO pattern: left = v - w, right = v + w
-  int16_t left = state.targetV - state.targetW;
-  int16_t right = state.targetV + state.targetW;
+  // Forward v goes through the TTC reflex like N=200 setpoints
+  int16_t v = collisionReflex.limitForward(state.targetV);
+  int16_t left = v - state.targetW;
+  int16_t right = v + state.targetW;
   left = constrain(left, -255, 255);
   right = constrain(right, -255, 255);
   
@@ -3,7 +3,9 @@
  */
 
 #include "motion_controller.h"
+#include "../../include/config.h"
 #include "../../include/motion/drive_safety_layer.h"
+#include "../../include/motion/collision_reflex.h"
 
 // Official ELEGOO differential mixing constant
 const float MotionController::DIFF_MIX_K = 1.0f;  // k in left = v - k*w, right = v + k*w
@@ -21,6 +23,8 @@ MotionController::MotionController()
   currentSetpoint.w = 0;
   currentSetpoint.ttl_ms = 0;
   currentSetpoint.timestamp = 0;
+  memset(&seqStats, 0, sizeof(seqStats));
+  memset(&arrival, 0, sizeof(arrival));
 }
 
 void MotionController::init(MotorDriverTB6612* motor) {
@@ -41,32 +45,15 @@ void MotionController::setSetpoint(int16_t v, int16_t w, uint32_t ttl_ms) {
   
   uint32_t now = millis();
   
-  // TTL Extension Logic: When motion is already active, extend TTL instead of resetting
-  // This ensures continuous motion when streaming commands
-  if (state == MOTION_STATE_SETPOINT && motorDriver && currentSetpoint.timestamp > 0) {
-    // Motion already active - extend TTL window
-    // Check timestamp > 0 to avoid issues with uninitialized timestamp
-    uint32_t elapsed = now - currentSetpoint.timestamp;
-    // Handle millis() wraparound: if now < timestamp, wraparound occurred
-    if (elapsed < currentSetpoint.ttl_ms && now >= currentSetpoint.timestamp) {
-      // TTL hasn't expired - calculate remaining time and extend
-      uint32_t remaining = currentSetpoint.ttl_ms - elapsed;
-      // Extend: new expiration = current expiration + new_ttl
-      // Current expiration = timestamp + ttl_ms = now - elapsed + ttl_ms = now + remaining
-      // New expiration = now + remaining + new_ttl
-      // So: new_timestamp = now, new_ttl = remaining + new_ttl
-      currentSetpoint.timestamp = now;
-      currentSetpoint.ttl_ms = remaining + ttl_ms;
-    } else {
-      // TTL already expired or wraparound - reset to new command
-      currentSetpoint.timestamp = now;
-      currentSetpoint.ttl_ms = ttl_ms;
-    }
-  } else {
-    // New motion or idle - reset timestamp
-    currentSetpoint.timestamp = now;
-    currentSetpoint.ttl_ms = ttl_ms;
-  }
+#if MOTION_TTL_ADAPTIVE
+  // Streamed setpoints get a TTL sized from the measured arrival period
+  ttl_ms = streamTtl(now, ttl_ms);
+#endif
+  
+  // Every setpoint restarts the window from now. TTLs never add up, so a
+  // stalled host stops the robot within one TTL however fast it streamed.
+  currentSetpoint.timestamp = now;
+  currentSetpoint.ttl_ms = ttl_ms;
   
   // Update setpoint values
   currentSetpoint.v = v;
@@ -81,7 +68,12 @@ void MotionController::setSetpoint(int16_t v, int16_t w, uint32_t ttl_ms) {
     // Official Elegoo pattern: Apply PWM immediately (matching DeviceDriverSet_Motor_control)
     // Don't wait for update() loop - apply immediately like official code
     int16_t targetLeft, targetRight;
+#if COLLISION_REFLEX_ENABLED
+    // TTC reflex may cap/zero forward v (reverse and rotation pass through)
+    applyDifferentialMix(collisionReflex.limitForward(v), w, targetLeft, targetRight);
+#else
     applyDifferentialMix(v, w, targetLeft, targetRight);
+#endif
     
 #if SAFETY_LAYER_ENABLED
     // Apply safety layer limits (battery-aware cap, ramping, deadband, kickstart)
@@ -97,19 +89,83 @@ void MotionController::setSetpoint(int16_t v, int16_t w, uint32_t ttl_ms) {
   }
 }
 
+SetpointAdmit MotionController::admitSetpoint(uint16_t seq, uint16_t sentMs, uint32_t ttl_ms) {
+  if (seq == 0) {
+    return SETPOINT_ADMIT_OK;
+  }
+  
+  uint32_t now = millis();
+  bool resync = (seqStats.lastSeq == 0) || (now - seqStats.lastRxMs >= MOTION_SEQ_RESYNC_MS);
+  seqStats.lastRxMs = now;
+  
+  // Age from the host's send stamp (15-bit wrap); stamps "in the future"
+  // are clock-sync error and count as fresh
+  if (sentMs != 0) {
+    uint16_t age = (uint16_t)((uint16_t)now - sentMs) & 0x7FFF;
+    if (age < 0x4000 && age > constrain(ttl_ms, 150, 10000)) {
+      seqStats.stale++;
+      return SETPOINT_ADMIT_STALE;
+    }
+  }
+  
+  // Serial-number compare in 15 bits: newer if 1..16383 ahead. After a gap
+  // (host restart, idle) any seq resynchronizes the window.
+  uint16_t ahead = (uint16_t)(seq - seqStats.lastSeq) & 0x7FFF;
+  if (!resync && (ahead == 0 || ahead >= 0x4000)) {
+    seqStats.reordered++;
+    return SETPOINT_ADMIT_REORDERED;
+  }
+  
+  seqStats.lastSeq = seq;
+  seqStats.applied++;
+  return SETPOINT_ADMIT_OK;
+}
+
+uint32_t MotionController::streamTtl(uint32_t now, uint32_t ttl_ms) {
+  uint32_t gap = now - arrival.lastMs;
+  bool streaming = (arrival.lastMs != 0) && (gap < MOTION_TTL_STREAM_GAP_MS);
+  arrival.lastMs = now;
+  
+  if (!streaming) {
+    // First frame, single command or a pause: the host's T as given
+    arrival.samples = 0;
+  } else if (arrival.samples == 0) {
+    // First gap seeds the estimate, jitter at half the period (RFC 6298)
+    arrival.meanX8 = (uint16_t)(gap << 3);
+    arrival.jitterX4 = (uint16_t)(gap << 1);
+    arrival.samples = 1;
+  } else {
+    // mean += (gap - mean) / 8; jitter += (|gap - mean| - jitter) / 4
+    int16_t err = (int16_t)gap - (int16_t)(arrival.meanX8 >> 3);
+    arrival.meanX8 += err;
+    arrival.jitterX4 += (uint16_t)(err < 0 ? -err : err) - (arrival.jitterX4 >> 2);
+    if (arrival.samples < 255) {
+      arrival.samples++;
+    }
+  }
+  
+  if (arrival.samples >= MOTION_TTL_MIN_SAMPLES) {
+    uint32_t adaptive = (uint32_t)MOTION_TTL_PERIOD_MULT * (arrival.meanX8 >> 3) +
+                        (uint32_t)MOTION_TTL_JITTER_MULT * (arrival.jitterX4 >> 2);
+    ttl_ms = constrain(adaptive, (uint32_t)150, (uint32_t)MOTION_TTL_STREAM_CAP_MS);
+  }
+  arrival.ttlMs = (uint16_t)ttl_ms;
+  return ttl_ms;
+}
+
 void MotionController::update() {
   if (state != MOTION_STATE_SETPOINT || !motorDriver) {
     return;
   }
   
-  // Check TTL expiration
-  // Note: With TTL extension logic, when new setpoints arrive during active motion,
-  // the timestamp and TTL are adjusted to extend the expiration window.
-  // This ensures continuous motion when streaming commands.
+  // Check TTL expiration. Each setpoint restarts the window from its arrival
+  // with the TTL from streamTtl(); nothing extends it in between.
   uint32_t elapsed = millis() - currentSetpoint.timestamp;
   if (elapsed >= currentSetpoint.ttl_ms) {
-    // TTL expired - stop
+    // TTL expired - stop. stop() only clears state, so zero the pins here too:
+    // no later update() runs in IDLE and the last PWM would otherwise persist.
     stop();
+    motorDriver->stop();
     return;
   }
   
@@ -117,7 +173,11 @@ void MotionController::update() {
   // (Official code doesn't have update loop, but we need to maintain setpoint until TTL expires)
   // Recalculate targets (in case setpoint changed)
   int16_t targetLeft, targetRight;
+#if COLLISION_REFLEX_ENABLED
+  applyDifferentialMix(collisionReflex.limitForward(currentSetpoint.v), currentSetpoint.w, targetLeft, targetRight);
+#else
   applyDifferentialMix(currentSetpoint.v, currentSetpoint.w, targetLeft, targetRight);
+#endif
   
 #if SAFETY_LAYER_ENABLED
   // Apply safety layer limits (battery-aware cap, ramping, deadband, kickstart)
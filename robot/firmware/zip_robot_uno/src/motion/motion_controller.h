@@ -23,6 +23,16 @@ public:
   // ttl_ms: time-to-live in milliseconds
   void setSetpoint(int16_t v, int16_t w, uint32_t ttl_ms);
   
+  // Admission check for sequenced setpoints, before setSetpoint().
+  // seq: 1..32767, 0 = unsequenced (always admitted)
+  // sentMs: host send time in UNO millis(), low 15 bits, 0 = not given
+  SetpointAdmit admitSetpoint(uint16_t seq, uint16_t sentMs, uint32_t ttl_ms);
+  
+  const SetpointSeqStats& getSeqStats() const { return seqStats; }
+  
+  // Inter-arrival estimate behind the adaptive setpoint TTL
+  const SetpointArrivalStats& getArrivalStats() const { return arrival; }
+  
   // Update motion controller (call from control loop at fixed cadence)
   void update();
   
@@ -41,10 +51,15 @@ public:
   // Get current setpoint
   void getCurrentSetpoint(int16_t& v, int16_t& w) const;
   
+  // Apply differential mixing: v,w → left,right (pure; public for native_bench)
+  static void applyDifferentialMix(int16_t v, int16_t w, int16_t& left, int16_t& right);
+  
 private:
   MotorDriverTB6612* motorDriver;
   MotionState state;
   SetpointCommand currentSetpoint;
+  SetpointSeqStats seqStats;
+  SetpointArrivalStats arrival;
   
   // Differential mixing constant (k in left = v - k*w, right = v + k*w)
   static const float DIFF_MIX_K;
@@ -56,11 +71,11 @@ private:
   int16_t currentLeft;
   int16_t currentRight;
   
-  // Apply differential mixing: v,w → left,right
-  void applyDifferentialMix(int16_t v, int16_t w, int16_t& left, int16_t& right);
-  
   // Apply slew limiting
   void applySlewLimit(int16_t& value, int16_t target);
+  
+  // Fold one arrival into the period estimate; returns the TTL to use
+  uint32_t streamTtl(uint32_t now, uint32_t ttl_ms);
 };
 
 #endif // MOTION_CONTROLLER_H
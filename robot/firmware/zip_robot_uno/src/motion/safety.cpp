@@ -3,63 +3,66 @@
  */
 
 #include "safety.h"
+#include <avr/pgmspace.h>
 
-const uint32_t SafetyLayer::MAX_COMMANDS_PER_SECOND;
-const uint32_t SafetyLayer::RATE_LIMIT_WINDOW_MS;
+// Indexed by class (CMD_CLASS_* >> CMD_CLASS_SHIFT)
+static const int16_t CLASS_BURST_MS[SAFETY_CLASS_COUNT] PROGMEM = {
+  SAFETY_BURST_MOTION_MS,
+  SAFETY_BURST_SENSOR_MS,
+  SAFETY_BURST_CONFIG_MS,
+  SAFETY_BURST_DIAG_MS,
+};
 
 SafetyLayer::SafetyLayer()
-  : commandIndex(0)
-  , commandCount(0)
+  : lastRefillMs(0)
   , motorsEnabled(false)  // Startup safe: motors disabled
 {
-  for (uint8_t i = 0; i < 10; i++) {
-    commandTimestamps[i] = 0;
-  }
+  init();
 }
 
 void SafetyLayer::init() {
-  commandIndex = 0;
-  commandCount = 0;
   motorsEnabled = false;  // Startup safe
+  lastRefillMs = millis();
   
-  for (uint8_t i = 0; i < 10; i++) {
-    commandTimestamps[i] = 0;
+  // Start full: commands sent right after boot are not refused
+  for (uint8_t i = 0; i < SAFETY_CLASS_COUNT; i++) {
+    creditMs[i] = (int16_t)pgm_read_word(&CLASS_BURST_MS[i]);
+    rejected[i] = 0;
   }
 }
 
-bool SafetyLayer::checkRateLimit() {
-  // Check if rate limit exceeded
-  if (isRateLimitExceeded()) {
-    return false;  // Reject command
-  }
-  
-  return true;  // Accept command
-}
-
-void SafetyLayer::recordCommand() {
+void SafetyLayer::refill() {
   uint32_t now = millis();
+  uint32_t elapsed = now - lastRefillMs;
+  lastRefillMs = now;
   
-  // Add timestamp to circular buffer
-  commandTimestamps[commandIndex] = now;
-  commandIndex = (commandIndex + 1) % 10;
-  
-  if (commandCount < 10) {
-    commandCount++;
+  // Anything beyond the largest burst fills every bucket anyway
+  if (elapsed > 0x7FFF) {
+    elapsed = 0x7FFF;
+  }
+  for (uint8_t i = 0; i < SAFETY_CLASS_COUNT; i++) {
+    int16_t burst = (int16_t)pgm_read_word(&CLASS_BURST_MS[i]);
+    int32_t credit = (int32_t)creditMs[i] + (int32_t)elapsed;
+    creditMs[i] = (credit > burst) ? burst : (int16_t)credit;
   }
 }
 
-bool SafetyLayer::isRateLimitExceeded() const {
-  uint32_t now = millis();
-  uint32_t windowStart = now - RATE_LIMIT_WINDOW_MS;
-  
-  // Count commands in the last second
-  uint8_t count = 0;
-  for (uint8_t i = 0; i < commandCount; i++) {
-    if (commandTimestamps[i] >= windowStart) {
-      count++;
-    }
+bool SafetyLayer::admit(uint8_t cmdClass, uint8_t maxRateHz) {
+  if (maxRateHz == 0) {
+    return true;  // Exempt (stops): no charge, never refused
   }
   
-  return count >= MAX_COMMANDS_PER_SECOND;
+  refill();
+  
+  int16_t cost = (int16_t)(1000 / maxRateHz);
+  int16_t burst = (int16_t)pgm_read_word(&CLASS_BURST_MS[cmdClass]);
+  if (cost > burst) {
+    cost = burst;
+  }
+  if (creditMs[cmdClass] < cost) {
+    rejected[cmdClass]++;
+    return false;
+  }
+  creditMs[cmdClass] -= cost;
+  return true;
 }
-
@@ -1,7 +1,20 @@
 /*
  * Safety Layer
  * 
- * Implements safety features: deadman stop, rate limiting, startup safe state
+ * Implements safety features: command admission control, startup safe state
+ *
+ * Admission control runs in front of dispatch with one token bucket per
+ * command class (motion, sensor, config, diagnostics - see CMD_CLASS_* in
+ * command_table.h). Credit is kept in milliseconds: it refills 1:1 with
+ * time up to the class burst, and a command costs 1000/maxRateHz from its
+ * COMMAND_TABLE row. Each class can therefore run its commands at their own
+ * maxRateHz (a mix of them shares the budget), and a flood of one class
+ * never starves another. maxRateHz = 0 rows (N=201, the legacy stops,
+ * N=211, hello) are never charged and never refused.
+ *
+ * A command never costs more than its class burst, so rare expensive rows
+ * (1Hz scans, macro starts) are limited by the burst instead and can never
+ * lock their class out for longer than one burst.
  */
 
 #ifndef SAFETY_H
@@ -9,18 +22,48 @@
 
 #include <Arduino.h>
 
+// ============================================================================
+// COMPILE-TIME CONFIGURATION FLAGS
+// ============================================================================
+
+// Enable/disable admission control (default: enabled)
+#ifndef SAFETY_ADMISSION_ENABLED
+#define SAFETY_ADMISSION_ENABLED 1
+#endif
+
+// Burst per class (ms of credit): how far ahead of its rate a class may run
+#ifndef SAFETY_BURST_MOTION_MS
+#define SAFETY_BURST_MOTION_MS  100   // 5 setpoints back to back at 50Hz
+#endif
+#ifndef SAFETY_BURST_SENSOR_MS
+#define SAFETY_BURST_SENSOR_MS  250
+#endif
+#ifndef SAFETY_BURST_CONFIG_MS
+#define SAFETY_BURST_CONFIG_MS  1000
+#endif
+#ifndef SAFETY_BURST_DIAG_MS
+#define SAFETY_BURST_DIAG_MS    1000
+#endif
+
+#define SAFETY_CLASS_COUNT 4
+
+// ============================================================================
+// SAFETY LAYER CLASS
+// ============================================================================
+
 class SafetyLayer {
 public:
   SafetyLayer();
   
   void init();
   
-  // Check if command should be accepted (rate limiting)
-  // Returns true if command should be processed
-  bool checkRateLimit();
+  // Admission check before dispatch. cmdClass: 0..SAFETY_CLASS_COUNT-1,
+  // maxRateHz: from the table row (0 = exempt). Returns false (and counts
+  // the rejection) when the class is out of credit.
+  bool admit(uint8_t cmdClass, uint8_t maxRateHz);
   
-  // Record command reception
-  void recordCommand();
+  // Commands refused per class since boot (free-running)
+  uint16_t getRejected(uint8_t cmdClass) const { return rejected[cmdClass]; }
   
   // Check if motors should be enabled (startup safe state)
   bool shouldEnableMotors() const { return motorsEnabled; }
@@ -32,20 +75,15 @@ public:
   void forceDisable() { motorsEnabled = false; }
   
 private:
-  // Rate limiting: max commands per second
-  static const uint32_t MAX_COMMANDS_PER_SECOND = 50;
-  static const uint32_t RATE_LIMIT_WINDOW_MS = 1000;
-  
-  uint32_t commandTimestamps[10];  // Circular buffer
-  uint8_t commandIndex;
-  uint8_t commandCount;
+  int16_t creditMs[SAFETY_CLASS_COUNT];
+  uint16_t rejected[SAFETY_CLASS_COUNT];
+  uint32_t lastRefillMs;
   
   // Startup safe state
   bool motorsEnabled;
   
-  // Check if rate limit exceeded
-  bool isRateLimitExceeded() const;
+  // Add the time since the last call to every bucket
+  void refill();
 };
 
 #endif // SAFETY_H
-
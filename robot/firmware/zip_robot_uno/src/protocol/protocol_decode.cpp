@@ -8,6 +8,7 @@
 
 ProtocolDecoder::ProtocolDecoder()
   : state(STATE_WAIT_HEADER_0)
+  , buffer(nullptr)
   , bufferPos(0)
   , expectedLen(0)
   , expectedPayloadLen(0)
@@ -25,6 +26,11 @@ bool ProtocolDecoder::processByte(uint8_t byte) {
       reset();
     }
     // Now handle the 0xAA byte (we're in WAIT_HEADER_0 state after reset)
+    RamOverlayStorage* arena = ramOverlay.acquire(OVERLAY_BINARY_RX);
+    if (!arena) {
+      return false;  // A JSON frame holds the arena
+    }
+    buffer = arena->binaryFrame;
     buffer[0] = byte;
     bufferPos = 1;
     state = STATE_WAIT_HEADER_1;
@@ -119,6 +125,8 @@ bool ProtocolDecoder::processByte(uint8_t byte) {
       // Validate frame
       if (validateFrame()) {
         message.valid = true;
+        ramOverlay.release(OVERLAY_BINARY_RX);  // Payload is in message
+        buffer = nullptr;
         //         // Serial.print(F("[DEC] Frame valid! type=0x"));
         // Serial.print(message.type, HEX);
         // Serial.print(F(", seq="));
@@ -134,7 +142,7 @@ bool ProtocolDecoder::processByte(uint8_t byte) {
   }
   
   // Check for buffer overflow
-  if (bufferPos >= sizeof(buffer)) {
+  if (bufferPos >= OVERLAY_BINARY_FRAME_MAX) {
     // Serial.println(F("[DEC] Buffer overflow!"));
     reset();
     return false;
@@ -193,6 +201,8 @@ bool ProtocolDecoder::getMessage(DecodedMessage* msg) {
 
 void ProtocolDecoder::reset() {
   state = STATE_WAIT_HEADER_0;
+  buffer = nullptr;
+  ramOverlay.release(OVERLAY_BINARY_RX);
   bufferPos = 0;
   expectedLen = 0;
   expectedPayloadLen = 0;
@@ -1,109 +1,119 @@
 /*
  * Motor Self-Test
  * 
- * Critical bring-up sequence to verify motor wiring
+ * Critical bring-up sequence to verify motor wiring. Written as a
+ * coroutine (core/coroutine.h): each wait yields back to the scheduler
+ * instead of spinning in delay() with wdt_reset() calls.
  */
 
 #include <Arduino.h>
-#include <avr/wdt.h>
 #include "hal/motor_driver.h"
 #include "hal/status_led.h"
+#include "core/coroutine.h"
 #include "config.h"
+#include "self_test.h"
 
 // Forward declarations - defined in main.cpp
 extern MotorDriverTB6612 motorDriver;
 extern StatusLED statusLED;
 
-bool runSelfTest() {
-  Serial.println("\n=== Motor Self-Test ===");
-  
-  // Test 1: Verify STBY pin
-  Serial.println("Test 1: STBY pin verification...");
-  motorDriver.enable();
-  delay(100);
-  
-  // Check if STBY is actually HIGH (would need to read back, but for now just enable)
-  Serial.println("  STBY enabled");
-  
-  // Test 2: Left motor forward
-  Serial.println("Test 2: Left motor forward...");
-  Serial.flush();
-  motorDriver.setLeftMotor(SELF_TEST_MOTOR_PWM);
-  motorDriver.setRightMotor(0);
+#define SELF_TEST_STEP_COUNT 4
+
+// Per step: left / right PWM sign
+static const int8_t STEP_DIR[SELF_TEST_STEP_COUNT][2] PROGMEM = {
+  { 1, 0 },   // Left forward
+  { 0, 1 },   // Right forward
+  { -1, 0 },  // Left backward
+  { 0, -1 },  // Right backward
+};
+
+static Coroutine s_co;
+static uint8_t s_step;
+static bool s_requested;
+
+static void driveStep(uint8_t step) {
+  motorDriver.setLeftMotor((int8_t)pgm_read_byte(&STEP_DIR[step][0]) * SELF_TEST_MOTOR_PWM);
+  motorDriver.setRightMotor((int8_t)pgm_read_byte(&STEP_DIR[step][1]) * SELF_TEST_MOTOR_PWM);
   motorDriver.update();
-  // Reset watchdog during delay
-  for (uint16_t i = 0; i < SELF_TEST_DURATION_MS / 100; i++) {
-    wdt_reset();
-    delay(100);
+}
+
+static void printStepName(uint8_t step) {
+  if (step == 0) {
+    Serial.println(F("Left motor forward..."));
+  } else if (step == 1) {
+    Serial.println(F("Right motor forward..."));
+  } else if (step == 2) {
+    Serial.println(F("Left motor backward..."));
+  } else {
+    Serial.println(F("Right motor backward..."));
   }
-  motorDriver.stop();
-  motorDriver.update();
-  delay(200);
-  Serial.println("  Left forward complete");
-  Serial.flush();
+}
+
+static CoStatus selfTestRun() {
+  CO_BEGIN(s_co);
   
-  // Test 3: Right motor forward
-  Serial.println("Test 3: Right motor forward...");
-  Serial.flush();  // Ensure message is sent
-  motorDriver.setLeftMotor(0);
-  motorDriver.setRightMotor(SELF_TEST_MOTOR_PWM);
-  motorDriver.update();
-  // Reset watchdog during delay to prevent reset
-  for (uint16_t i = 0; i < SELF_TEST_DURATION_MS / 100; i++) {
-    wdt_reset();  // Reset watchdog every 100ms
-    delay(100);
-  }
-  motorDriver.stop();
-  motorDriver.update();
-  delay(200);
-  Serial.println("  Right forward complete");
-  Serial.flush();
+  Serial.println(F("\n=== Motor Self-Test ==="));
   
-  // Test 4: Left motor backward
-  Serial.println("Test 4: Left motor backward...");
-  Serial.flush();
-  motorDriver.setLeftMotor(-SELF_TEST_MOTOR_PWM);
-  motorDriver.setRightMotor(0);
-  motorDriver.update();
-  for (uint16_t i = 0; i < SELF_TEST_DURATION_MS / 100; i++) {
-    wdt_reset();
-    delay(100);
-  }
-  motorDriver.stop();
-  motorDriver.update();
-  delay(200);
-  Serial.println("  Left backward complete");
-  Serial.flush();
+  // Test 1: Verify STBY pin
+  motorDriver.enable();
+  CO_DELAY(s_co, 100);
+  // Check if STBY is actually HIGH (would need to read back, but for now just enable)
+  Serial.println(F("Test 1: STBY enabled"));
   
-  // Test 5: Right motor backward
-  Serial.println("Test 5: Right motor backward...");
-  Serial.flush();
-  motorDriver.setLeftMotor(0);
-  motorDriver.setRightMotor(-SELF_TEST_MOTOR_PWM);
-  motorDriver.update();
-  for (uint16_t i = 0; i < SELF_TEST_DURATION_MS / 100; i++) {
-    wdt_reset();
-    delay(100);
+  // Tests 2-5: one motor, one direction at a time
+  for (s_step = 0; s_step < SELF_TEST_STEP_COUNT; s_step++) {
+    Serial.print(F("Test "));
+    Serial.print(s_step + 2);
+    Serial.print(F(": "));
+    printStepName(s_step);
+    driveStep(s_step);
+    CO_DELAY(s_co, SELF_TEST_DURATION_MS);
+    motorDriver.stop();
+    motorDriver.update();
+    CO_DELAY(s_co, 200);
+    Serial.println(F("  complete"));
   }
-  motorDriver.stop();
-  motorDriver.update();
-  delay(200);
-  Serial.println("  Right backward complete");
-  Serial.flush();
   
   // Visual feedback
   statusLED.setStateIdle();
-  delay(500);
+  CO_DELAY(s_co, 500);
   statusLED.setColor(0, 255, 0);  // Green = success
-  delay(500);
+  CO_DELAY(s_co, 500);
   statusLED.setStateIdle();
   
-  Serial.println("=== Self-Test Complete ===");
-  Serial.println("If motors did not move, check:");
-  Serial.println("  1. STBY pin (pin 3) is HIGH");
-  Serial.println("  2. Motor wiring connections");
-  Serial.println("  3. Battery voltage");
+  Serial.println(F("=== Self-Test Complete ==="));
+  Serial.println(F("If motors did not move, check:"));
+  Serial.println(F("  1. STBY pin (pin 3) is HIGH"));
+  Serial.println(F("  2. Motor wiring connections"));
+  Serial.println(F("  3. Battery voltage"));
   
+  CO_END(s_co);
+}
+
+void selfTestStart() {
+  s_requested = true;
+}
+
+bool selfTestUpdate() {
+  if (!s_requested) {
+    return false;
+  }
+  if (selfTestRun() == CO_DONE) {
+    s_requested = false;
+  }
   return true;
 }
 
+bool selfTestActive() {
+  return s_requested;
+}
+
+void selfTestAbort() {
+  if (!s_requested && !CO_RUNNING(s_co)) {
+    return;
+  }
+  CO_RESET(s_co);
+  s_requested = false;
+  motorDriver.stop();
+  Serial.println(F("=== Self-Test Aborted ==="));
+}
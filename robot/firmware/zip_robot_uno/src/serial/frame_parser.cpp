@@ -2,7 +2,7 @@
  * JSON Frame Parser Implementation
  * 
  * Production-grade parser with:
- * - Ring buffer for robust RX handling
+ * - Frame accumulator borrowed from the RAM overlay arena ('{' .. '}')
  * - JSON termination on '}' (official ELEGOO style)
  * - Binary protocol detection (0xAA 0x55)
  * - Resync on long lines
@@ -15,6 +15,8 @@
  */
 
 #include "frame_parser.h"
+#include "../../include/core/trace.h"
+#include "../../include/core/ram_overlay.h"
 #include <avr/wdt.h>
 #include <stdlib.h>  // for atoi, atol
 
@@ -22,8 +24,7 @@
 ParseStats g_parseStats = {0, 0, 0, 0, 0, 0};
 
 FrameParser::FrameParser()
-  : head(0)
-  , tail(0)
+  : jsonBuffer(nullptr)
   , jsonPos(0)
   , state(STATE_IDLE)
 {
@@ -31,9 +32,7 @@ FrameParser::FrameParser()
 }
 
 void FrameParser::reset() {
-  state = STATE_IDLE;
-  jsonPos = 0;
-  jsonBuffer[0] = '\0';
+  endFrame();
   lastCommand.valid = false;
   lastCommand.N = -1;
   lastCommand.H[0] = '\0';
@@ -42,64 +41,38 @@ void FrameParser::reset() {
   lastCommand.D3 = 0;
   lastCommand.D4 = 0;
   lastCommand.T = 0;
-  // Don't clear ring buffer on reset - may have pending data
 }
 
-// Ring buffer push (returns false if full)
-bool FrameParser::ringPush(uint8_t byte) {
-  uint8_t nextHead = (head + 1) & (RING_SIZE - 1);  // Power of 2 modulo
-  if (nextHead == tail) {
-    // Buffer full - overflow
-    g_parseStats.rx_overflow++;
+// Borrow the arena for a new frame (nullptr = held by another phase)
+bool FrameParser::beginFrame() {
+  RamOverlayStorage* arena = ramOverlay.acquire(OVERLAY_JSON_RX);
+  if (!arena) {
     return false;
   }
-  ring[head] = byte;
-  head = nextHead;
+  jsonBuffer = arena->jsonLine;
+  jsonBuffer[0] = '{';
+  jsonPos = 1;
+  state = STATE_JSON_READING;
   return true;
 }
 
-// Ring buffer pop (returns false if empty)
-bool FrameParser::ringPop(uint8_t& byte) {
-  if (head == tail) {
-    return false;  // Empty
-  }
-  byte = ring[tail];
-  tail = (tail + 1) & (RING_SIZE - 1);
-  return true;
-}
-
-// Ring buffer available count
-uint8_t FrameParser::ringAvailable() const {
-  return (head - tail) & (RING_SIZE - 1);
-}
-
-// Clear ring buffer
-void FrameParser::ringClear() {
-  head = 0;
-  tail = 0;
-}
-
-// Resync: discard bytes until newline or clear buffer
-void FrameParser::resyncToNewline() {
-  uint8_t byte;
-  while (ringPop(byte)) {
-    if (byte == '\n' || byte == '\r') {
-      break;  // Found line terminator, ready for next frame
-    }
-  }
+// Back to idle and hand the arena back
+void FrameParser::endFrame() {
   state = STATE_IDLE;
   jsonPos = 0;
+  jsonBuffer = nullptr;
+  ramOverlay.release(OVERLAY_JSON_RX);
 }
 
 bool FrameParser::processByte(uint8_t byte) {
+  TRACE_SCOPE(TRACE_RX_BYTE);
+  
   // Handle state machine - JSON only (binary protocol removed)
   switch (state) {
     case STATE_IDLE:
       // Look for JSON frame start
       if (byte == '{') {
-        jsonBuffer[0] = '{';
-        jsonPos = 1;
-        state = STATE_JSON_READING;
+        beginFrame();
       }
       // Ignore other characters (whitespace, newlines, binary bytes)
       return false;
@@ -116,8 +89,7 @@ bool FrameParser::processByte(uint8_t byte) {
         } else {
           // Line too long even at terminator
           g_parseStats.json_dropped_long++;
-          state = STATE_IDLE;
-          jsonPos = 0;
+          endFrame();
           return false;
         }
       } else if (byte == '\n' || byte == '\r') {
@@ -130,8 +102,7 @@ bool FrameParser::processByte(uint8_t byte) {
           }
         }
         // Incomplete frame - discard and wait for new frame
-        state = STATE_IDLE;
-        jsonPos = 0;
+        endFrame();
         return false;
       } else if (byte == '{') {
         // New frame start in middle of old frame - discard old and start fresh
@@ -145,8 +116,7 @@ bool FrameParser::processByte(uint8_t byte) {
         } else {
           // Line too long - discard and resync
           g_parseStats.json_dropped_long++;
-          state = STATE_IDLE;
-          jsonPos = 0;
+          endFrame();
           return false;
         }
       }
@@ -154,8 +124,7 @@ bool FrameParser::processByte(uint8_t byte) {
       
     case STATE_JSON_COMPLETE:
       // Should not receive bytes in complete state - reset
-      state = STATE_IDLE;
-      jsonPos = 0;
+      endFrame();
       return false;
   }
   
@@ -216,6 +185,8 @@ static void parseStringAt(const char* p, char* buf, size_t bufLen) {
 }
 
 bool FrameParser::parseJson() {
+  TRACE_SCOPE(TRACE_PARSE_JSON);
+  
   // Reset watchdog before parsing
   wdt_reset();
   
@@ -233,8 +204,7 @@ bool FrameParser::parseJson() {
   const char* nPos = findField(jsonBuffer, "N");
   if (!nPos) {
     g_parseStats.parse_errors++;
-    state = STATE_IDLE;
-    jsonPos = 0;
+    endFrame();
     return false;
   }
   lastCommand.N = parseIntAt(nPos);
@@ -270,8 +240,7 @@ bool FrameParser::parseJson() {
   }
   
   // Reset for next frame
-  state = STATE_IDLE;
-  jsonPos = 0;
+  endFrame();
   
   wdt_reset();
   return lastCommand.valid;
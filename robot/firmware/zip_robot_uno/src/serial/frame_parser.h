@@ -12,6 +12,7 @@
 #define FRAME_PARSER_H
 
 #include <Arduino.h>
+#include "../../include/core/ram_overlay.h"
 
 // Diagnostic counters (shared with main for N=120 stats)
 struct ParseStats {
@@ -51,9 +52,7 @@ public:
   void reset();
   
 private:
-  // Ring buffer for RX data (minimal for RAM-constrained UNO)
-  static const size_t RING_SIZE = 32;  // Power of 2 for efficient modulo
-  static const size_t MAX_JSON_LINE = 64;  // Max JSON line length
+  static const size_t MAX_JSON_LINE = OVERLAY_JSON_LINE_MAX;  // Max JSON line length
   
   enum State {
     STATE_IDLE,          // Waiting for start character '{'
@@ -61,27 +60,18 @@ private:
     STATE_JSON_COMPLETE  // JSON frame complete, ready to parse
   };
   
-  // Ring buffer (kept for potential future use, but not actively used)
-  uint8_t ring[RING_SIZE];
-  volatile uint8_t head;  // Write position
-  volatile uint8_t tail;  // Read position
-  
-  // JSON frame accumulator
-  char jsonBuffer[MAX_JSON_LINE + 1];
+  // JSON frame accumulator - RAM overlay arena, only while a frame is open
+  char* jsonBuffer;
   size_t jsonPos;
   
   State state;
   ParsedCommand lastCommand;
   
-  // Ring buffer helpers
-  bool ringPush(uint8_t byte);
-  bool ringPop(uint8_t& byte);
-  uint8_t ringAvailable() const;
-  void ringClear();
+  bool beginFrame();
+  void endFrame();
   
   // JSON parsing (uses lightweight fixed-field scanner)
   bool parseJson();
-  void resyncToNewline();
 };
 
 #endif // FRAME_PARSER_H
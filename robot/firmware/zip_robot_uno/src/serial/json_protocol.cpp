@@ -8,11 +8,12 @@
  */
 
 #include "json_protocol.h"
+#include "response_writer.h"
 #include <avr/wdt.h>
 #include <string.h>
 
 // Static members
-char JsonProtocol::pendingResponse[32] = {0};
+char JsonProtocol::pendingTag[sizeof(ParsedCommand::H)] = {0};
 bool JsonProtocol::hasPending = false;
 
 // Helper: Safe Serial write with watchdog protection
@@ -52,32 +53,28 @@ static bool canWrite(size_t len) {
 }
 
 void JsonProtocol::sendOk(const char* H) {
-  char buffer[32];
-  if (H && strlen(H) > 0) {
-    snprintf(buffer, sizeof(buffer), "{%s_ok}\n", H);
+  if (H && H[0] != '\0') {
+    ResponseWriter().begin(H).str(F("ok")).end();
   } else {
-    snprintf(buffer, sizeof(buffer), "{ok}\n");
+    writeSerialSafe("{ok}\n");
   }
-  writeSerialSafe(buffer);
   Serial.flush();  // Ensure response is sent immediately
 }
 
 void JsonProtocol::sendFalse(const char* H) {
-  char buffer[32];
-  snprintf(buffer, sizeof(buffer), "{%s_false}\n", H);
-  writeSerialSafe(buffer);
+  ResponseWriter().begin(H).str(F("false")).end();
 }
 
 void JsonProtocol::sendTrue(const char* H) {
-  char buffer[32];
-  snprintf(buffer, sizeof(buffer), "{%s_true}\n", H);
-  writeSerialSafe(buffer);
+  ResponseWriter().begin(H).str(F("true")).end();
 }
 
 void JsonProtocol::sendValue(const char* H, const char* value) {
-  char buffer[48];
-  snprintf(buffer, sizeof(buffer), "{%s_%s}\n", H, value);
-  writeSerialSafe(buffer);
+  ResponseWriter().begin(H).str(value).end();
+}
+
+void JsonProtocol::sendNumber(const char* H, int32_t value) {
+  ResponseWriter().begin(H).num(value).end();
 }
 
 void JsonProtocol::sendOk() {
@@ -90,47 +87,42 @@ void JsonProtocol::sendHelloOk() {
 }
 
 void JsonProtocol::sendStats(const ParseStats& stats) {
-  // Format: {stats:rx_ov=X,json_drop=X,parse_err=X,crc_fail=X,tx_drop=X,last_ms=X}
+  // Format: {stats:rx=X,jd=X,pe=X,tx=X,ms=X}
   // Keep it compact to fit in TX buffer
-  char buffer[80];
   
   // Calculate ms since last command
   uint32_t now = millis();
   uint32_t ms_ago = (stats.last_cmd_ms > 0) ? (now - stats.last_cmd_ms) : 0;
   
-  snprintf(buffer, sizeof(buffer), 
-    "{stats:rx=%u,jd=%u,pe=%u,tx=%u,ms=%lu}\n",
-    stats.rx_overflow,
-    stats.json_dropped_long,
-    stats.parse_errors,
-    stats.tx_dropped,
-    ms_ago
-  );
-  
-  writeSerialSafe(buffer);
+  ResponseWriter w;
+  w.str(F("{stats:rx=")).num(stats.rx_overflow);
+  w.str(F(",jd=")).num(stats.json_dropped_long);
+  w.str(F(",pe=")).num(stats.parse_errors);
+  w.str(F(",tx=")).num(stats.tx_dropped);
+  w.str(F(",ms=")).num(ms_ago);
+  w.end();
 }
 
 bool JsonProtocol::trySendOk(const char* H) {
-  char buffer[32];
-  snprintf(buffer, sizeof(buffer), "{%s_ok}\n", H);
-  
-  size_t len = strlen(buffer);
+  // {H_ok}\n
+  size_t len = strlen(H) + 5;
   
   // First try to flush any pending response
   flushPending();
   
   // Check if we can write
   if (canWrite(len)) {
-    writeSerialSafe(buffer);
+    ResponseWriter().begin(H).str(F("ok")).end();
     return true;
   }
   
-  // Buffer full - store as pending (overwrites any existing pending)
+  // Buffer full - store as pending (overwrites any existing pending).
+  // Only the tag is kept; the reply is rebuilt on flush.
   if (hasPending) {
     g_parseStats.tx_dropped++;  // Previous pending was dropped
   }
-  strncpy(pendingResponse, buffer, sizeof(pendingResponse) - 1);
-  pendingResponse[sizeof(pendingResponse) - 1] = '\0';
+  strncpy(pendingTag, H, sizeof(pendingTag) - 1);
+  pendingTag[sizeof(pendingTag) - 1] = '\0';
   hasPending = true;
   
   return true;  // Queued (may be sent later)
@@ -141,9 +133,8 @@ void JsonProtocol::flushPending() {
     return;
   }
   
-  size_t len = strlen(pendingResponse);
-  if (canWrite(len)) {
-    writeSerialSafe(pendingResponse);
+  if (canWrite(strlen(pendingTag) + 5)) {
+    ResponseWriter().begin(pendingTag).str(F("ok")).end();
     hasPending = false;
   }
   // If still can't write, leave pending for next flush
@@ -5,6 +5,7 @@
  * Non-blocking serial output with watchdog protection.
  * 
  * Response format matches official ELEGOO: {H_ok}, {H_false}, etc.
+ * Replies stream through ResponseWriter (no snprintf, no stack buffers).
  */
 
 #ifndef JSON_PROTOCOL_H
@@ -21,6 +22,7 @@ public:
   static void sendFalse(const char* H);
   static void sendTrue(const char* H);
   static void sendValue(const char* H, const char* value);
+  static void sendNumber(const char* H, int32_t value);  // {H_<value>}
   static void sendOk();  // Generic {ok}
   
   // Hello response (N=0 handshake)
@@ -38,8 +40,8 @@ public:
   static void flushPending();
   
 private:
-  // Pending response storage (single slot)
-  static char pendingResponse[32];
+  // Pending response storage (single slot): the {H_ok} tag only
+  static char pendingTag[sizeof(ParsedCommand::H)];
   static bool hasPending;
 };
 
@@ -0,0 +1,103 @@
+/*
+ * Response Writer Implementation
+ */
+
+#include "response_writer.h"
+#include "frame_parser.h"  // g_parseStats
+#include <avr/pgmspace.h>
+#include <avr/wdt.h>
+
+ResponseWriter& ResponseWriter::begin(const char* H) {
+  wdt_reset();
+  put('{');
+  str(H);
+  put('_');
+  return *this;
+}
+
+ResponseWriter& ResponseWriter::str(const char* s) {
+  if (s) {
+    while (*s) {
+      put(*s++);
+    }
+  }
+  return *this;
+}
+
+ResponseWriter& ResponseWriter::str(const __FlashStringHelper* s) {
+  PGM_P p = reinterpret_cast<PGM_P>(s);
+  char c;
+  while ((c = (char)pgm_read_byte(p++)) != '\0') {
+    put(c);
+  }
+  return *this;
+}
+
+ResponseWriter& ResponseWriter::num(uint16_t v) {
+  // 16-bit divide is several times cheaper than 32-bit on AVR
+  char digits[5];
+  uint8_t len = 0;
+  do {
+    digits[len++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  putDigits(digits, len);
+  return *this;
+}
+
+ResponseWriter& ResponseWriter::num(int16_t v) {
+  if (v < 0) {
+    put('-');
+    return num((uint16_t)(-(int32_t)v));
+  }
+  return num((uint16_t)v);
+}
+
+ResponseWriter& ResponseWriter::num(uint32_t v) {
+  if (v <= 0xFFFF) {
+    return num((uint16_t)v);
+  }
+  char digits[10];
+  uint8_t len = 0;
+  do {
+    digits[len++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  putDigits(digits, len);
+  return *this;
+}
+
+ResponseWriter& ResponseWriter::num(int32_t v) {
+  if (v < 0) {
+    put('-');
+    return num((uint32_t)0 - (uint32_t)v);
+  }
+  return num((uint32_t)v);
+}
+
+bool ResponseWriter::end() {
+  put('}');
+  put('\n');
+  if (dropped) {
+    g_parseStats.tx_dropped++;
+  }
+  return !dropped;
+}
+
+void ResponseWriter::put(char c) {
+  if (dropped) {
+    return;
+  }
+  if (out.availableForWrite() <= 0) {
+    dropped = true;  // Never block the scheduler on a full TX ring
+    return;
+  }
+  out.write((uint8_t)c);
+}
+
+void ResponseWriter::putDigits(const char* digits, uint8_t len) {
+  // Digits were produced least significant first
+  while (len) {
+    put(digits[--len]);
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ * Response Writer
+ * 
+ * Streams a reply straight into the serial TX ring: constant fragments come
+ * from flash (F("...")), numbers go through a hand-rolled utoa, and nothing
+ * is assembled in a stack buffer first. Replaces snprintf, which pulled
+ * vfprintf into flash and put a 32-80 byte buffer on the stack of every
+ * handler that replied.
+ * 
+ * Same non-blocking policy as writeSerialSafe: once the TX ring is full the
+ * rest of the reply is dropped and counted in g_parseStats.tx_dropped.
+ * 
+ *   ResponseWriter().begin(cmd.H).num(distance).end();   // {H_123}\n
+ */
+
+#ifndef RESPONSE_WRITER_H
+#define RESPONSE_WRITER_H
+
+#include <Arduino.h>
+
+class ResponseWriter {
+public:
+  explicit ResponseWriter(Print& out = Serial) : out(out), dropped(false) {}
+  
+  // "{<H>_" - the ELEGOO reply prefix
+  ResponseWriter& begin(const char* H);
+  
+  ResponseWriter& ch(char c) { put(c); return *this; }
+  ResponseWriter& str(const char* s);
+  ResponseWriter& str(const __FlashStringHelper* s);
+  
+  // Decimal, no padding. int16_t/uint16_t stay on 16-bit division.
+  ResponseWriter& num(uint16_t v);
+  ResponseWriter& num(int16_t v);
+  ResponseWriter& num(uint32_t v);
+  ResponseWriter& num(int32_t v);
+  
+  // "}\n". Returns false if any part of the reply was dropped.
+  bool end();
+  
+private:
+  Print& out;
+  bool dropped;
+  
+  void put(char c);
+  void putDigits(const char* digits, uint8_t len);
+};
+
+#endif // RESPONSE_WRITER_H
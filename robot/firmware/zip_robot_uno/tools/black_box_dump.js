@@ -0,0 +1,173 @@
+#!/usr/bin/env node
+
+/**
+ * Black Box Dump Tool
+ *
+ * Reads the UNO flight recorder (N=125) and prints one row per record.
+ * Opening the port resets the UNO; a frozen ring survives that reset.
+ *
+ * Usage:
+ *   node black_box_dump.js <PORT> [--rearm] [--csv]
+ *
+ *   --rearm   Clear the ring and record again after a successful dump
+ *   --csv     Print CSV instead of a table
+ *
+ * Example:
+ *   node black_box_dump.js COM5 --rearm
+ */
+
+const { SerialPort } = require('serialport');
+
+// Configuration
+const BAUD_RATE = 115200;
+const BOOT_TIMEOUT_MS = 4000;   // Wait for the "R" ready marker
+const DUMP_TIMEOUT_MS = 2000;
+const RECORD_SIZE = 8;
+
+const MOTION_STATES = ['IDLE', 'SETPOINT', 'MACRO', 'DIRECT'];
+const BATTERY_STATES = ['OK', 'LOW', 'CRIT', '?'];
+
+// Parse command line
+const port = process.argv[2];
+const rearm = process.argv.includes('--rearm');
+const csv = process.argv.includes('--csv');
+
+if (!port) {
+  console.error('Usage: node black_box_dump.js <PORT> [--rearm] [--csv]');
+  process.exit(1);
+}
+
+const serial = new SerialPort({ path: port, baudRate: BAUD_RATE, autoOpen: false });
+
+let rx = Buffer.alloc(0);
+serial.on('data', (chunk) => {
+  rx = Buffer.concat([rx, chunk]);
+});
+
+function sleep(ms) {
+  return new Promise(resolve => setTimeout(resolve, ms));
+}
+
+// Resolve once check(rx) returns a value, or reject after timeoutMs
+async function waitFor(check, timeoutMs, what) {
+  const deadline = Date.now() + timeoutMs;
+  while (Date.now() < deadline) {
+    const result = check(rx);
+    if (result !== null) {
+      return result;
+    }
+    await sleep(10);
+  }
+  throw new Error(`Timeout waiting for ${what}`);
+}
+
+// Header: {bb_bb:<count>,<boots>,<cause>,<lastMs>,<frozen>}\n + records + \n
+function parseDump(buf) {
+  const text = buf.toString('latin1');
+  const match = text.match(/\{bb_bb:(\d+),(\d+),(\d+),(\d+),(\d+)\}\n/);
+  if (!match) {
+    return null;
+  }
+  const count = Number(match[1]);
+  const start = match.index + match[0].length;
+  if (buf.length < start + count * RECORD_SIZE) {
+    return null;
+  }
+  return {
+    count,
+    boots: Number(match[2]),
+    cause: Number(match[3]),
+    lastMs: Number(match[4]),
+    frozen: match[5] === '1',
+    data: buf.subarray(start, start + count * RECORD_SIZE),
+  };
+}
+
+function decodeRecord(data, offset) {
+  const state = data.readUInt8(offset + 6);
+  return {
+    v: data.readInt8(offset) * 2,
+    w: data.readInt8(offset + 1) * 2,
+    pwmL: data.readInt8(offset + 2) * 2,
+    pwmR: data.readInt8(offset + 3) * 2,
+    battMv: data.readUInt8(offset + 4) * 40,
+    yawDeg: Number((data.readInt8(offset + 5) * 180 / 128).toFixed(1)),
+    motion: MOTION_STATES[state & 0x03],
+    battery: BATTERY_STATES[(state >> 2) & 0x03],
+    init: (state & 0x10) !== 0,
+    dtMs: data.readUInt8(offset + 7),
+  };
+}
+
+function describeCause(cause) {
+  const flags = [];
+  if (cause & 0x01) flags.push('power-on');
+  if (cause & 0x02) flags.push('external');
+  if (cause & 0x04) flags.push('brownout');
+  if (cause & 0x08) flags.push('watchdog');
+  return flags.length ? flags.join('+') : 'unknown';
+}
+
+async function main() {
+  await new Promise((resolve, reject) => {
+    serial.open(err => (err ? reject(err) : resolve()));
+  });
+
+  // DTR reset -> wait for the ready marker
+  await waitFor(buf => (buf.includes('R\n') ? true : null), BOOT_TIMEOUT_MS, 'ready marker')
+    .catch(() => console.warn('No ready marker - continuing'));
+  await sleep(200);
+  rx = Buffer.alloc(0);
+
+  serial.write('{"N":125,"H":"bb"}\n');
+  const dump = await waitFor(parseDump, DUMP_TIMEOUT_MS, 'black box dump');
+
+  // Records are oldest first; time them back from the newest (lastMs)
+  const records = [];
+  for (let i = 0; i < dump.count; i++) {
+    records.push(decodeRecord(dump.data, i * RECORD_SIZE));
+  }
+  let t = dump.lastMs;
+  for (let i = records.length - 1; i >= 0; i--) {
+    records[i].tMs = t;
+    t -= records[i].dtMs;
+  }
+
+  if (csv) {
+    console.log('t_ms,dt_ms,v,w,pwm_l,pwm_r,batt_mv,yaw_deg,motion,battery,init');
+    for (const r of records) {
+      console.log([r.tMs, r.dtMs, r.v, r.w, r.pwmL, r.pwmR, r.battMv, r.yawDeg,
+        r.motion, r.battery, r.init ? 1 : 0].join(','));
+    }
+  } else {
+    console.log(`Records: ${dump.count}  Frozen: ${dump.frozen ? 'yes' : 'no'}  ` +
+      `Boots since: ${dump.boots}  Cause: ${describeCause(dump.cause)} (${dump.cause})  ` +
+      `Last record: ${dump.lastMs}ms uptime`);
+    console.log('');
+    console.log('   t_ms   dt     v    w  pwmL pwmR  batt   yaw  motion    batt init');
+    for (const r of records) {
+      console.log(
+        `${String(r.tMs).padStart(7)} ${String(r.dtMs).padStart(4)}` +
+        ` ${String(r.v).padStart(5)} ${String(r.w).padStart(4)}` +
+        ` ${String(r.pwmL).padStart(5)} ${String(r.pwmR).padStart(4)}` +
+        ` ${String(r.battMv).padStart(5)} ${String(r.yawDeg).padStart(5)}` +
+        `  ${r.motion.padEnd(8)}  ${r.battery.padEnd(4)} ${r.init ? 'yes' : ''}` +
+        (r.dtMs === 255 ? '  <- stall' : ''));
+    }
+  }
+
+  if (rearm) {
+    await sleep(600);  // N=125 is rate limited to 2 Hz
+    rx = Buffer.alloc(0);
+    serial.write('{"N":125,"H":"bb","D1":1}\n');
+    await waitFor(buf => (buf.includes('{bb_ok}') ? true : null), DUMP_TIMEOUT_MS, 're-arm ack');
+    console.log('\nRing cleared, recording');
+  }
+
+  serial.close();
+}
+
+main().catch(err => {
+  console.error(`Error: ${err.message}`);
+  serial.close(() => process.exit(1));
+});
@@ -294,7 +294,7 @@ async function runCalibration() {
     await sleep(300);
     
     // Show recent responses
-    const recentResponses = allResponses.slice(-5);
+    const recentResponses = allResponses.slice(-9);  // N=120 is nine lines
     console.log('\nRecent responses:');
     recentResponses.forEach(r => console.log(`  ${r.line}`));
     
@@ -148,14 +148,14 @@ function handleResponse(line) {
 
 // Parse and display stats
 function parseStats(line) {
-  // Format: {stats:rx=0,jd=0,pe=0,bc=0,tx=0,ms=123}
-  const match = line.match(/\{stats:rx=(\d+),jd=(\d+),pe=(\d+),bc=(\d+),tx=(\d+),ms=(\d+)\}/);
+  // Format: {stats:rx=0,jd=0,pe=0[,bc=0],tx=0,ms=123} (current firmware has no bc)
+  const match = line.match(/\{stats:rx=(\d+),jd=(\d+),pe=(\d+)(?:,bc=(\d+))?,tx=(\d+),ms=(\d+)\}/);
   if (match) {
     console.log('\n=== Diagnostic Stats ===');
     console.log(`RX overflow:        ${match[1]}`);
     console.log(`JSON dropped long:  ${match[2]}`);
     console.log(`Parse errors:       ${match[3]}`);
-    console.log(`Binary CRC fail:    ${match[4]}`);
+    console.log(`Binary CRC fail:    ${match[4] ?? 'n/a'}`);
     console.log(`TX dropped:         ${match[5]}`);
     console.log(`Last cmd ms ago:    ${match[6]}`);
     console.log('========================\n');